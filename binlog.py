@@ -0,0 +1,186 @@
+# Converts binary logs written by the mod (the "Binary Logs" dev setting) to text
+# Usage: python3 binlog.py <binlog-xxx.bin> [--thread NAME] [--filter TEXT]
+
+from datetime import datetime
+from pathlib import Path
+import string
+import struct
+import sys
+
+MAGIC = b"GBINLOG1"
+
+TAG_I64 = 1
+TAG_U64 = 2
+TAG_F64 = 3
+TAG_BOOL = 4
+TAG_STR = 5
+TAG_POINT = 6
+TAG_I32_ARRAY = 7
+TAG_DURATION = 8
+
+class Point:
+    def __init__(self, x: float, y: float):
+        self.x = x
+        self.y = y
+
+    def __format__(self, spec: str) -> str:
+        return f"{format(self.x, spec)}, {format(self.y, spec)}"
+
+class Duration:
+    def __init__(self, nanos: int):
+        self.nanos = nanos
+
+    def __format__(self, spec: str) -> str:
+        if self.nanos >= 1_000_000_000:
+            return f"{self.nanos / 1e9:.3f}s"
+        elif self.nanos >= 1_000_000:
+            return f"{self.nanos / 1e6:.3f}ms"
+        elif self.nanos >= 1_000:
+            return f"{self.nanos / 1e3:.3f}us"
+        return f"{self.nanos}ns"
+
+class Formatter(string.Formatter):
+    # fmt and python format specs are mostly compatible, except python refuses precision for integers
+    def format_field(self, value, spec):
+        if isinstance(value, bool):
+            return format("true" if value else "false", spec)
+
+        try:
+            return super().format_field(value, spec)
+        except ValueError:
+            if isinstance(value, int):
+                return super().format_field(float(value), spec)
+            return str(value)
+
+class Reader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def eof(self) -> bool:
+        return self.pos >= len(self.data)
+
+    def read(self, fmt: str):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise EOFError()
+
+        vals = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return vals[0] if len(vals) == 1 else vals
+
+    def read_bytes(self, n: int) -> bytes:
+        if self.pos + n > len(self.data):
+            raise EOFError()
+
+        out = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return out
+
+    def read_string(self) -> str:
+        return self.read_bytes(self.read("<H")).decode("utf-8", errors="replace")
+
+def read_arg(r: Reader):
+    tag = r.read("<B")
+
+    if tag == TAG_I64:
+        return r.read("<q")
+    elif tag == TAG_U64:
+        return r.read("<Q")
+    elif tag == TAG_F64:
+        return r.read("<d")
+    elif tag == TAG_BOOL:
+        return r.read("<Q") != 0
+    elif tag == TAG_STR:
+        return r.read_string()
+    elif tag == TAG_POINT:
+        return Point(*r.read("<ff"))
+    elif tag == TAG_I32_ARRAY:
+        n = r.read("<H")
+        return list(r.read(f"<{n}i")) if n else []
+    elif tag == TAG_DURATION:
+        return Duration(r.read("<Q"))
+
+    raise ValueError(f"unknown argument tag {tag}")
+
+def format_event(formatter: Formatter, fmt: str | None, fmt_id: int, args: list) -> str:
+    if fmt is None:
+        return f"<unknown format {fmt_id}> {args}"
+
+    try:
+        return formatter.format(fmt, *args)
+    except (IndexError, KeyError, ValueError) as e:
+        return f"<bad format '{fmt}': {e}> {args}"
+
+def main():
+    args = sys.argv[1:]
+    if not args:
+        print(f"Usage: {sys.argv[0]} <file> [--thread NAME] [--filter TEXT]")
+        sys.exit(1)
+
+    path = Path(args[0])
+    thread_filter = None
+    text_filter = None
+
+    i = 1
+    while i < len(args):
+        if args[i] == "--thread" and i + 1 < len(args):
+            thread_filter = args[i + 1]
+            i += 2
+        elif args[i] == "--filter" and i + 1 < len(args):
+            text_filter = args[i + 1]
+            i += 2
+        else:
+            print(f"Unknown argument: {args[i]}")
+            sys.exit(1)
+
+    r = Reader(path.read_bytes())
+    if r.read_bytes(len(MAGIC)) != MAGIC:
+        print(f"{path} is not a binary log file")
+        sys.exit(1)
+
+    epoch_ns = r.read("<Q")
+    formats: dict[int, str] = {}
+    threads: dict[int, str] = {}
+    formatter = Formatter()
+
+    try:
+        while not r.eof():
+            kind = r.read_bytes(1)
+
+            if kind == b"F":
+                fmt_id = r.read("<I")
+                formats[fmt_id] = r.read_string()
+            elif kind == b"T":
+                tid = r.read("<I")
+                threads[tid] = r.read_string() or f"Thread {tid}"
+            elif kind == b"D":
+                tid, dropped = r.read("<IQ")
+                print(f"!! {dropped} records dropped on thread {threads.get(tid, tid)}, the ring buffer was full")
+            elif kind == b"E":
+                tid, size = r.read("<II")
+                chunk = Reader(r.read_bytes(size))
+                thread = threads.get(tid, f"Thread {tid}")
+
+                while not chunk.eof():
+                    rec_size, fmt_id, ts, argc = chunk.read("<HIQB")
+                    rec = Reader(chunk.read_bytes(rec_size - 15))
+                    ev_args = [read_arg(rec) for _ in range(argc)]
+
+                    if thread_filter and thread_filter not in thread:
+                        continue
+
+                    msg = format_event(formatter, formats.get(fmt_id), fmt_id, ev_args)
+                    if text_filter and text_filter not in msg:
+                        continue
+
+                    time = datetime.fromtimestamp((epoch_ns + ts) / 1e9).strftime("%H:%M:%S.%f")
+                    print(f"{time} [{thread}] {msg}")
+            else:
+                print(f"!! Unknown chunk type {kind!r} at offset {r.pos - 1}, stopping")
+                break
+    except EOFError:
+        print("!! Log file is truncated")
+
+if __name__ == "__main__":
+    main()
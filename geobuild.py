@@ -35,6 +35,9 @@ class GlobedConfig:
     debug: bool = False
     release: bool = False
     asan: bool = False
+    alloc_audit: bool = False
+    alloc_audit_threshold: int = 0
+    benchmarks: bool = False
     oss: bool = False
     voice: bool = True
     ext_transports: bool = True
@@ -71,6 +74,9 @@ class GlobedConfig:
             out.release = get_or(build, "release", out.release)
             out.oss = get_or(build, "oss", out.oss)
             out.asan = get_or(build, "asan", out.asan)
+            out.alloc_audit = get_or(build, "alloc_audit", out.alloc_audit)
+            out.alloc_audit_threshold = get_or(build, "alloc_audit_threshold", out.alloc_audit_threshold)
+            out.benchmarks = get_or(build, "benchmarks", out.debug) # enabled by default in debug
             out.voice = get_or(build, "voice", out.voice)
             out.ext_transports = get_or(build, "ext_transports", out.ext_transports)
             out.advanced_dns = get_or(build, "advanced_dns", out.advanced_dns)
@@ -363,6 +369,15 @@ def main(build: Build):
         "-Wno-vla-cxx-extension"
     )
 
+    # counts heap allocations made inside of profiler zones, never enable this in release builds
+    if gc.alloc_audit and not gc.release:
+        build.add_definition("GLOBED_ALLOC_AUDIT", "1")
+        build.add_definition("GLOBED_ALLOC_AUDIT_THRESHOLD", str(gc.alloc_audit_threshold))
+
+    # developer benchmarks, can also be enabled with -DGLOBED_BENCHMARKS=ON so that CI can build them without a config.toml
+    if (gc.benchmarks or config.bool_var("GLOBED_BENCHMARKS")) and not gc.release:
+        build.add_definition("GLOBED_BENCHMARKS", "1")
+
     if gc.voice:
         build.add_definition("GLOBED_VOICE_SUPPORT", "1")
         if config.platform.is_windows():
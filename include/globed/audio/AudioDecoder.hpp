@@ -30,6 +30,22 @@ public:
     [[nodiscard]] Result<DecodedOpusData> decode(const uint8_t* data, size_t length);
     [[nodiscard]] Result<DecodedOpusData> decode(const EncodedOpusData& frame);
 
+    // Decodes the given Opus data into `out`, which must have room for at least one frame (`frameSize * channels` samples).
+    // Does not allocate, returns the amount of samples written.
+    [[nodiscard]] Result<size_t> decodeInto(const uint8_t* data, size_t length, float* out, size_t outSamples);
+    [[nodiscard]] Result<size_t> decodeInto(const EncodedOpusData& frame, float* out, size_t outSamples);
+
+    // Recovers a lost frame from the forward error correction data in the frame that follows it.
+    // Falls back to concealment if that frame has no FEC data. Same buffer rules as `decodeInto`.
+    [[nodiscard]] Result<size_t> recoverInto(const EncodedOpusData& nextFrame, float* out, size_t outSamples);
+
+    // Generates a replacement for a lost frame from the previous decoded audio (packet loss concealment).
+    [[nodiscard]] Result<size_t> concealInto(float* out, size_t outSamples);
+
+    // the maximum amount of samples in one decoded frame. frames can be shorter than this (the sender picks the duration),
+    // the decode functions return how many samples were actually written
+    size_t frameSamples() const;
+
     // sets the sample rate that will be used and recreates the decoder
     Result<> setSampleRate(int sampleRate);
     // sets the frame size of the data that will be used
@@ -2,6 +2,7 @@
 
 #include "../prelude.hpp"
 #include <memory>
+#include <optional>
 
 struct OpusEncoder;
 
@@ -10,8 +11,24 @@ namespace globed {
 struct EncodedOpusData {
     std::shared_ptr<uint8_t[]> data;
     size_t size;
+
+    // Sequence number stored by the sender in the padding of the opus packet. Only the first frame of a voice packet carries one,
+    // use `EncodedAudioFrame::firstSequence` to get the sequence numbers of a whole packet.
+    // Decoders ignore padding, so these packets still play fine on clients that don't read it.
+    // Returns nullopt for frames without one.
+    std::optional<uint32_t> sequence() const;
+
+    // Returns a copy of this frame with the given sequence number stored in its padding
+    Result<EncodedOpusData> withSequence(uint32_t seq) const;
+
+    // Amount of samples (per channel) this packet decodes to at the given sample rate, read from the packet header.
+    // Senders can pick different frame durations, so this can differ between packets. Returns 0 for invalid packets.
+    size_t samples(int sampleRate) const;
 };
 
+// sequence numbers are 24 bits wide and wrap around, use this to compare them
+int32_t voiceSequenceDiff(uint32_t a, uint32_t b);
+
 class GLOBED_DLL AudioEncoder {
 public:
     AudioEncoder(int sampleRate = 0, int frameSize = 0, int channels = 1);
@@ -26,37 +43,54 @@ public:
 
     // Encode the given PCM samples with Opus. The amount of samples passed must be equal to `frameSize` passed in the constructor.
     [[nodiscard]] Result<EncodedOpusData> encode(const float* data);
+    // sequence number of the last frame returned by `encode`. every encoded frame gets the next one, even if it isn't sent
+    uint32_t lastSequence() const;
 
     // sets the sample rate that will be used and recreates the encoder
     Result<> setSampleRate(int sampleRate);
-    // sets the frame size of the data that will be used
+    // sets the frame size of the data that will be used. must be a valid opus frame duration (2.5 to 60ms),
+    // can be changed between frames without recreating the encoder
     void setFrameSize(int frameSize);
+    int frameSize() const;
     // sets the amount of channels that will be used and recreates the encoder
     Result<> setChannels(int channels);
 
+    // sets the bitrate for the encoder
+    Result<> setBitrate(int bitrate);
+
+    // sets the encoder complexity (0-10)
+    Result<> setComplexity(int complexity);
+
+    // sets whether to use VBR or CBR (if false)
+    Result<> setVariableBitrate(bool variablebr = true);
+
+    // enables opus in-band forward error correction, tuned for the given expected packet loss (0-100).
+    // this lets the receiver recover a lost frame from the frame after it. enabled by default with 10% loss.
+    Result<> setInbandFec(bool enabled, int lossPercent);
+
+    // enables opus discontinuous transmission. during silence the encoder then only produces tiny frames,
+    // which don't need to be sent (see `lastFrameDtx`), and an occasional comfort noise update.
+    Result<> setDtx(bool enabled);
+    // whether the last encoded frame was a silent DTX frame that doesn't need to be sent
+    bool lastFrameDtx() const;
+
 private:
     // EXPERIMENTAL ZONE
     //
-    // those functions are here for completeness sake, right now they are NOT used anywhere.
+    // this function is here for completeness sake, right now it is NOT used anywhere.
     // in future they may be configurable by the end user, in which case verify that the user cannot screw things up
     // and remove the `private:` specifier and this comment.
 
     // resets the internal state of the encoder
     Result<> resetState();
 
-    // sets the bitrate for the encoder
-    Result<> setBitrate(int bitrate);
-
-    // sets the encoder complexity (1-10)
-    Result<> setComplexity(int complexity);
-
-    // sets whether to use VBR or CBR (if false)
-    Result<> setVariableBitrate(bool variablebr = true);
-
 protected:
     OpusEncoder* m_encoder = nullptr;
 
     int m_sampleRate, m_frameSize, m_channels;
+    uint32_t m_nextSequence = 0;
+    uint32_t m_lastSequence = 0;
+    bool m_lastDtx = false;
 
     Result<> remakeEncoder();
     static std::string_view errorToString(int code);
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "EncodedAudioFrame.hpp"
-#include "AudioSampleQueue.hpp"
+#include "AudioRingBuffer.hpp"
+#include "VoiceActivityDetector.hpp"
+#include "VoiceMixer.hpp"
+#include "VoiceQualityController.hpp"
 #include "sound/AudioSource.hpp"
 #include "../prelude.hpp"
 
 #include <Geode/utils/async.hpp>
 #include <arc/sync/mpsc.hpp>
 #include <asp/sync.hpp>
+#include <asp/time/Instant.hpp>
 #include <fmod.hpp>
 #include <variant>
 
@@ -15,7 +19,7 @@ namespace globed {
 
 constexpr size_t VOICE_TARGET_SAMPLERATE = 24000;
 constexpr float VOICE_CHUNK_RECORD_TIME = 0.06f; // the audio buffer that is recorded at once (60ms)
-constexpr size_t VOICE_TARGET_FRAMESIZE = VOICE_TARGET_SAMPLERATE * VOICE_CHUNK_RECORD_TIME; // opus framesize
+constexpr size_t VOICE_TARGET_FRAMESIZE = VOICE_TARGET_SAMPLERATE * VOICE_CHUNK_RECORD_TIME; // opus framesize, also the longest frame that can be received
 constexpr size_t VOICE_CHANNELS = 1;
 
 // how many units before the audio disappears
@@ -77,6 +81,20 @@ public:
     // set the amount of record frames in a buffer (used by the lowerAudioLatency setting)
     void setRecordBufferCapacity(size_t frames);
 
+    // set the duration of recorded opus frames in milliseconds (10, 20, 40 or 60), takes effect when recording starts.
+    // anything below 60ms is low latency mode, where every frame is sent as soon as it's encoded, regardless of the buffer capacity.
+    void setRecordFrameDuration(int ms);
+
+    // enable voice activation, so that recorded frames without speech are not sent (and opus dtx), takes effect when recording starts.
+    // attack is how long speech must last before frames are sent, hangover is how long they keep being sent after it stops.
+    void setVoiceActivation(bool enabled, int attackMs, int hangoverMs);
+
+    // set the bitrate, complexity and fec tuning of the voice encoder, applied before the next frame is encoded
+    void setEncoderSettings(const VoiceEncoderSettings& settings);
+    // returns the share of time spent encoding compared to the duration of the audio encoded since the last call,
+    // or 0 if too little was recorded since then to tell. only call from one place (the main thread).
+    float sampleEncoderLoad();
+
     /// start recording the voice and call either the raw callback with pcm data,
     /// or the encoded callback with opus data. only one must be provided.
     void startRecording(AudioRecordConfig config);
@@ -99,6 +117,8 @@ public:
     void updatePlayback(CCPoint playerPos, bool voiceProximity);
     void updatePlayback();
     void registerPlaybackSource(std::shared_ptr<AudioSource> source);
+    // returns the mixer that new voice streams should be played through, or nullptr if they should get their own fmod channels
+    VoiceMixer* getVoiceMixer();
 
     void setDeafen(bool deafen);
     bool getDeafen();
@@ -146,9 +166,34 @@ private:
     uint32_t m_recordLastPosition = 0;
     geode::Function<void(const EncodedAudioFrame&)> m_callback;
     geode::Function<void(const float*, size_t)> m_rawCallback;
-    AudioSampleQueue m_recordQueue;
+    AudioRingBuffer m_recordQueue{65536}; // recorded samples that weren't encoded yet
     EncodedAudioFrame m_recordFrame;
     AudioEncoder m_encoder;
+    std::atomic<int> m_recordFrameMs = static_cast<int>(VOICE_CHUNK_RECORD_TIME * 1000);
+    asp::Instant m_recordNextPoll;
+    std::atomic<bool> m_vadEnabled = false;
+    std::atomic<int> m_vadAttackMs = 20;
+    std::atomic<int> m_vadHangoverMs = 300;
+    bool m_recordVad = false;
+    VoiceActivityDetector m_vad{VOICE_TARGET_SAMPLERATE};
+    // silent frames that were encoded but not sent, sent once speech starts so that the attack time doesn't cut off its beginning, with their sequence numbers
+    std::vector<std::pair<EncodedOpusData, uint32_t>> m_recordPreroll;
+    size_t m_recordPrerollFrames = 0;
+
+    std::atomic<int> m_encBitrate, m_encComplexity, m_encFecPercent;
+    std::atomic<bool> m_encSettingsChanged = true;
+    std::atomic<uint64_t> m_encodeNanosTotal = 0;
+    std::atomic<uint64_t> m_encodedAudioNanosTotal = 0;
+    uint64_t m_loadSampleEncodeNanos = 0, m_loadSampleAudioNanos = 0; // main thread only
+
+    // what recording has cost so far, logged when it stops
+    struct RecordStats {
+        uint64_t frames = 0;
+        uint64_t silentFrames = 0;
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+        uint64_t encodeNanos = 0;
+    } m_recordStats;
 
     /* thread */
     arc::TaskHandle<void> m_workerTask;
@@ -157,12 +202,15 @@ private:
     arc::Future<> threadFunc(arc::mpsc::Receiver<AudioThreadMessage> rx);
     void threadHandleMessage(AudioThreadMessage msg);
     Result<> threadProcessMicrophone();
+    void threadScheduleRecordPoll();
+    void threadLogRecordStats();
     void threadStopRecording(bool halt, bool ignoreErrors = false);
     Result<> threadStartRecording();
     void threadInvokeMicCallback();
     void threadInvokeRawCallback(const float* pcm, size_t samples);
 
     float calculateVolume(AudioSource& src, const CCPoint& playerPos, bool voiceProximity);
+    float calculatePan(AudioSource& src, const CCPoint& playerPos, bool voiceProximity);
 
     /* playback */
     std::unordered_set<std::shared_ptr<AudioSource>> m_playbackSources;
@@ -172,6 +220,8 @@ private:
     int m_focusedPlayer = -1;
     bool m_deafen = false;
     bool m_lastProximity = false;
+    bool m_useVoiceMixer = false;
+    std::unique_ptr<VoiceMixer> m_voiceMixer;
 };
 
 std::string guidToString(const FMOD_GUID& guid);
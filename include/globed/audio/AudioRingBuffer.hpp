@@ -0,0 +1,134 @@
+#pragma once
+
+#include "../config.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <span>
+
+namespace globed {
+
+/// Wait-free single producer, single consumer ring buffer of audio samples with a power of two capacity.
+/// One thread may call the writing functions (`write`, `writeSpans`, `commitWrite`) while another thread calls the reading ones
+/// (`read`, `peek`, `readSpans`, `consume`, `discard`, `clear`). Neither side ever blocks or allocates.
+class AudioRingBuffer {
+public:
+    /// Up to two contiguous regions of the buffer, the second one is empty unless the region wraps around
+    template <typename T>
+    struct Spans {
+        std::span<T> first;
+        std::span<T> second;
+
+        size_t size() const { return first.size() + second.size(); }
+    };
+
+    /// Capacity is rounded up to a power of two
+    explicit AudioRingBuffer(size_t capacity)
+        : m_capacity(std::bit_ceil(std::max<size_t>(capacity, 2))),
+          m_mask(m_capacity - 1),
+          m_data(std::make_unique<float[]>(m_capacity)) {}
+
+    AudioRingBuffer(const AudioRingBuffer&) = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    size_t capacity() const { return m_capacity; }
+
+    /// Samples available for reading. Exact when called from the consumer, a lower bound from the producer.
+    size_t size() const {
+        return m_head.load(std::memory_order::acquire) - m_tail.load(std::memory_order::acquire);
+    }
+
+    /// Free space for writing. Exact when called from the producer, a lower bound from the consumer.
+    size_t freeSpace() const {
+        return m_capacity - this->size();
+    }
+
+    // -- producer --
+
+    /// Returns the free regions of the buffer, at most `max` samples. Fill them and call `commitWrite`.
+    Spans<float> writeSpans(size_t max) {
+        size_t head = m_head.load(std::memory_order::relaxed);
+        size_t tail = m_tail.load(std::memory_order::acquire);
+        size_t count = std::min(max, m_capacity - (head - tail));
+
+        return this->spansAt(head, count);
+    }
+
+    void commitWrite(size_t count) {
+        m_head.store(m_head.load(std::memory_order::relaxed) + count, std::memory_order::release);
+    }
+
+    /// Writes as many samples as fit, returns the amount written
+    size_t write(const float* data, size_t count) {
+        auto spans = this->writeSpans(count);
+        std::memcpy(spans.first.data(), data, spans.first.size_bytes());
+        std::memcpy(spans.second.data(), data + spans.first.size(), spans.second.size_bytes());
+        this->commitWrite(spans.size());
+
+        return spans.size();
+    }
+
+    // -- consumer --
+
+    /// Returns the readable regions of the buffer, at most `max` samples. Call `consume` once done with them.
+    Spans<const float> readSpans(size_t max = SIZE_MAX) const {
+        size_t tail = m_tail.load(std::memory_order::relaxed);
+        size_t head = m_head.load(std::memory_order::acquire);
+        size_t count = std::min(max, head - tail);
+
+        auto spans = const_cast<AudioRingBuffer*>(this)->spansAt(tail, count);
+        return { spans.first, spans.second };
+    }
+
+    void consume(size_t count) {
+        m_tail.store(m_tail.load(std::memory_order::relaxed) + count, std::memory_order::release);
+    }
+
+    size_t peek(float* out, size_t max) const {
+        auto spans = this->readSpans(max);
+        std::memcpy(out, spans.first.data(), spans.first.size_bytes());
+        std::memcpy(out + spans.first.size(), spans.second.data(), spans.second.size_bytes());
+
+        return spans.size();
+    }
+
+    size_t read(float* out, size_t max) {
+        size_t count = this->peek(out, max);
+        this->consume(count);
+        return count;
+    }
+
+    /// Drops up to `count` of the oldest samples, returns the amount dropped
+    size_t discard(size_t count) {
+        count = std::min(count, this->size());
+        this->consume(count);
+        return count;
+    }
+
+    /// Drops all samples that are currently in the buffer
+    void clear() {
+        m_tail.store(m_head.load(std::memory_order::acquire), std::memory_order::release);
+    }
+
+private:
+    size_t m_capacity;
+    size_t m_mask;
+    std::unique_ptr<float[]> m_data;
+    // positions increase forever and are masked on access, so full and empty can be told apart
+    alignas(64) std::atomic<size_t> m_head{0}; // written by the producer
+    alignas(64) std::atomic<size_t> m_tail{0}; // written by the consumer
+
+    Spans<float> spansAt(size_t pos, size_t count) {
+        size_t offset = pos & m_mask;
+        size_t first = std::min(count, m_capacity - offset);
+
+        return {
+            std::span<float>{m_data.get() + offset, first},
+            std::span<float>{m_data.get(), count - first},
+        };
+    }
+};
+
+}
@@ -3,10 +3,13 @@
 #include "../config.hpp"
 #include <optional>
 #include <cstddef>
-#include <deque>
+#include <vector>
 
 namespace globed {
 
+/// Single threaded FIFO of audio samples. Samples are kept contiguous, reading only advances an offset
+/// and the consumed space is reclaimed once it makes up most of the buffer.
+/// For passing samples between threads, use `AudioRingBuffer`.
 class GLOBED_DLL AudioSampleQueue {
 public:
     AudioSampleQueue() = default;
@@ -28,7 +31,10 @@ public:
 
 private:
     size_t m_limit = 0;
-    std::deque<float> m_queue;
+    size_t m_start = 0;
+    std::vector<float> m_queue;
+
+    void compact();
 };
 
 }
\ No newline at end of file
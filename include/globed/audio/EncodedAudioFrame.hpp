@@ -20,6 +20,15 @@ struct GLOBED_DLL EncodedAudioFrame {
 
     // adds this audio frame to the list
     Result<> pushOpusFrame(const EncodedOpusData& frame);
+    // adds a frame encoded by this client. the sequence number of the first frame is stored in it as the packet header,
+    // the frames after it must follow it without gaps (see `nextSequence`)
+    Result<> pushOpusFrame(const EncodedOpusData& frame, uint32_t sequence);
+
+    // sequence number of the first frame, read from the packet header. frame `i` has the sequence number `firstSequence() + i`.
+    // returns nullopt for empty packets and packets from clients that don't send one
+    std::optional<uint32_t> firstSequence() const;
+    // sequence number the next frame pushed into this packet must have, nullopt if it is empty
+    std::optional<uint32_t> nextSequence() const;
 
     // set the capacity of the audio frame, in individual opus frames
     void setCapacity(size_t frames);
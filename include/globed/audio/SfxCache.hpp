@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../prelude.hpp"
+#include <fmod.hpp>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace globed {
+
+/// A sound loaded fully into memory, which can be played on any amount of channels at once.
+/// Shared by the cache and every `Sound` playing it, and released once none of them use it anymore.
+class GLOBED_DLL SfxSample {
+public:
+    explicit SfxSample(FMOD::Sound* sound);
+    ~SfxSample();
+
+    SfxSample(const SfxSample&) = delete;
+    SfxSample& operator=(const SfxSample&) = delete;
+
+    FMOD::Sound* sound() const;
+
+    /// Whether the sample finished loading (successfully or not)
+    bool isLoaded() const;
+    bool failed() const;
+    /// Size of the decoded audio in bytes, 0 while still loading
+    size_t memoryUsage() const;
+
+private:
+    FMOD::Sound* m_sound;
+};
+
+/// Keeps decoded emote sound effects around, so that playing an emote again doesn't read and decode its file again.
+/// Samples are loaded in the background by FMOD, and the least recently played ones are evicted once the cache goes over its memory limit.
+/// Only used from the main thread.
+class GLOBED_DLL SfxCache : public SingletonLeakBase<SfxCache> {
+    friend class SingletonLeakBase;
+    SfxCache() = default;
+
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t entries = 0;
+        size_t memoryUsage = 0;
+
+        float hitRate() const;
+    };
+
+    /// Returns the sample for the given ID, starting to load it from `path` if it isn't cached.
+    /// The returned sample may still be loading, `Sound` delays playing it until it's ready.
+    Result<std::shared_ptr<SfxSample>> get(uint32_t id, const std::string& path);
+
+    /// Starts loading the sample in the background without counting towards the hit rate, does nothing if it's already cached.
+    void warm(uint32_t id, const std::string& path);
+
+    void setMemoryLimit(size_t bytes);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<SfxSample> sample;
+        std::list<uint32_t>::iterator lruPos;
+    };
+
+    std::unordered_map<uint32_t, Entry> m_entries;
+    std::list<uint32_t> m_lru; // most recently used first
+    size_t m_memoryLimit = 8 * 1024 * 1024;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+    size_t m_evictions = 0;
+
+    Result<std::shared_ptr<SfxSample>> load(uint32_t id, const std::string& path);
+    void trim();
+};
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../prelude.hpp"
+
+namespace globed {
+
+/// Decides whether captured audio contains speech, so that silence and background noise don't have to be sent.
+/// Every 10ms block is judged by its energy above an adaptive noise floor and by how much of that energy is in the speech band (300-3400Hz),
+/// which keeps steady broadband noise (fans, hiss) and low rumble (hum, desk bumps) from triggering it.
+///
+/// Attack is how long speech has to last before the detector turns on, hangover is how long it stays on after speech stops,
+/// so that pauses between words and quiet word endings aren't cut off.
+class GLOBED_DLL VoiceActivityDetector {
+public:
+    static constexpr size_t BLOCK_MS = 10;
+
+    VoiceActivityDetector(int sampleRate = 0, int attackMs = 20, int hangoverMs = 300);
+
+    /// Analyzes the samples and returns whether the detector was on at any point during them.
+    /// Samples that don't fill a whole block are kept and analyzed together with the next call.
+    bool process(const float* pcm, size_t samples);
+
+    /// Whether the detector is currently on (speech, or within the hangover after it)
+    bool isActive() const;
+    /// Whether the last analyzed block looked like speech, ignoring attack and hangover
+    bool lastBlockSpeech() const;
+
+    void setTimings(int attackMs, int hangoverMs);
+    /// Forgets the noise floor and turns the detector off, call when a new recording starts
+    void reset();
+
+private:
+    struct Biquad {
+        float b0 = 1.f, b1 = 0.f, b2 = 0.f, a1 = 0.f, a2 = 0.f;
+        float z1 = 0.f, z2 = 0.f;
+
+        float process(float in);
+    };
+
+    int m_sampleRate;
+    size_t m_blockSize;
+    size_t m_attackBlocks = 1;
+    size_t m_hangoverBlocks = 0;
+
+    // speech band filter, highpass followed by lowpass
+    Biquad m_highpass, m_lowpass;
+
+    size_t m_blockFill = 0;
+    double m_blockEnergy = 0.0;
+    double m_blockBandEnergy = 0.0;
+
+    float m_noiseFloor;      // of the speech band energy
+    float m_totalNoiseFloor; // of the whole signal
+    size_t m_blocksSeen = 0;
+    size_t m_speechRun = 0;
+    size_t m_hangoverLeft = 0;
+    bool m_active = false;
+    bool m_lastSpeech = false;
+
+    void finishBlock();
+};
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "EncodedAudioFrame.hpp"
+#include "../prelude.hpp"
+#include <globed/util/FlatIntMap.hpp>
+
+#include <Geode/utils/async.hpp>
+#include <arc/sync/mpsc.hpp>
+#include <asp/sync/Mutex.hpp>
+
+namespace globed {
+
+class VoiceStream;
+
+/// Decodes incoming voice on background workers, so that opus decoding never happens on the main thread.
+/// Every account is pinned to one worker, which makes it the only thread writing into that stream (as `VoiceStream` requires)
+/// and keeps frames in the order they arrived.
+///
+/// Once the main thread has decided that voice from an account should be played, it adds a route for it,
+/// after which frames from that account are handed to a worker directly from the network thread.
+/// Routes must be removed whenever that decision could change (player muted, deafened, settings changed, level left).
+class GLOBED_DLL VoiceDecodePool : public SingletonLeakBase<VoiceDecodePool> {
+    friend class SingletonLeakBase;
+    VoiceDecodePool();
+
+public:
+    /// Queues a frame to be decoded into the stream, can be called from any thread
+    void submit(int accountId, std::shared_ptr<VoiceStream> stream, EncodedAudioFrame frame);
+
+    /// Called on the network thread. If the account has a route, queues the frame and returns true,
+    /// otherwise returns false and the frame should go through the main thread.
+    bool submitRouted(int accountId, EncodedAudioFrame& frame);
+
+    void addRoute(int accountId, const std::shared_ptr<VoiceStream>& stream);
+    void removeRoute(int accountId);
+    void clearRoutes();
+
+private:
+    struct Job {
+        std::shared_ptr<VoiceStream> stream;
+        EncodedAudioFrame frame;
+        int accountId;
+    };
+
+    std::vector<arc::mpsc::Sender<Job>> m_workers;
+    std::vector<arc::TaskHandle<void>> m_tasks;
+    asp::Mutex<FlatIntMap<std::weak_ptr<VoiceStream>>> m_routes;
+
+    arc::Future<> workerFunc(arc::mpsc::Receiver<Job> rx);
+};
+
+}
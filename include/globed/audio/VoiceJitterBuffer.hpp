@@ -0,0 +1,88 @@
+#pragma once
+
+#include "EncodedAudioFrame.hpp"
+#include <asp/time/Instant.hpp>
+#include <array>
+#include <atomic>
+
+namespace globed {
+
+/// Counters describing how voice from one player arrived, can be read from any thread
+struct VoiceJitterStats {
+    std::atomic<uint64_t> frames = 0;    // frames that were played, including recovered and concealed ones
+    std::atomic<uint64_t> recovered = 0; // lost frames that were rebuilt from FEC data of the next frame
+    std::atomic<uint64_t> concealed = 0; // lost frames that were replaced by packet loss concealment
+    std::atomic<uint64_t> late = 0;      // frames that arrived after they were already concealed
+    std::atomic<uint64_t> heldMicros = 0; // total time that played frames spent waiting in the buffer
+    std::atomic<uint32_t> jitterMicros = 0; // current interarrival jitter estimate
+};
+
+/// Adaptive jitter buffer for the voice of one player. Orders incoming opus frames by their sequence number,
+/// holds audio back at the start of a talk spurt based on how much the packet arrival times vary,
+/// and decides when a missing frame should stop being waited for and be recovered (FEC) or concealed (PLC) instead.
+/// It does not decode anything itself, `VoiceStream` performs the steps it returns.
+/// Not thread safe, only used by the thread that writes into the stream (except for `stats`).
+class VoiceJitterBuffer {
+public:
+    enum class Action : uint8_t {
+        None,    // nothing to play right now
+        Decode,  // decode `frame` normally
+        Recover, // the next frame is lost, recover it from the FEC data in `frame` (the frame after it)
+        Conceal, // the next frame is lost and can't be recovered, conceal it
+    };
+
+    struct Step {
+        Action action = Action::None;
+        const EncodedOpusData* frame = nullptr;
+    };
+
+    /// `frameSecs` is the frame duration assumed until the first packet arrives, after that it follows the received frames
+    VoiceJitterBuffer(int sampleRate, float frameSecs);
+
+    /// Adds the frames of a received packet. Returns false and adds nothing if they have no sequence numbers (older clients)
+    bool push(const EncodedAudioFrame& packet, asp::time::Instant now);
+
+    /// Returns what should be played next, `queuedSecs` is the amount of decoded audio that is still waiting for playback.
+    /// Once the step is performed, `pop` must be called before calling this again.
+    Step next(asp::time::Instant now, float queuedSecs);
+    void pop(const Step& step, asp::time::Instant now);
+
+    bool empty() const;
+    /// How much audio the buffer aims to have queued, follows the measured jitter
+    float targetDelay() const;
+    float jitter() const;
+    const VoiceJitterStats& stats() const;
+
+private:
+    static constexpr size_t SLOTS = 64;
+
+    struct Slot {
+        EncodedOpusData frame;
+        asp::time::Instant arrival;
+        uint32_t seq = 0;
+        bool used = false;
+    };
+
+    std::array<Slot, SLOTS> m_slots;
+    size_t m_held = 0;
+    uint32_t m_nextSeq = 0;
+    bool m_started = false;
+    bool m_prebuffering = true;
+
+    int m_sampleRate;
+    float m_frameSecs; // duration of the frames in the last received packet
+    float m_jitter;
+    uint32_t m_lastPacketSeq = 0;
+    asp::time::Instant m_lastPacketArrival;
+    bool m_hasLastPacket = false;
+
+    VoiceJitterStats m_stats;
+
+    void insert(const EncodedOpusData& frame, uint32_t seq, asp::time::Instant now);
+    void reset(uint32_t seq);
+    Slot* slotFor(uint32_t seq);
+    // how long the oldest held frame has been waiting, in seconds
+    float longestWait(asp::time::Instant now) const;
+};
+
+}
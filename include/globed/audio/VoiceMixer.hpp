@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../prelude.hpp"
+#include <asp/sync.hpp>
+#include <fmod.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace globed {
+
+class VoiceStream;
+
+/// Mixes all voice streams into a single stereo FMOD stream, instead of each speaker playing on its own FMOD channel.
+/// Every source is added with its own gain and pan (set by `AudioManager` through `rawSetVolume` / `rawSetPan`),
+/// sources that are silent or out of range are skipped without being mixed.
+class GLOBED_DLL VoiceMixer {
+public:
+    VoiceMixer(FMOD::System* system);
+    ~VoiceMixer();
+
+    VoiceMixer(const VoiceMixer&) = delete;
+    VoiceMixer& operator=(const VoiceMixer&) = delete;
+
+    /// Adds a stream to the mix, starting the output stream if it isn't playing yet
+    Result<> addSource(VoiceStream* stream);
+    /// Removes a stream from the mix, after this returns the mixer will not touch it anymore
+    void removeSource(VoiceStream* stream);
+    size_t sourceCount();
+
+    /// Mixes `frames` stereo frames of all sources into `out` (interleaved, overwriting its contents).
+    /// Called on the fmod mixer thread, but can be invoked manually when there is no output stream.
+    void mix(float* out, size_t frames);
+
+    /// Stops the output stream, it is restarted when a source is added again
+    void stop();
+
+private:
+    FMOD::System* m_system;
+    FMOD::Sound* m_sound = nullptr;
+    FMOD::Channel* m_channel = nullptr;
+    // the source list is edited under this lock and then published, `mix` only reads the published list and never locks
+    asp::Mutex<std::unique_ptr<std::vector<VoiceStream*>>> m_sources;
+    std::atomic<const std::vector<VoiceStream*>*> m_published = nullptr;
+    // amount of `mix` calls in progress, an old list is only freed once this drops to zero
+    std::atomic<size_t> m_mixing = 0;
+    // mono samples of the source that's being mixed, only used inside `mix`
+    std::unique_ptr<float[]> m_scratch;
+
+    Result<> startOutput();
+    void publishSources(std::unique_ptr<std::vector<VoiceStream*>>& current, std::vector<VoiceStream*> sources);
+};
+
+/// Adds `samples` mono samples multiplied by `gainL` / `gainR` into the interleaved stereo buffer `out`
+void mixMonoToStereo(float* out, const float* in, size_t samples, float gainL, float gainR);
+/// Clamps all samples to [-1, 1]
+void clampSamples(float* data, size_t samples);
+
+}
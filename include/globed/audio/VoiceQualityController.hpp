@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../prelude.hpp"
+#include <asp/time/Instant.hpp>
+#include <optional>
+
+namespace globed {
+
+/// Opus encoder settings picked by `VoiceQualityController`
+struct VoiceEncoderSettings {
+    int bitrate = 24000;     // bits per second, close to what opus picks on its own for 24kHz mono
+    int complexity = 10;     // 0-10, higher is better quality for the same bitrate but slower
+    int fecLossPercent = 10; // expected packet loss that in-band FEC is tuned for
+
+    bool operator==(const VoiceEncoderSettings&) const = default;
+};
+
+/// What the controller bases its decisions on, sampled periodically on the main thread
+struct VoiceLinkStats {
+    float loss = 0.f;        // fraction of recent game server packets that were lost (0-1)
+    float rttMs = 0.f;       // round trip time to the game server, 0 if unknown
+    size_t listeners = 0;    // players in the level, the server sends our voice to each of them
+    float encoderLoad = 0.f; // time spent encoding divided by the duration of the audio, 0 if nothing was recorded yet
+};
+
+/// Adapts the voice encoder to the connection and the device.
+/// Bitrate is capped lower the more listeners there are (server fan-out), drops quickly when the link shows loss or queueing delay
+/// and recovers slowly once it's stable. Complexity drops when encoding takes a noticeable share of the CPU (weak phones),
+/// and FEC is tuned for the loss that is actually measured.
+class GLOBED_DLL VoiceQualityController {
+public:
+    VoiceQualityController();
+
+    /// Feeds new measurements, returns the new settings if they changed
+    std::optional<VoiceEncoderSettings> update(const VoiceLinkStats& stats, asp::time::Instant now);
+
+    const VoiceEncoderSettings& settings() const;
+    /// Short description of why the settings last changed
+    std::string_view reason() const;
+
+private:
+    VoiceEncoderSettings m_settings;
+    std::string_view m_reason = "initial";
+
+    float m_rttBaseline = 0.f;
+    asp::time::Instant m_lastBitrateChange;
+    asp::time::Instant m_lastComplexityChange;
+    asp::time::Instant m_lastCongestion;
+};
+
+}
@@ -2,12 +2,24 @@
 
 #include "../prelude.hpp"
 #include <asp/time/Instant.hpp>
-#include "AudioSampleQueue.hpp"
+#include <vector>
 
 namespace globed {
 
+/// Estimates how loud a stream currently sounds, from the RMS of the samples that were played recently.
+/// Samples only count once they are `AUDIO_PLAYBACK_DELAY` old, since that's when they are actually heard.
+/// Only the sum of squares of every block of fed samples is kept, so neither feeding nor updating copies any samples.
 class GLOBED_DLL VolumeEstimator {
 public:
+    // when only part of a block is used, its energy is assumed to be spread evenly, small blocks keep that error low
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    struct Block {
+        asp::time::Instant time;
+        float energy; // sum of squares
+        uint32_t samples;
+    };
+
     VolumeEstimator(size_t sampleRate = 0);
 
     VolumeEstimator(const VolumeEstimator&) = default;
@@ -17,10 +29,14 @@ public:
     VolumeEstimator& operator=(VolumeEstimator&&) = default;
 
     void feedData(const float* pcm, size_t samples);
+    void feedData(const float* pcm, size_t samples, asp::time::Instant now);
+    /// Feeds a block that was already reduced to its sum of squares, at most `BLOCK_SIZE` samples long
+    void feedBlock(const Block& block);
 
     void update(float dt);
+    void update(float dt, asp::time::Instant now);
 
-    float getVolume();
+    float getVolume() const;
 
 private:
     static constexpr float BUFFER_SIZE = 1.2f;
@@ -28,8 +44,17 @@ private:
     float m_emaVolume = 0.f;
     float m_normalizedVolume = 0.f;
     size_t m_sampleRate = 0;
-    AudioSampleQueue m_sampleQueue;
-    std::deque<std::pair<asp::time::Instant, size_t>> m_writeHistory;
+
+    // ring of fed blocks, oldest first
+    std::vector<Block> m_blocks;
+    size_t m_blockStart = 0;
+    size_t m_blockCount = 0;
+    size_t m_queuedSamples = 0;
+
+    void clear();
 };
 
+/// Returns the sum of squares of the samples
+float sumOfSquares(const float* pcm, size_t samples);
+
 }
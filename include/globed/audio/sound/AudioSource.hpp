@@ -62,6 +62,10 @@ public:
     /// Must not be called manually, AudioManager will call this with the final determined volume of the source.
     virtual void rawSetVolume(float volume) = 0;
 
+    /// Optional, called right after rawSetVolume with the stereo position of the source, from -1 (left) to 1 (right).
+    /// Only sources played through the voice mixer currently apply it.
+    virtual void rawSetPan(float pan) {}
+
     /// Called periodically (usually 30 times a second), right after rawSetVolume.
     /// Can be used for various custom logic the source may need.
     virtual void onUpdate() {}
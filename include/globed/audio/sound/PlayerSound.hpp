@@ -24,6 +24,13 @@ public:
         bool paused = false
     );
 
+    /// Creates a sound that plays a shared sample (e.g. from `SfxCache`), returns error on failure.
+    static Result<std::shared_ptr<PlayerSound>> create(
+        std::shared_ptr<SfxSample> sample,
+        std::shared_ptr<RemotePlayer> player,
+        bool paused = false
+    );
+
     std::optional<CCPoint> getPosition() const override;
     bool isPlaying() const override;
 
@@ -5,6 +5,8 @@
 
 namespace globed {
 
+class SfxSample;
+
 /// Represents a sound, stream, or anything else that can be represented as an FMOD::Sound
 class GLOBED_DLL Sound : public AudioSource {
 public:
@@ -16,6 +18,9 @@ public:
     /// Creates a sound from the given path, returns error on failure.
     static Result<std::shared_ptr<Sound>> create(const char* path, bool paused = false);
 
+    /// Creates a sound that plays a shared sample (e.g. from `SfxCache`), which is not released when the sound stops.
+    static Result<std::shared_ptr<Sound>> create(std::shared_ptr<SfxSample> sample, bool paused = false);
+
     /// Creates a sound from the given PCM data, returns error on failure.
     static Result<std::shared_ptr<Sound>> create(const float* pcm, size_t samples, int sampleRate, int channels, bool paused = false);
 
@@ -33,6 +38,7 @@ protected:
 
     FMOD::Sound* m_sound = nullptr;
     FMOD::Channel* m_channel = nullptr;
+    std::shared_ptr<SfxSample> m_sample; // keeps m_sound alive if it's shared
     float m_rawVolume = 0.f;
     std::optional<PlayOptions> m_delayedPlay;
 
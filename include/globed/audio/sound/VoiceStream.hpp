@@ -2,8 +2,9 @@
 
 #include "PlayerSound.hpp"
 #include "../AudioDecoder.hpp"
-#include "../AudioSampleQueue.hpp"
+#include "../AudioRingBuffer.hpp"
 #include "../EncodedAudioFrame.hpp"
+#include "../VoiceJitterBuffer.hpp"
 #include "../VolumeEstimator.hpp"
 
 #include <asp/sync.hpp>
@@ -11,6 +12,8 @@
 
 namespace globed {
 
+class VoiceMixer;
+
 // This is how long it takes for audio to start playing after pcmreadcallback gets invoked
 // By default, FMOD uses 400ms, we decrease it to 200ms
 constexpr float AUDIO_PLAYBACK_DELAY = 0.2f;
@@ -25,14 +28,23 @@ public:
 
     ~VoiceStream();
 
+    // creates a stream, played through the mixer if one is given, otherwise on its own fmod channel
     static Result<std::shared_ptr<VoiceStream>> create(
-        std::weak_ptr<RemotePlayer> player
+        std::weak_ptr<RemotePlayer> player,
+        VoiceMixer* mixer = nullptr
     );
 
-    // write an audio frame to this stream. returns error if opus decoding failed
-    Result<> writeData(const EncodedAudioFrame& frame);
-    // write raw audio data to this stream
+    // Add an audio frame to the jitter buffer of this stream and decode what is ready to play. returns error if opus decoding failed.
+    // Must only be called from one thread at a time, normally the decode worker the stream is assigned to (see `VoiceDecodePool`).
+    // `now` is the arrival time of the frame, only passed explicitly when simulating a stream (benchmarks)
+    Result<> writeData(const EncodedAudioFrame& frame, asp::time::Instant now = asp::time::Instant::now());
+    // write raw audio data to this stream, same threading rules as above
     void writeData(const float* pcm, size_t samples);
+    // Decode whatever the jitter buffer has ready to play, same threading rules as above.
+    // Must be called periodically while `hasHeldFrames` is true, so that lost frames are concealed in time.
+    Result<> pump(asp::time::Instant now = asp::time::Instant::now());
+    bool hasHeldFrames() const;
+    const VoiceJitterStats& jitterStats() const;
 
     void updateEstimator(float dt);
 
@@ -43,21 +55,53 @@ public:
     bool isStarving();
     float getAudibility() const override;
     float getVolume() const override;
+    bool isPlaying() const override;
     void stop() override;
     void onUpdate() override;
     void rawSetVolume(float volume) override;
+    void rawSetPan(float pan) override;
+
+    // Fills `data` with the next samples to play, zeroes if there aren't enough.
+    // Runs on the fmod mixer thread, either from this stream's own callback or from the voice mixer.
+    void readCallback(float* data, unsigned int len);
+    // Drops the next samples instead of playing them, so a stream the mixer skips doesn't fall behind. Same thread as above.
+    void skipPlayback(size_t samples);
+    size_t queuedSamples() const;
+    // volume and pan the mixer should play this stream with
+    float mixGain() const;
+    float mixPan() const;
 
 private:
+    // decoder and its output buffer, only used by the writing thread
     AudioDecoder m_decoder;
+    std::unique_ptr<float[]> m_decodeBuffer;
     std::atomic<bool> m_starving = true; // true if there aren't enough samples in the queue
-    asp::Mutex<AudioSampleQueue> m_queue;
-    asp::Mutex<VolumeEstimator> m_estimator;
+    std::atomic<bool> m_overflowed = false; // set by the writer when the queue was full
+    // decoded samples, written by the decode worker and read on the fmod mixer thread
+    AudioRingBuffer m_queue;
+    // orders incoming frames and handles losses, only used by the writing thread
+    VoiceJitterBuffer m_jitter;
+    // amount of queued samples the jitter buffer aims for, the mixer plays slightly faster when there's a lot more than this
+    std::atomic<size_t> m_targetSamples = 0;
+    std::atomic<uint64_t> m_queuedSamplesTotal = 0; // sum of queue sizes when frames were added, for latency stats
+    std::unique_ptr<float[]> m_stretchBuffer; // used by the mixer thread when playing faster
+    // sums of squares of the played samples, written on the mixer thread and fed into the estimator on the main thread
+    std::unique_ptr<VolumeEstimator::Block[]> m_played;
+    std::atomic<size_t> m_playedHead = 0;
+    std::atomic<size_t> m_playedTail = 0;
+    VolumeEstimator m_estimator;
     asp::time::Instant m_lastPlaybackTime;
     asp::time::Instant m_lastUpdate;
     float m_rawVolume = 1.0f;
     bool m_muted = false;
+    VoiceMixer* m_mixer = nullptr;
+    std::atomic<float> m_mixGain = 0.f;
+    std::atomic<float> m_mixPan = 0.f;
 
-    void readCallback(float* data, unsigned int len);
+    void trimAfterOverflow();
+    void pushPlayed(const float* data, size_t samples);
+    Result<> decodeFrame(geode::FunctionRef<Result<size_t>(float*, size_t)> decode);
+    void logStats();
 };
 
 }
\ No newline at end of file
@@ -24,6 +24,8 @@ public:
     /// otherwise returns a Sound and plays it globally
     std::shared_ptr<Sound> playEmoteSfx(uint32_t id, std::shared_ptr<RemotePlayer> player, bool force = false);
     bool hasSfx(uint32_t id);
+    /// Starts loading the SFX of all favorite emotes in the background, so the first time they're used doesn't have to
+    void warmFavoriteSfx();
 
 protected:
     std::unordered_map<uint32_t, std::string> m_emoteNames;
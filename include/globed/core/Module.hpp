@@ -5,6 +5,7 @@
 #include <Geode/loader/Mod.hpp>
 #include "../core/data/PlayerDisplayData.hpp"
 #include "../core/data/PlayerState.hpp"
+#include "../core/game/FrameContext.hpp"
 #include "../config.hpp"
 
 #define GLOBED_CLAIM_HOOKS(module, modify, ...) \
@@ -40,6 +41,25 @@ enum class AutoEnableMode {
     Default = Server
 };
 
+/// Per-frame callbacks a module receives. Modules receive all of them by default, and can opt out of the ones they don't need with `setSkippedPhases`.
+enum class ModuleUpdatePhase : uint8_t {
+    None = 0,
+    /// `onFramePreUpdate` (and `onPreUpdate`), called before the game update
+    PreUpdate = 1 << 0,
+    /// `onFrameUpdate` (and `onUpdate`), called after the game update
+    Update = 1 << 1,
+
+    All = PreUpdate | Update,
+};
+
+constexpr ModuleUpdatePhase operator|(ModuleUpdatePhase a, ModuleUpdatePhase b) {
+    return static_cast<ModuleUpdatePhase>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+}
+
+constexpr bool operator&(ModuleUpdatePhase a, ModuleUpdatePhase b) {
+    return (static_cast<uint8_t>(a) & static_cast<uint8_t>(b)) != 0;
+}
+
 class GLOBED_DLL Module {
 public:
     inline Module() {
@@ -69,6 +89,13 @@ public:
         m_autoEnableMode = mode;
     }
 
+    /// Sets which per-frame callbacks the module does not want to receive. By default it receives all of them,
+    /// modules that don't do anything every frame should pass `ModuleUpdatePhase::All` to skip the per-frame calls.
+    /// Inline function; can be called without linking.
+    inline void setSkippedPhases(ModuleUpdatePhase phases) {
+        m_skippedPhases = phases;
+    }
+
     /// Adds a hook to the module. The hook will be enabled/disabled together with the module.
     /// The module will be responsible for managing this hook, do not use it manually.
     /// Inline function; can be called without linking.
@@ -136,13 +163,26 @@ protected:
     virtual bool shouldSpeedUpNewBest(GlobedGJBGL* gjbgl) { return false; }
     /// Called when the local player dies. Not called for anticheat spike, but is called for fake deaths.
     virtual void onLocalPlayerDeath(GlobedGJBGL* gjbgl, bool real) {}
-    /// Called every frame when in a level and connected to the server
+    /// Called every frame when in a level and connected to the server.
+    /// Deprecated, override `onFrameUpdate` instead. Only called by the default `onFrameUpdate`.
     virtual void onUpdate(GlobedGJBGL* gjbgl, float dt) {}
     /// Called every frame when in a level and connected to the server, before onUpdate. Deltatime here is more accurate.
+    /// Deprecated, override `onFramePreUpdate` instead. Only called by the default `onFramePreUpdate`.
     virtual void onPreUpdate(GlobedGJBGL* gjbgl, float dt) {}
     /// Return true if respawns should be synced (e.g. if room host has Faster Reset enabled, all players are affected)
     virtual bool wantsSyncReset() { return false; }
 
+    // These are declared last, so that the vtable slots of the functions above stay the same.
+
+    /// Called every frame when in a level and connected to the server, unless skipped with `setSkippedPhases`.
+    virtual void onFrameUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) {
+        this->onUpdate(gjbgl, ctx.dt);
+    }
+    /// Called every frame when in a level and connected to the server, before `onFrameUpdate`, unless skipped with `setSkippedPhases`.
+    virtual void onFramePreUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) {
+        this->onPreUpdate(gjbgl, ctx.dt);
+    }
+
 private:
     friend class Core;
     friend class CoreImpl;
@@ -152,8 +192,10 @@ private:
     bool m_enabled = false;
     std::vector<geode::Hook*> m_hooks;
     std::vector<geode::Patch*> m_patches;
+    // stored as an opt-out, so that modules built against older headers (which zero this byte) receive every phase
+    ModuleUpdatePhase m_skippedPhases = ModuleUpdatePhase::None;
 
-    uint8_t _reserved[59];
+    uint8_t _reserved[58];
 
     void assertCore() const;
     geode::Result<> enableHooks();
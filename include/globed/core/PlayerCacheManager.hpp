@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../util/singleton.hpp"
+#include "../util/FlatIntMap.hpp"
 #include "../core/data/PlayerDisplayData.hpp"
 #include "../core/data/SpecialUserData.hpp"
 
@@ -28,7 +29,7 @@ private:
     };
 
     // Layer 1 is the primary and accurate cache, layer 2 is for players that may have changed their data
-    std::unordered_map<int, Entry> m_layer1, m_layer2;
+    FlatIntMap<Entry> m_layer1, m_layer2;
 
     PlayerCacheManager() = default;
 };
@@ -5,6 +5,32 @@
 
 namespace globed {
 
+/// Time in integer microseconds since joining the level, used for the local time counter and all interpolation math.
+/// Unlike accumulated float seconds, this does not lose precision in long sessions.
+using PlayerTimestamp = int64_t;
+
+constexpr PlayerTimestamp TIMESTAMP_UNITS_PER_SEC = 1'000'000;
+
+constexpr PlayerTimestamp timestampFromSecs(double secs) {
+    double units = secs * static_cast<double>(TIMESTAMP_UNITS_PER_SEC);
+    return static_cast<PlayerTimestamp>(units >= 0.0 ? units + 0.5 : units - 0.5);
+}
+
+constexpr double timestampToSecs(PlayerTimestamp ts) {
+    return static_cast<double>(ts) / static_cast<double>(TIMESTAMP_UNITS_PER_SEC);
+}
+
+/// `PlayerState` carries its timestamp as float seconds, which is also how it is sent on the wire.
+/// The float loses precision in long sessions (about 1ms after two hours), but wrapping it around would make older clients
+/// see the timestamp jump backwards and reset the player, so it is sent as is until the protocol is versioned.
+constexpr float timestampToWire(PlayerTimestamp ts) {
+    return static_cast<float>(timestampToSecs(ts));
+}
+
+constexpr PlayerTimestamp timestampFromWire(float secs) {
+    return timestampFromSecs(secs);
+}
+
 enum class PlayerIconType : uint16_t {
     Unknown = 0,
     Cube = 1,
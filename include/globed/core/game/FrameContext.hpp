@@ -0,0 +1,37 @@
+#pragma once
+#include "GameCameraState.hpp"
+#include "../data/PlayerState.hpp"
+#include "../data/RoomSettings.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace globed {
+
+/// Data about the current frame that is computed once by the game layer and shared with everything that runs during the frame,
+/// so that modules don't have to recompute it. Stays valid (and unchanged) until the next frame starts.
+struct FrameContext {
+    /// Increases by one every frame
+    uint64_t frameNumber = 0;
+    /// Delta time of the frame, unaffected by the timescale
+    float dt = 0.f;
+    /// Same as the game layer's time counter
+    PlayerTimestamp timeCounter = 0;
+    /// Camera state at the start of the frame
+    GameCameraState camState{};
+    /// Room settings at the start of the frame
+    RoomSettings roomSettings{};
+    /// Players that are near the camera (within the 3x3 screen area), sorted by account ID, or nullptr if culling is disabled
+    const std::vector<int>* nearbyPlayers = nullptr;
+    /// Players that are on screen, sorted by account ID, or nullptr if level of detail is disabled
+    const std::vector<int>* onScreenPlayers = nullptr;
+    /// State of the local player after the game update, only set during the update phase (nullptr during pre update)
+    const PlayerState* localState = nullptr;
+    bool editor = false;
+
+    /// Whether the player is near the camera, always true if culling is disabled
+    bool isPlayerNearby(int playerId) const {
+        return !nearbyPlayers || std::binary_search(nearbyPlayers->begin(), nearbyPlayers->end(), playerId);
+    }
+};
+
+}
@@ -22,6 +22,18 @@ struct GameCameraState {
     inline cocos2d::CCPoint cameraCenter() const {
         return cameraOrigin + this->cameraCoverage() / 2.f;
     }
+
+    /// Returns the area around the camera in which players are considered nearby, a grid of 3x3 screens centered on the camera.
+    inline cocos2d::CCRect nearbyRect() const {
+        constexpr float fullScaleMult = 3.f;
+        constexpr float originMoveMult = (fullScaleMult - 1.f) / 2.f;
+
+        cocos2d::CCSize origCoverage = this->cameraCoverage();
+        cocos2d::CCSize coverage = origCoverage * fullScaleMult;
+        cocos2d::CCPoint origin = cameraOrigin - origCoverage * originMoveMult;
+
+        return cocos2d::CCRect{origin.x, origin.y, coverage.width, coverage.height};
+    }
 };
 
 }
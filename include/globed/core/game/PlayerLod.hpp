@@ -0,0 +1,68 @@
+#pragma once
+#include "GameCameraState.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace globed {
+
+/// Level of detail that a player is rendered with
+enum class PlayerLod : uint8_t {
+    /// Full fidelity, trails, particles, animations, name and status icons
+    Near,
+    /// No particles or trails, robot and spider animations are frozen
+    Mid,
+    /// Only a dot in a batched draw node, no icon or labels
+    Far,
+};
+
+struct PlayerLodParams {
+    /// Scale of the near and mid distances, 1.0 when there are no more players on screen than the budget.
+    /// Zero disables LOD, rendering everyone at full fidelity.
+    float scale = 0.f;
+
+    static constexpr float NEAR_DISTANCE = 0.5f;
+    static constexpr float MID_DISTANCE = 1.0f;
+    static constexpr float MIN_SCALE = 0.15f;
+
+    /// Creates the parameters for this frame, `budget` is the amount of players the user wants to see in full fidelity
+    static PlayerLodParams create(size_t onScreenPlayers, int budget) {
+        if (budget <= 0) {
+            return PlayerLodParams{};
+        }
+
+        float scale = 1.f;
+        if (onScreenPlayers > (size_t) budget) {
+            // shrink the areas so that roughly `budget` players fit inside the near area
+            scale = std::max(MIN_SCALE, std::sqrt((float) budget / (float) onScreenPlayers));
+        }
+
+        return PlayerLodParams{scale};
+    }
+
+    bool enabled() const {
+        return scale > 0.f;
+    }
+
+    /// Picks the LOD tier based on the distance from the camera, measured in screens (0.5 is the edge of the screen)
+    PlayerLod select(cocos2d::CCPoint position, const GameCameraState& camState) const {
+        if (!this->enabled()) return PlayerLod::Near;
+
+        auto coverage = camState.cameraCoverage();
+        auto offset = position - camState.cameraCenter();
+        float dist = std::max(
+            std::abs(offset.x) / std::max(coverage.width, 1.f),
+            std::abs(offset.y) / std::max(coverage.height, 1.f)
+        );
+
+        if (dist < NEAR_DISTANCE * scale) {
+            return PlayerLod::Near;
+        } else if (dist < MID_DISTANCE * scale) {
+            return PlayerLod::Mid;
+        } else {
+            return PlayerLod::Far;
+        }
+    }
+};
+
+}
@@ -16,24 +16,39 @@ struct PlayerStatusFlags {
     bool operator==(const PlayerStatusFlags& other) const = default;
 };
 
+class StatusIconBatch;
+
 class GLOBED_DLL PlayerStatusIcons : public CCNode {
 public:
     PlayerStatusIcons() = default;
+    ~PlayerStatusIcons();
     GLOBED_NOCOPY(PlayerStatusIcons);
     GLOBED_NOMOVE(PlayerStatusIcons);
 
     void updateStatus(const PlayerStatusFlags& flags, bool force = false);
     void setOpacity(unsigned char opacity);
 
+    void setPosition(const CCPoint& pos) override;
+    void setRotation(float rot) override;
+    void setScale(float scale) override;
+    void setAnchorPoint(const CCPoint& point) override;
+    void setVisible(bool visible) override;
+
     static PlayerStatusIcons* create(unsigned char opacity);
+    /// Creates status icons that are drawn by `batch` instead of their own nodes. The batch must be a sibling of the created node.
+    static PlayerStatusIcons* createBatched(unsigned char opacity, StatusIconBatch* batch);
 
 private:
     CCNode* m_iconWrapper = nullptr;
     PlayerStatusFlags m_flags;
     float m_nameScale = 0.f;
     unsigned char m_opacity = 255;
+    StatusIconBatch* m_batch = nullptr;
+    geode::Ref<cocos2d::CCSprite> m_batchRoot;
 
-    bool init(unsigned char opacity);
+    bool init(unsigned char opacity, StatusIconBatch* batch = nullptr);
+    void updateBatched(const PlayerStatusFlags& flags);
+    void syncBatchRoot();
 };
 
 }
\ No newline at end of file
@@ -13,14 +13,18 @@ struct Icons;
 namespace globed {
 
 class LazyPlayerIcon;
+class ProgressIconBatch;
 
 class GLOBED_DLL ProgressIcon : public CCNode {
 public:
     ProgressIcon() = default;
+    ~ProgressIcon();
     GLOBED_NOCOPY(ProgressIcon);
     GLOBED_NOMOVE(ProgressIcon);
 
     static ProgressIcon* create();
+    /// Creates a progress icon that is drawn by `batch` instead of its own nodes. The batch must be a sibling of the created node.
+    static ProgressIcon* createBatched(ProgressIconBatch* batch);
 
     void updateIcons(const cue::Icons& data);
     void updatePosition(float xpos, bool practicing);
@@ -28,13 +32,23 @@ public:
     void togglePracticeSprite(bool enabled);
     void setForceOnTop(bool state);
 
+    void setVisible(bool visible) override;
+
 private:
     cocos2d::CCLayerColor* m_line = nullptr;
     LazyPlayerIcon* m_icon = nullptr;
     bool m_forceOnTop = false;
 
-    bool init();
+    geode::WeakRef<cocos2d::CCSpriteBatchNode> m_batch; // always a ProgressIconBatch
+    geode::Ref<cocos2d::CCSprite> m_batchRoot;
+    cocos2d::CCSprite* m_batchLine = nullptr;
+    cocos2d::CCSprite* m_batchIcon = nullptr;
+    std::optional<size_t> m_iconCell;
+
+    bool init(ProgressIconBatch* batch = nullptr);
     void recalcOpacity();
+    void updateBatchedIcons(const cue::Icons& data);
+    void syncBatchRoot();
 };
 
 }
\ No newline at end of file
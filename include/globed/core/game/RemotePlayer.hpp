@@ -10,6 +10,7 @@ namespace globed {
 
 struct GameCameraState;
 struct PlayerStateFlags;
+class VisualPlayerPool;
 
 struct RemotePlayerUpdate {
     PlayerState state;
@@ -19,6 +20,8 @@ struct RemotePlayerUpdate {
     bool forceHide = false;
     bool forceVisibility = false;
     bool noCulling = false;
+    PlayerLodParams lod;
+    cocos2d::CCDrawNode* farBatch = nullptr;
 };
 
 class GLOBED_DLL RemotePlayer : public std::enable_shared_from_this<RemotePlayer> {
@@ -29,6 +32,8 @@ public:
     GLOBED_NOMOVE(RemotePlayer);
 
     void update(const RemotePlayerUpdate& update);
+    /// Like `update`, but skips all the visual work, used for players that are far away from the camera
+    void updateOffscreen(const RemotePlayerUpdate& update);
     void handleDeath(const PlayerDeath& death);
     void handleSpiderTp(const SpiderTeleportData& tp, bool p1);
     bool isDataInitialized() const;
@@ -56,6 +61,8 @@ public:
 
     void stopVoiceStream();
     void playVoiceData(EncodedAudioFrame frame);
+    /// Lets further voice data from this player go straight from the network thread to a decode worker, see `VoiceDecodePool`
+    void routeVoiceData();
     VoiceStream* getVoiceStream();
 
 private:
@@ -78,11 +85,12 @@ private:
     Ref<ProgressArrow> m_progArrow = nullptr;
     Ref<ProgressIcon> m_progIcon = nullptr;
     std::optional<uint16_t> m_teamId;
+    std::weak_ptr<VisualPlayerPool> m_pool;
     std::shared_ptr<VoiceStream> m_voiceStream;
-    std::shared_ptr<std::mutex> m_voiceStreamMutex;
 
     void beginDataUpdate();
     void doUpdateIcons();
+    void updateShared(const RemotePlayerUpdate& update, bool hideIcon, bool hideEverything);
 };
 
 }
\ No newline at end of file
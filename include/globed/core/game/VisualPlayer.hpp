@@ -5,6 +5,7 @@
 #include "../data/PlayerDisplayData.hpp"
 #include "PlayerStatusIcons.hpp"
 #include "GameCameraState.hpp"
+#include "PlayerLod.hpp"
 #include <Geode/Geode.hpp>
 
 namespace globed {
@@ -17,6 +18,7 @@ static constexpr int SPIDER_DASH_SPRITE_TAG = 234562347;
 static constexpr int DEATH_EFFECT_TAG = 234562349;
 static constexpr float NAME_OFFSET = 30.f;
 static constexpr float STATUS_ICONS_OFFSET = NAME_OFFSET + 15.f;
+static constexpr float FAR_PLAYER_DOT_RADIUS = 6.f;
 
 class RemotePlayer;
 class NameLabel;
@@ -31,6 +33,9 @@ struct VisualPlayerUpdate {
     bool forceHideEverything = false;
     bool forceVisibility = false;
     bool noCulling = false;
+    PlayerLodParams lod;
+    /// Draw node that far away players are drawn into, cleared every frame
+    cocos2d::CCDrawNode* farBatch = nullptr;
 };
 
 class GLOBED_DLL VisualPlayer : public PlayerObject {
@@ -41,8 +46,15 @@ public:
 
     static VisualPlayer* create(GJBaseGameLayer* gameLayer, RemotePlayer* rp, CCNode* playerNode, bool isSecond, bool localPlayer);
     void updateFromData(const VisualPlayerUpdate& data);
+    /// Cheap alternative to `updateFromData` for players that are far outside of the camera view
+    void updateOffscreen(const PlayerObjectData& data);
     void cleanupObjectLayer();
 
+    /// Binds a pooled player to a remote player, resetting all state left over from the previous owner
+    void rebind(RemotePlayer* rp);
+    /// Hides the player and detaches it from its remote player, so it can be put back into a pool
+    void unbind();
+
     PlayerIconData& icons();
     PlayerDisplayData& displayData();
     RemotePlayer* getRemotePlayer();
@@ -110,6 +122,19 @@ private:
     bool m_prevRotating = false;
     bool m_prevMini = false;
 
+    PlayerLod m_lod = PlayerLod::Near;
+
+    // what the robot and spider sprites currently show, used to skip redundant frame updates
+    struct ShownIcon {
+        int id = 0; // 0 if nothing was shown yet
+        cocos2d::ccColor3B color1{};
+        cocos2d::ccColor3B color2{};
+        std::optional<cocos2d::ccColor3B> glowColor;
+    };
+
+    ShownIcon m_robotShown;
+    ShownIcon m_spiderShown;
+
     CCPoint m_prevPosition;
     float m_prevRotation = 0.f;
 
@@ -124,12 +149,15 @@ private:
     void updateOpacity();
     void updateIconType(PlayerIconType iconType);
     void callUpdate(PlayerIconData& icons, PlayerIconType ty);
+    bool updateShownIcon(ShownIcon& shown, int id);
     void updateRobotAnimation();
     void updateSpiderAnimation();
     void animateSwingFire(bool goingDown);
     void animateRobotFire(bool enable);
     void hideRobotFire();
     void showRobotFire();
+    void applyLod(PlayerLod lod);
+    void setAnimationsFrozen(bool frozen);
 
     bool hideNearby(GJBaseGameLayer* gjbgl);
 
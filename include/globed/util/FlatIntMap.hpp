@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define GLOBED_FLATMAP_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GLOBED_FLATMAP_NEON
+#endif
+
+namespace globed {
+
+namespace detail::flatmap {
+    // Control bytes: 0..127 means the slot is full and holds the low 7 bits of the key's hash,
+    // the special values have the top bit set so they can never match a hash
+    constexpr int8_t CTRL_EMPTY = -128;
+    constexpr int8_t CTRL_DELETED = -2;
+    constexpr size_t GROUP_SIZE = 16;
+
+#ifdef GLOBED_FLATMAP_NEON
+    // neon has no movemask, so the mask is 4 bits per slot with only the top one kept
+    constexpr unsigned MASK_SHIFT = 2;
+#else
+    constexpr unsigned MASK_SHIFT = 0;
+#endif
+
+    /// Set of slots within a group, iterate with `lowest()` and `clearLowest()`
+    struct GroupMask {
+        uint64_t bits;
+
+        explicit operator bool() const { return bits != 0; }
+        size_t lowest() const { return static_cast<size_t>(std::countr_zero(bits)) >> MASK_SHIFT; }
+        void clearLowest() { bits &= bits - 1; }
+    };
+
+    /// 16 control bytes that are compared at once
+    struct Group {
+#if defined(GLOBED_FLATMAP_SSE2)
+        __m128i ctrl;
+
+        explicit Group(const int8_t* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+        GroupMask match(int8_t h2) const {
+            return { static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))) };
+        }
+
+        GroupMask matchEmpty() const {
+            return this->match(CTRL_EMPTY);
+        }
+
+        GroupMask matchEmptyOrDeleted() const {
+            return { static_cast<uint32_t>(_mm_movemask_epi8(ctrl)) };
+        }
+#elif defined(GLOBED_FLATMAP_NEON)
+        int8x16_t ctrl;
+
+        explicit Group(const int8_t* p) : ctrl(vld1q_s8(p)) {}
+
+        static GroupMask toMask(uint8x16_t cmp) {
+            uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+            return { vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull };
+        }
+
+        GroupMask match(int8_t h2) const {
+            return toMask(vceqq_s8(ctrl, vdupq_n_s8(h2)));
+        }
+
+        GroupMask matchEmpty() const {
+            return this->match(CTRL_EMPTY);
+        }
+
+        GroupMask matchEmptyOrDeleted() const {
+            return toMask(vcltq_s8(ctrl, vdupq_n_s8(0)));
+        }
+#else
+        const int8_t* ctrl;
+
+        explicit Group(const int8_t* p) : ctrl(p) {}
+
+        GroupMask match(int8_t h2) const {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < GROUP_SIZE; i++) {
+                bits |= static_cast<uint64_t>(ctrl[i] == h2) << i;
+            }
+            return { bits };
+        }
+
+        GroupMask matchEmpty() const {
+            return this->match(CTRL_EMPTY);
+        }
+
+        GroupMask matchEmptyOrDeleted() const {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < GROUP_SIZE; i++) {
+                bits |= static_cast<uint64_t>(ctrl[i] < 0) << i;
+            }
+            return { bits };
+        }
+#endif
+    };
+}
+
+/// Flat open addressing hash map for integer keys (account IDs, item IDs), meant for tables that are read every frame.
+/// Entries are stored contiguously in a vector, with a separate index of control bytes that is probed 16 slots at a time (SSE2 / NEON).
+///
+/// Iteration goes over the entry vector, so it's as fast as iterating a vector and the order does not depend on hashing:
+/// entries are in insertion order, except that erasing an entry moves the last entry into its place.
+/// This also means that erasing the entry an iterator points to and continuing from the returned iterator visits every entry exactly once.
+///
+/// Unlike `std::unordered_map`, references and iterators are invalidated by any insertion or erasure, like with `std::vector`.
+template <typename V>
+class FlatIntMap {
+public:
+    using key_type = int;
+    using mapped_type = V;
+    using value_type = std::pair<int, V>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    FlatIntMap() = default;
+
+    iterator begin() { return m_entries.begin(); }
+    iterator end() { return m_entries.end(); }
+    const_iterator begin() const { return m_entries.begin(); }
+    const_iterator end() const { return m_entries.end(); }
+    const_iterator cbegin() const { return m_entries.cbegin(); }
+    const_iterator cend() const { return m_entries.cend(); }
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+    void clear() {
+        m_entries.clear();
+        std::fill(m_ctrl.begin(), m_ctrl.end(), detail::flatmap::CTRL_EMPTY);
+        m_deleted = 0;
+    }
+
+    void reserve(size_t count) {
+        m_entries.reserve(count);
+
+        size_t cap = capacityFor(count);
+        if (cap > m_ctrl.size()) {
+            this->rehash(cap);
+        }
+    }
+
+    iterator find(int key) {
+        size_t slot = this->findSlot(key);
+        return slot == NPOS ? this->end() : this->begin() + m_slots[slot];
+    }
+
+    const_iterator find(int key) const {
+        size_t slot = this->findSlot(key);
+        return slot == NPOS ? this->end() : this->begin() + m_slots[slot];
+    }
+
+    bool contains(int key) const {
+        return this->findSlot(key) != NPOS;
+    }
+
+    size_t count(int key) const {
+        return this->contains(key) ? 1 : 0;
+    }
+
+    V& at(int key) {
+        size_t slot = this->findSlot(key);
+        if (slot == NPOS) throw std::out_of_range("FlatIntMap::at: key not found");
+        return m_entries[m_slots[slot]].second;
+    }
+
+    const V& at(int key) const {
+        size_t slot = this->findSlot(key);
+        if (slot == NPOS) throw std::out_of_range("FlatIntMap::at: key not found");
+        return m_entries[m_slots[slot]].second;
+    }
+
+    V& operator[](int key) {
+        return this->try_emplace(key).first->second;
+    }
+
+    /// Inserts a value constructed from `args` if the key is not present, otherwise does nothing
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(int key, Args&&... args) {
+        size_t slot = this->findSlot(key);
+        if (slot != NPOS) {
+            return { this->begin() + m_slots[slot], false };
+        }
+
+        this->growIfNeeded();
+
+        uint64_t hash = hashKey(key);
+        slot = this->findInsertSlot(hash);
+        if (m_ctrl[slot] == detail::flatmap::CTRL_DELETED) m_deleted--;
+
+        m_ctrl[slot] = h2(hash);
+        m_slots[slot] = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+
+        return { this->end() - 1, true };
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(int key, Args&&... args) {
+        return this->try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    std::pair<iterator, bool> insert_or_assign(int key, T&& value) {
+        auto res = this->try_emplace(key, std::forward<T>(value));
+        if (!res.second) {
+            res.first->second = std::forward<T>(value);
+        }
+        return res;
+    }
+
+    size_t erase(int key) {
+        size_t slot = this->findSlot(key);
+        if (slot == NPOS) return 0;
+
+        this->eraseSlot(slot);
+        return 1;
+    }
+
+    /// Erases the entry and returns an iterator to the entry that took its place (or `end()`)
+    iterator erase(const_iterator it) {
+        size_t idx = it - this->cbegin();
+        this->eraseSlot(this->findSlot(it->first));
+        return this->begin() + idx;
+    }
+
+private:
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+    static constexpr size_t MIN_CAPACITY = detail::flatmap::GROUP_SIZE;
+
+    std::vector<value_type> m_entries;
+    std::vector<int8_t> m_ctrl;   // one control byte per slot
+    std::vector<uint32_t> m_slots; // index into m_entries for every full slot
+    size_t m_deleted = 0;
+
+    static uint64_t hashKey(int key) {
+        // fibonacci hashing, account IDs are sequential-ish so they need to be spread out
+        uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 32);
+    }
+
+    static int8_t h2(uint64_t hash) {
+        return static_cast<int8_t>(hash & 0x7f);
+    }
+
+    static size_t h1(uint64_t hash) {
+        return static_cast<size_t>(hash >> 7);
+    }
+
+    // capacity that keeps the load factor at or below 7/8
+    static size_t capacityFor(size_t count) {
+        return std::max(MIN_CAPACITY, std::bit_ceil(count + count / 7 + 1));
+    }
+
+    size_t groupMask() const {
+        return m_ctrl.size() / detail::flatmap::GROUP_SIZE - 1;
+    }
+
+    size_t findSlot(int key) const {
+        using namespace detail::flatmap;
+
+        if (m_entries.empty()) return NPOS;
+
+        uint64_t hash = hashKey(key);
+        int8_t tag = h2(hash);
+        size_t mask = this->groupMask();
+        size_t group = h1(hash) & mask;
+
+        // triangular probing visits every group exactly once, since the group count is a power of two
+        for (size_t probe = 0; probe <= mask; probe++) {
+            size_t base = group * GROUP_SIZE;
+            Group g{m_ctrl.data() + base};
+
+            for (auto m = g.match(tag); m; m.clearLowest()) {
+                size_t slot = base + m.lowest();
+                if (m_entries[m_slots[slot]].first == key) return slot;
+            }
+
+            if (g.matchEmpty()) return NPOS;
+
+            group = (group + probe + 1) & mask;
+        }
+
+        return NPOS;
+    }
+
+    size_t findInsertSlot(uint64_t hash) const {
+        using namespace detail::flatmap;
+
+        size_t mask = this->groupMask();
+        size_t group = h1(hash) & mask;
+
+        // must follow the same probe sequence as findSlot. can't loop forever, growIfNeeded always leaves free slots
+        for (size_t probe = 0;; probe++) {
+            size_t base = group * GROUP_SIZE;
+            Group g{m_ctrl.data() + base};
+
+            if (auto m = g.matchEmptyOrDeleted()) {
+                return base + m.lowest();
+            }
+
+            group = (group + probe + 1) & mask;
+        }
+    }
+
+    void growIfNeeded() {
+        size_t cap = m_ctrl.size();
+        if (cap != 0 && (m_entries.size() + m_deleted + 1) * 8 <= cap * 7) return;
+
+        // if most of the used slots are tombstones, rehashing at the same size is enough to clean them up
+        size_t needed = capacityFor(m_entries.size() + 1);
+        this->rehash(m_deleted >= m_entries.size() && needed <= cap ? cap : std::max(needed, cap * 2));
+    }
+
+    void rehash(size_t capacity) {
+        m_ctrl.assign(capacity, detail::flatmap::CTRL_EMPTY);
+        m_slots.assign(capacity, 0);
+        m_deleted = 0;
+
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            uint64_t hash = hashKey(m_entries[i].first);
+            size_t slot = this->findInsertSlot(hash);
+            m_ctrl[slot] = h2(hash);
+            m_slots[slot] = static_cast<uint32_t>(i);
+        }
+    }
+
+    void eraseSlot(size_t slot) {
+        uint32_t idx = m_slots[slot];
+        uint32_t last = static_cast<uint32_t>(m_entries.size() - 1);
+
+        if (idx != last) {
+            // move the last entry into the hole and repoint its slot
+            size_t lastSlot = this->findSlot(m_entries[last].first);
+            m_entries[idx] = std::move(m_entries[last]);
+            m_slots[lastSlot] = idx;
+        }
+
+        m_entries.pop_back();
+        m_ctrl[slot] = detail::flatmap::CTRL_DELETED;
+        m_deleted++;
+
+        if (m_entries.empty()) {
+            this->clear();
+        }
+    }
+};
+
+}
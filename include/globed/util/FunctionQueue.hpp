@@ -1,6 +1,7 @@
 #pragma once
 
 #include "singleton.hpp"
+#include "InstrumentedLock.hpp"
 
 #include <asp/sync/SpinLock.hpp>
 #include <asp/time/Duration.hpp>
@@ -34,8 +35,8 @@ public:
         }
     };
 
-    asp::SpinLock<std::priority_queue<Queued, std::vector<Queued>, std::greater<Queued>>> m_queue;
-    asp::SpinLock<std::priority_queue<Delayed, std::vector<Delayed>, std::greater<Delayed>>> m_delayedQueue;
+    InstrumentedSpinLock<std::priority_queue<Queued, std::vector<Queued>, std::greater<Queued>>> m_queue{"FunctionQueue::queue"};
+    InstrumentedSpinLock<std::priority_queue<Delayed, std::vector<Delayed>, std::greater<Delayed>>> m_delayedQueue{"FunctionQueue::delayedQueue"};
 
     void queue(Func&& func, size_t frames = 0);
     void queueDelay(Func&& func, asp::time::Duration delay);
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "../config.hpp"
+#include <asp/sync/Mutex.hpp>
+#include <asp/sync/SpinLock.hpp>
+#include <asp/time/Instant.hpp>
+#include <array>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace globed {
+
+/// Wait and hold statistics of a single named lock. Objects are never freed once registered.
+struct GLOBED_DLL LockStats {
+    /// Histogram buckets are powers of two in microseconds: <1us, <2us, <4us, ... and the last one is everything above
+    static constexpr size_t BUCKETS = 16;
+
+    std::string name;
+    std::string waitZoneName;
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> totalWaitNs{0};
+    std::atomic<uint64_t> totalHoldNs{0};
+    std::atomic<uint64_t> maxWaitNs{0};
+    std::atomic<uint64_t> maxHoldNs{0};
+    std::array<std::atomic<uint64_t>, BUCKETS> waitHist{};
+    std::array<std::atomic<uint64_t>, BUCKETS> holdHist{};
+
+    void recordWait(uint64_t ns);
+    void recordHold(uint64_t ns);
+
+    /// Returns the stats for the lock with this name, creating them if needed. Locks with the same name share stats.
+    static LockStats* get(std::string_view name);
+    /// All registered locks
+    static std::vector<LockStats*> all();
+
+    /// Whether locks should measure wait and hold times. Off by default, so that locking costs nothing extra.
+    static bool enabled() {
+        return s_enabled.load(std::memory_order::relaxed);
+    }
+    static void setEnabled(bool enabled);
+
+    /// Describes all locks that have been acquired at least once while measuring, one or more lines per lock
+    static std::string summary();
+
+    /// Formats a histogram as a single line, e.g. "<1us: 500, <2us: 20, <64us: 1"
+    static std::string formatHistogram(const std::array<std::atomic<uint64_t>, BUCKETS>& hist);
+
+private:
+    static inline std::atomic<bool> s_enabled{false};
+};
+
+/// Wrapper around `asp::Mutex` / `asp::SpinLock` that records how long threads wait for and hold the lock.
+/// The API mirrors the wrapped lock, `lock()` returns a guard that derefs to the protected data.
+template <template <typename> class LockT, typename T>
+class InstrumentedLock {
+    using Inner = LockT<T>;
+    using InnerGuard = decltype(std::declval<Inner&>().lock());
+
+public:
+    class Guard {
+    public:
+        Guard(InnerGuard&& guard, LockStats* stats, bool measure)
+            : m_guard(std::move(guard)), m_stats(stats), m_measure(measure) {
+            if (m_measure) m_acquired = asp::time::Instant::now();
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        Guard(Guard&& other) noexcept
+            : m_guard(std::move(other.m_guard)), m_stats(other.m_stats), m_acquired(other.m_acquired),
+              m_measure(std::exchange(other.m_measure, false)), m_held(std::exchange(other.m_held, false)) {}
+
+        Guard& operator=(Guard&& other) noexcept {
+            if (this != &other) {
+                this->finishHold();
+                m_guard = std::move(other.m_guard);
+                m_stats = other.m_stats;
+                m_acquired = other.m_acquired;
+                m_measure = std::exchange(other.m_measure, false);
+                m_held = std::exchange(other.m_held, false);
+            }
+            return *this;
+        }
+
+        ~Guard() {
+            this->finishHold();
+        }
+
+        auto& operator*() { return *m_guard; }
+        auto& operator*() const { return *m_guard; }
+        auto operator->() { return &*m_guard; }
+        auto operator->() const { return &*m_guard; }
+
+        void unlock() {
+            this->finishHold();
+            m_held = false;
+            m_guard.unlock();
+        }
+
+        void relock() {
+            asp::time::Instant start;
+            if (m_measure) start = asp::time::Instant::now();
+            m_guard.relock();
+            m_held = true;
+
+            if (m_measure) {
+                m_acquired = asp::time::Instant::now();
+                m_stats->recordWait(m_acquired.durationSince(start).nanos());
+            }
+        }
+
+    private:
+        InnerGuard m_guard;
+        LockStats* m_stats;
+        asp::time::Instant m_acquired;
+        bool m_measure;
+        bool m_held = true;
+
+        void finishHold() {
+            if (m_measure && m_held) {
+                m_stats->recordHold(m_acquired.elapsed().nanos());
+                m_held = false;
+            }
+        }
+    };
+
+    template <typename... Args>
+    explicit InstrumentedLock(std::string_view name, Args&&... args)
+        : m_inner(std::forward<Args>(args)...), m_stats(LockStats::get(name)) {}
+
+    Guard lock() const {
+        if (!LockStats::enabled()) {
+            return Guard{m_inner.lock(), m_stats, false};
+        }
+
+        auto start = asp::time::Instant::now();
+        auto guard = m_inner.lock();
+        m_stats->recordWait(start.elapsed().nanos());
+
+        return Guard{std::move(guard), m_stats, true};
+    }
+
+private:
+    mutable Inner m_inner;
+    LockStats* m_stats;
+};
+
+template <typename T>
+using InstrumentedMutex = InstrumentedLock<asp::Mutex, T>;
+template <typename T>
+using InstrumentedSpinLock = InstrumentedLock<asp::SpinLock, T>;
+
+}
@@ -2,6 +2,7 @@
 #include <globed/audio/AudioEncoder.hpp>
 
 #include <opus.h>
+#include <algorithm>
 
 using namespace geode::prelude;
 
@@ -47,20 +48,72 @@ AudioDecoder& AudioDecoder::operator=(AudioDecoder&& other) noexcept {
 Result<DecodedOpusData> AudioDecoder::decode(const uint8_t* data, size_t length) {
     DecodedOpusData out;
 
-    out.size = m_frameSize * m_channels;
+    out.size = this->frameSamples();
     out.data = std::make_shared<float[]>(out.size);
 
-    int result = opus_decode_float(m_decoder, data, length, out.data.get(), m_frameSize, 0);
+    GEODE_UNWRAP_INTO(out.size, this->decodeInto(data, length, out.data.get(), out.size));
+
+    return Ok(out);
+}
+
+Result<DecodedOpusData> AudioDecoder::decode(const EncodedOpusData& frame) {
+    return this->decode(frame.data.get(), frame.size);
+}
+
+Result<size_t> AudioDecoder::decodeInto(const uint8_t* data, size_t length, float* out, size_t outSamples) {
+    int result = opus_decode_float(m_decoder, data, length, out, outSamples / m_channels, 0);
 
     if (result < 0) {
         return Err("opus_decode_float failed: {}", AudioDecoder::errorToString(result));
     }
 
-    return Ok(out);
+    return Ok(static_cast<size_t>(result) * m_channels);
 }
 
-Result<DecodedOpusData> AudioDecoder::decode(const EncodedOpusData& frame) {
-    return this->decode(frame.data.get(), frame.size);
+Result<size_t> AudioDecoder::decodeInto(const EncodedOpusData& frame, float* out, size_t outSamples) {
+    return this->decodeInto(frame.data.get(), frame.size, out, outSamples);
+}
+
+Result<size_t> AudioDecoder::recoverInto(const EncodedOpusData& nextFrame, float* out, size_t outSamples) {
+    if (outSamples < this->frameSamples()) {
+        return Err("output buffer is smaller than a frame");
+    }
+
+    // fec data has to be decoded with the exact duration of the lost frame, assume it matches the frame after it
+    int lostSize = std::min<int>(nextFrame.samples(m_sampleRate), m_frameSize);
+    if (lostSize <= 0) lostSize = m_frameSize;
+
+    int result = opus_decode_float(m_decoder, nextFrame.data.get(), nextFrame.size, out, lostSize, 1);
+
+    if (result < 0) {
+        return Err("opus_decode_float (fec) failed: {}", AudioDecoder::errorToString(result));
+    }
+
+    return Ok(static_cast<size_t>(result) * m_channels);
+}
+
+Result<size_t> AudioDecoder::concealInto(float* out, size_t outSamples) {
+    if (outSamples < this->frameSamples()) {
+        return Err("output buffer is smaller than a frame");
+    }
+
+    // conceal as much audio as the last frame had, senders may use frames shorter than `m_frameSize`
+    int lostSize = 0;
+    if (opus_decoder_ctl(m_decoder, OPUS_GET_LAST_PACKET_DURATION(&lostSize)) != OPUS_OK || lostSize <= 0) {
+        lostSize = m_frameSize;
+    }
+
+    int result = opus_decode_float(m_decoder, nullptr, 0, out, std::min(lostSize, m_frameSize), 0);
+
+    if (result < 0) {
+        return Err("opus_decode_float (plc) failed: {}", AudioDecoder::errorToString(result));
+    }
+
+    return Ok(static_cast<size_t>(result) * m_channels);
+}
+
+size_t AudioDecoder::frameSamples() const {
+    return m_frameSize * m_channels;
 }
 
 Result<> AudioDecoder::setSampleRate(int sampleRate) {
@@ -1,11 +1,84 @@
 #include <globed/audio/AudioEncoder.hpp>
 
 #include <opus.h>
+#include <cstring>
 
 using namespace geode::prelude;
 
+// the last bytes of a padded frame are a tag byte and a 24 bit little endian sequence number.
+// only the first frame of each voice packet is padded, the frames after it are numbered consecutively
+constexpr uint8_t SEQUENCE_TAG = 0xa7;
+constexpr size_t SEQUENCE_BYTES = 4;
+constexpr uint32_t SEQUENCE_MASK = 0xffffff;
+// padding a frame also adds a few header bytes, this leaves enough room for the sequence number in all cases
+constexpr size_t SEQUENCE_PAD = 8;
+
 namespace globed {
 
+// Returns the amount of padding bytes at the end of an opus packet. Only code 3 packets can have padding (RFC 6716, 3.2.5)
+static size_t opusPaddingSize(const uint8_t* data, size_t length) {
+    if (length < 2 || (data[0] & 0x3) != 3 || !(data[1] & 0x40)) {
+        return 0;
+    }
+
+    size_t pos = 2;
+    size_t padding = 0;
+
+    while (pos < length) {
+        uint8_t b = data[pos++];
+        padding += b == 255 ? 254 : b;
+        if (b != 255) break;
+    }
+
+    return padding <= length - pos ? padding : 0;
+}
+
+std::optional<uint32_t> EncodedOpusData::sequence() const {
+    if (opusPaddingSize(data.get(), size) < SEQUENCE_BYTES) {
+        return std::nullopt;
+    }
+
+    const uint8_t* p = data.get() + size - SEQUENCE_BYTES;
+    if (p[0] != SEQUENCE_TAG) {
+        return std::nullopt;
+    }
+
+    return static_cast<uint32_t>(p[1] | (p[2] << 8) | (p[3] << 16));
+}
+
+Result<EncodedOpusData> EncodedOpusData::withSequence(uint32_t seq) const {
+    size_t padded = size + SEQUENCE_PAD;
+    auto buf = std::make_unique<uint8_t[]>(padded);
+    std::memcpy(buf.get(), data.get(), size);
+
+    int result = opus_packet_pad(buf.get(), size, padded);
+    if (result != OPUS_OK) {
+        return Err("opus_packet_pad failed: {}", opus_strerror(result));
+    }
+
+    if (opusPaddingSize(buf.get(), padded) < SEQUENCE_BYTES) {
+        return Err("not enough padding for the sequence number");
+    }
+
+    uint8_t* p = buf.get() + padded - SEQUENCE_BYTES;
+    p[0] = SEQUENCE_TAG;
+    p[1] = seq & 0xff;
+    p[2] = (seq >> 8) & 0xff;
+    p[3] = (seq >> 16) & 0xff;
+
+    return Ok(EncodedOpusData { .data = std::move(buf), .size = padded });
+}
+
+size_t EncodedOpusData::samples(int sampleRate) const {
+    int result = opus_packet_get_nb_samples(data.get(), size, sampleRate);
+    return result > 0 ? static_cast<size_t>(result) : 0;
+}
+
+int32_t voiceSequenceDiff(uint32_t a, uint32_t b) {
+    // sign extend the 24 bit difference
+    return static_cast<int32_t>(((a - b) & SEQUENCE_MASK) << 8) >> 8;
+}
+
 AudioEncoder::AudioEncoder(int sampleRate, int frameSize, int channels)
     : m_encoder(nullptr), m_sampleRate(sampleRate), m_frameSize(frameSize), m_channels(channels) {
     (void) this->remakeEncoder().unwrap();
@@ -54,12 +127,23 @@ Result<EncodedOpusData> AudioEncoder::encode(const float* data) {
         return Err("opus_encode_float failed: {}", AudioEncoder::errorToString(result));
     }
 
+    // frames of 2 bytes or less are sent by the encoder while in dtx, opus says that they don't have to be transmitted
+    m_lastDtx = result <= 2;
+
+    // the sequence number is added once per packet by `EncodedAudioFrame`, so the receiver can reorder frames and tell which ones were lost
+    m_lastSequence = m_nextSequence;
+    m_nextSequence = (m_nextSequence + 1) & SEQUENCE_MASK;
+
     out.data = std::move(buf);
     out.size = static_cast<size_t>(result);
 
     return Ok(std::move(out));
 }
 
+uint32_t AudioEncoder::lastSequence() const {
+    return m_lastSequence;
+}
+
 Result<> AudioEncoder::setSampleRate(int sampleRate) {
     m_sampleRate = sampleRate;
     return this->remakeEncoder();
@@ -69,11 +153,28 @@ void AudioEncoder::setFrameSize(int frameSize) {
     m_frameSize = frameSize;
 }
 
+int AudioEncoder::frameSize() const {
+    return m_frameSize;
+}
+
 Result<> AudioEncoder::setChannels(int channels) {
     m_channels = channels;
     return this->remakeEncoder();
 }
 
+Result<> AudioEncoder::setInbandFec(bool enabled, int lossPercent) {
+    GEODE_UNWRAP(this->encoderCtl("setInbandFec", OPUS_SET_INBAND_FEC(enabled ? 1 : 0)));
+    return this->encoderCtl("setPacketLossPerc", OPUS_SET_PACKET_LOSS_PERC(enabled ? lossPercent : 0));
+}
+
+Result<> AudioEncoder::setDtx(bool enabled) {
+    return this->encoderCtl("setDtx", OPUS_SET_DTX(enabled ? 1 : 0));
+}
+
+bool AudioEncoder::lastFrameDtx() const {
+    return m_lastDtx;
+}
+
 Result<> AudioEncoder::resetState() {
     return this->encoderCtl("resetState", OPUS_RESET_STATE);
 }
@@ -109,7 +210,7 @@ Result<> AudioEncoder::remakeEncoder() {
         return Err("opus_encoder_create failed: {}", AudioEncoder::errorToString(err));
     }
 
-    return Ok();
+    return this->setInbandFec(true, 10);
 }
 
 std::string_view AudioEncoder::errorToString(int code) {
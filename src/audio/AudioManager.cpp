@@ -1,8 +1,10 @@
 #include <globed/audio/AudioManager.hpp>
 #include <globed/audio/sound/PlayerSound.hpp>
+#include <globed/audio/VoiceDecodePool.hpp>
 #include <globed/core/SettingsManager.hpp>
 #include <globed/core/game/RemotePlayer.hpp>
 #include <globed/util/format.hpp>
+#include <util/Profiler.hpp>
 
 #ifdef GEODE_IS_WINDOWS
 # include <objbase.h>
@@ -12,7 +14,6 @@
 #include <Geode/utils/permission.hpp>
 #include <arc/future/Select.hpp>
 #include <arc/time/Sleep.hpp>
-#include <arc/time/Interval.hpp>
 
 using namespace geode::prelude;
 using enum std::memory_order;
@@ -31,6 +32,9 @@ static std::string formatFmodError(FMOD_RESULT result, const char* whatFailed) {
 
 namespace globed {
 
+// how far to the side the voice of a player at the edge of proximity range is panned
+constexpr float MAX_VOICE_PAN = 0.7f;
+
 static float proximityVolumeMult(float distance) {
     distance = std::clamp(distance, 0.0f, PROXIMITY_AUDIO_LIMIT);
     float t = distance / PROXIMITY_AUDIO_LIMIT;
@@ -47,6 +51,7 @@ AudioManager::AudioManager()
     m_workerTask.setName("[Globed] Audio worker");
 
     m_recordDevice = AudioRecordingDevice{.id = -1};
+    this->setEncoderSettings({});
 
     m_vcVolume = SettingsManager::get().getAndListenForChanges<float>("core.audio.playback-volume", [this](float value) {
         m_vcVolume = value;
@@ -55,6 +60,11 @@ AudioManager::AudioManager()
     m_sfxVolume = SettingsManager::get().getAndListenForChanges<float>("core.player.quick-chat-sfx-volume", [this](float value) {
         m_sfxVolume = value;
     });
+
+    // only affects streams created after the change, existing ones keep playing the way they started
+    m_useVoiceMixer = SettingsManager::get().getAndListenForChanges<bool>("core.audio.voice-mixer", [this](bool value) {
+        m_useVoiceMixer = value;
+    });
 }
 
 AudioManager::~AudioManager() {
@@ -184,6 +194,50 @@ void AudioManager::setRecordBufferCapacity(size_t frames) {
     m_recordFrame.setCapacity(frames);
 }
 
+void AudioManager::setRecordFrameDuration(int ms) {
+    switch (ms) {
+        case 10: case 20: case 40: case 60: break;
+        default: {
+            log::warn("Invalid voice frame duration {}ms, using 60ms", ms);
+            ms = 60;
+        } break;
+    }
+
+    m_recordFrameMs.store(ms, relaxed);
+}
+
+void AudioManager::setVoiceActivation(bool enabled, int attackMs, int hangoverMs) {
+    m_vadAttackMs.store(attackMs, relaxed);
+    m_vadHangoverMs.store(hangoverMs, relaxed);
+    m_vadEnabled.store(enabled, relaxed);
+}
+
+void AudioManager::setEncoderSettings(const VoiceEncoderSettings& settings) {
+    m_encBitrate.store(settings.bitrate, relaxed);
+    m_encComplexity.store(settings.complexity, relaxed);
+    m_encFecPercent.store(settings.fecLossPercent, relaxed);
+    m_encSettingsChanged.store(true, release);
+}
+
+float AudioManager::sampleEncoderLoad() {
+    // half a second of audio
+    constexpr uint64_t MIN_SAMPLE_NANOS = 500'000'000;
+
+    uint64_t encode = m_encodeNanosTotal.load(relaxed);
+    uint64_t audio = m_encodedAudioNanosTotal.load(relaxed);
+    uint64_t audioDelta = audio - m_loadSampleAudioNanos;
+
+    if (audioDelta < MIN_SAMPLE_NANOS) {
+        return 0.f;
+    }
+
+    float load = static_cast<float>(encode - m_loadSampleEncodeNanos) / audioDelta;
+    m_loadSampleEncodeNanos = encode;
+    m_loadSampleAudioNanos = audio;
+
+    return load;
+}
+
 void AudioManager::startRecording(AudioRecordConfig config) {
     if (auto err = m_threadChan->trySend(std::move(config)).err()) {
         log::error("Failed to start recording: channel closed");
@@ -312,10 +366,16 @@ Result<> AudioManager::mapError(FMOD_RESULT result) {
 }
 
 void AudioManager::stopAllOutputSources() {
+    VoiceDecodePool::get().clearRoutes();
+
     for (auto& src : m_playbackSources) {
         src->stop();
     }
     m_playbackSources.clear();
+
+    if (m_voiceMixer) {
+        m_voiceMixer->stop();
+    }
 }
 
 float AudioManager::calculateVolume(AudioSource& src, const CCPoint& playerPos, bool voiceProximity) {
@@ -368,7 +428,20 @@ float AudioManager::calculateVolume(AudioSource& src, const CCPoint& playerPos,
     return targetVolume;
 }
 
+float AudioManager::calculatePan(AudioSource& src, const CCPoint& playerPos, bool voiceProximity) {
+    if (src.kind() != AudioKind::VoiceChat || !voiceProximity) return 0.f;
+
+    auto pos = src.getPosition();
+    if (!pos) return 0.f;
+
+    // never fully to one side, so players right next to each other don't sound like they're in one ear
+    float offset = std::clamp((pos->x - playerPos.x) / PROXIMITY_AUDIO_LIMIT, -1.f, 1.f);
+    return offset * MAX_VOICE_PAN;
+}
+
 void AudioManager::updatePlayback(CCPoint playerPos, bool voiceProximity) {
+    GLOBED_PROFILE_FUNCTION();
+
     m_lastPos = playerPos;
     m_lastProximity = voiceProximity;
 
@@ -382,6 +455,7 @@ void AudioManager::updatePlayback(CCPoint playerPos, bool voiceProximity) {
 
         float tvol = this->calculateVolume(*src, playerPos, voiceProximity);
         src->rawSetVolume(tvol);
+        src->rawSetPan(this->calculatePan(*src, playerPos, voiceProximity));
         src->onUpdate();
 
         ++it;
@@ -396,8 +470,23 @@ void AudioManager::registerPlaybackSource(std::shared_ptr<AudioSource> source) {
     m_playbackSources.insert(source);
 }
 
+VoiceMixer* AudioManager::getVoiceMixer() {
+    if (!m_useVoiceMixer) return nullptr;
+
+    if (!m_voiceMixer) {
+        m_voiceMixer = std::make_unique<VoiceMixer>(this->getSystem());
+    }
+
+    return m_voiceMixer.get();
+}
+
 void AudioManager::setDeafen(bool deafen) {
     m_deafen = deafen;
+
+    // incoming voice has to go through the main thread again, where it gets dropped while deafened
+    if (deafen) {
+        VoiceDecodePool::get().clearRoutes();
+    }
 }
 
 bool AudioManager::getDeafen() {
@@ -419,10 +508,6 @@ int AudioManager::getFocusedPlayer() {
 // Thread stuff
 
 arc::Future<> AudioManager::threadFunc(arc::mpsc::Receiver<AudioThreadMessage> rx) {
-    // wake up every 3ms if recording audio
-    auto recordInterval = arc::interval(asp::Duration::fromMillis(3));
-    recordInterval.setMissedTickBehavior(arc::MissedTickBehavior::Skip);
-
     while (true) {
         bool recording = m_recordActive.load(relaxed);
 
@@ -435,8 +520,10 @@ arc::Future<> AudioManager::threadFunc(arc::mpsc::Receiver<AudioThreadMessage> r
                 }
             ),
 
-            arc::selectee(recordInterval.tick(), [&] {
+            // while recording, wake up when the next frame should be ready (see threadScheduleRecordPoll)
+            arc::selectee(arc::sleepUntil(m_recordNextPoll), [&] {
                 auto result = this->threadProcessMicrophone();
+                this->threadScheduleRecordPoll();
 
                 if (!result) {
                     log::warn("audioThreadWork failed: {}", result.unwrapErr());
@@ -516,7 +603,21 @@ Result<> AudioManager::threadStartRecording() {
 
     FMOD_ERRC(res, "FMOD::System::recordStart");
 
+    int frameMs = m_recordFrameMs.load(relaxed);
+    m_encoder.setFrameSize(VOICE_TARGET_SAMPLERATE * frameMs / 1000);
+    m_recordFrame.clear();
+    m_recordStats = {};
+
+    m_recordVad = m_vadEnabled.load(relaxed);
+    int attackMs = std::max<int>(m_vadAttackMs.load(relaxed), VoiceActivityDetector::BLOCK_MS);
+    m_vad.reset();
+    m_vad.setTimings(attackMs, m_vadHangoverMs.load(relaxed));
+    m_recordPreroll.clear();
+    m_recordPrerollFrames = (attackMs + frameMs - 1) / frameMs;
+    GEODE_UNWRAP(m_encoder.setDtx(m_recordVad));
+
     m_recordLastPosition = 0;
+    m_recordNextPoll = asp::Instant::now();
     m_recordActive.store(true, relaxed);
 
     return Ok();
@@ -543,6 +644,8 @@ void AudioManager::threadStopRecording(bool halt, bool ignoreErrors) {
         this->threadInvokeMicCallback();
     }
 
+    this->threadLogRecordStats();
+
     // cleanup
     m_callback = [](const auto&){};
     m_rawCallback = [](const auto*, auto) {};
@@ -591,13 +694,13 @@ Result<> AudioManager::threadProcessMicrophone() {
     bool notRecording = m_recordingPassive.load(relaxed) && !m_recordingPassiveActive.load(relaxed);
     if (!notRecording) {
         if (pos > m_recordLastPosition) {
-            m_recordQueue.writeData(pcmData + m_recordLastPosition, pos - m_recordLastPosition);
+            m_recordQueue.write(pcmData + m_recordLastPosition, pos - m_recordLastPosition);
         } else if (pos < m_recordLastPosition) { // we reached the end of the buffer
             // write the data left at the end
-            m_recordQueue.writeData(pcmData + m_recordLastPosition, pcmLen / sizeof(float) - m_recordLastPosition);
+            m_recordQueue.write(pcmData + m_recordLastPosition, pcmLen / sizeof(float) - m_recordLastPosition);
 
             // write the data at the start of the buffer
-            m_recordQueue.writeData(pcmData, pos);
+            m_recordQueue.write(pcmData, pos);
         }
     }
 
@@ -606,33 +709,93 @@ Result<> AudioManager::threadProcessMicrophone() {
     bool recordingRaw = m_rawCallback != nullptr;
 
     if (recordingRaw) {
-        size_t samples = m_recordQueue.size();
-
-        // raw recording, call the raw callback with the pcm data directly.
-        if (auto pcm = m_recordQueue.contiguousData()) {
-            this->threadInvokeRawCallback(*pcm, samples);
-        } else {
-            auto pcmdata = std::make_unique<float[]>(samples);
-            m_recordQueue.readData(pcmdata.get(), samples);
-            this->threadInvokeRawCallback(pcmdata.get(), samples);
+        // raw recording, call the raw callback with the pcm data directly, in up to two parts if the data wraps around
+        auto pcm = m_recordQueue.readSpans();
+        if (!pcm.first.empty()) {
+            this->threadInvokeRawCallback(pcm.first.data(), pcm.first.size());
+        }
+        if (!pcm.second.empty()) {
+            this->threadInvokeRawCallback(pcm.second.data(), pcm.second.size());
         }
 
         m_recordQueue.clear();
     } else {
-        // encoded recording, encode the data and push to the frame.
-        if (m_recordQueue.size() >= VOICE_TARGET_FRAMESIZE || notRecording) {
-            float pcmbuf[VOICE_TARGET_FRAMESIZE];
-            size_t filled = m_recordQueue.readData(pcmbuf, VOICE_TARGET_FRAMESIZE);
-
-            if (filled < VOICE_TARGET_FRAMESIZE) {
-                // simply discard data
-            } else {
-                GEODE_UNWRAP_INTO(auto opusFrame, m_encoder.encode(pcmbuf));
-                GEODE_UNWRAP(m_recordFrame.pushOpusFrame(opusFrame));
+        // encoded recording, encode every complete frame and push to the frame.
+        // in low latency mode each opus frame is sent on its own, rather than waiting for the buffer to fill up
+        size_t frameSize = m_encoder.frameSize();
+        bool lowLatency = frameSize < VOICE_TARGET_FRAMESIZE;
+        float pcmbuf[VOICE_TARGET_FRAMESIZE];
+
+        if (m_encSettingsChanged.exchange(false, acquire)) {
+            GEODE_UNWRAP(m_encoder.setBitrate(m_encBitrate.load(relaxed)));
+            GEODE_UNWRAP(m_encoder.setComplexity(m_encComplexity.load(relaxed)));
+            GEODE_UNWRAP(m_encoder.setInbandFec(true, m_encFecPercent.load(relaxed)));
+        }
+
+        auto pushFrame = [&](const EncodedOpusData& frame, uint32_t seq) -> Result<> {
+            // frames in a packet are numbered from the first one, so a gap has to start a new packet
+            auto next = m_recordFrame.nextSequence();
+            if (next && *next != seq) {
+                this->threadInvokeMicCallback();
+                m_recordFrame.clear();
+            }
+
+            GEODE_UNWRAP(m_recordFrame.pushOpusFrame(frame, seq));
+            m_recordStats.bytes += m_recordFrame.getFrames().back().size;
+
+            if (lowLatency || m_recordFrame.size() >= m_recordFrame.capacity()) {
+                this->threadInvokeMicCallback();
+                m_recordFrame.clear();
+            }
+
+            return Ok();
+        };
+
+        while (m_recordQueue.size() >= frameSize) {
+            m_recordQueue.read(pcmbuf, frameSize);
+
+            auto start = asp::Instant::now();
+            bool speech = !m_recordVad || m_vad.process(pcmbuf, frameSize);
+            // silent frames are still encoded, so that the encoder state stays continuous and sequence numbers account for the gap
+            GEODE_UNWRAP_INTO(auto opusFrame, m_encoder.encode(pcmbuf));
+            uint64_t encodeNanos = start.elapsed().nanos();
+            m_recordStats.encodeNanos += encodeNanos;
+            m_recordStats.frames++;
+            m_encodeNanosTotal.fetch_add(encodeNanos, relaxed);
+            m_encodedAudioNanosTotal.fetch_add(frameSize * 1'000'000'000ull / VOICE_TARGET_SAMPLERATE, relaxed);
+
+            if (!speech || m_encoder.lastFrameDtx()) {
+                m_recordStats.silentFrames++;
+
+                // don't hold back the end of the speech until the buffer fills up again
+                this->threadInvokeMicCallback();
+                m_recordFrame.clear();
+
+                if (!speech && m_recordPrerollFrames > 0) {
+                    if (m_recordPreroll.size() == m_recordPrerollFrames) {
+                        m_recordPreroll.erase(m_recordPreroll.begin());
+                    }
+
+                    m_recordPreroll.emplace_back(std::move(opusFrame), m_encoder.lastSequence());
+                }
+
+                continue;
             }
+
+            for (auto& [frame, seq] : m_recordPreroll) {
+                m_recordStats.silentFrames--;
+                GEODE_UNWRAP(pushFrame(frame, seq));
+            }
+            m_recordPreroll.clear();
+
+            GEODE_UNWRAP(pushFrame(opusFrame, m_encoder.lastSequence()));
         }
 
-        if (m_recordFrame.size() >= m_recordFrame.capacity() || notRecording) {
+        if (notRecording) {
+            // simply discard the incomplete frame
+            m_recordQueue.clear();
+            m_recordPreroll.clear();
+
             this->threadInvokeMicCallback();
             m_recordFrame.clear();
         }
@@ -641,9 +804,47 @@ Result<> AudioManager::threadProcessMicrophone() {
     return Ok();
 }
 
+void AudioManager::threadScheduleRecordPoll() {
+    // raw recording wants the samples as soon as fmod has them
+    size_t waitMs = 3;
+
+    if (!m_rawCallback) {
+        // the record position tells how much audio is still missing from the next frame, sleep about that long.
+        // fmod advances the position in device sized blocks, so this is clamped to poll often once the frame is nearly done
+        size_t frameSize = m_encoder.frameSize();
+        size_t queued = m_recordQueue.size();
+        size_t missing = queued < frameSize ? frameSize - queued : 0;
+
+        waitMs = std::clamp<size_t>(missing * 1000 / VOICE_TARGET_SAMPLERATE, 1, 20);
+    }
+
+    m_recordNextPoll = asp::Instant::now() + asp::Duration::fromMillis(waitMs);
+}
+
+void AudioManager::threadLogRecordStats() {
+    auto& stats = m_recordStats;
+    if (stats.frames == 0) return;
+
+    // everything is per second of recorded audio, so that frame durations can be compared directly.
+    // each packet additionally costs the transport headers, which is why shorter frames use more bandwidth than the opus payload suggests
+    size_t frameMs = m_encoder.frameSize() * 1000 / VOICE_TARGET_SAMPLERATE;
+    double seconds = stats.frames * frameMs / 1000.0;
+
+    uint64_t sent = stats.frames - stats.silentFrames;
+
+    log::debug(
+        "Voice recording stopped: {} frames of {}ms, {} not sent as silence ({:.0f}%), {} packets. "
+        "Opus payload {:.1f} kbps ({:.1f} bytes/frame), {:.1f} packets/s, encoding took {:.1f}us/frame ({:.2f}% of one core)",
+        stats.frames, frameMs, stats.silentFrames, stats.silentFrames * 100.0 / stats.frames, stats.packets,
+        stats.bytes * 8 / seconds / 1000.0, sent ? stats.bytes / (double)sent : 0.0, stats.packets / seconds,
+        stats.encodeNanos / 1000.0 / stats.frames, stats.encodeNanos / 1e9 / seconds * 100.0
+    );
+}
+
 void AudioManager::threadInvokeMicCallback() {
     if (m_recordFrame.size() == 0) return;
 
+    m_recordStats.packets++;
     if (m_callback) m_callback(m_recordFrame);
 }
 
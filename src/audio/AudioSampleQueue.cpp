@@ -5,46 +5,57 @@ using namespace geode::prelude;
 namespace globed {
 
 void AudioSampleQueue::writeData(const float* data, size_t num) {
+    this->compact();
     m_queue.insert(m_queue.end(), data, data + num);
 
-    if (m_limit != 0 && m_queue.size() > m_limit) {
-        size_t excess = m_queue.size() - m_limit;
-        m_queue.erase(m_queue.begin(), m_queue.begin() + excess);
+    if (m_limit != 0 && this->size() > m_limit) {
+        m_start += this->size() - m_limit;
     }
 }
 
 size_t AudioSampleQueue::readData(float* out, size_t max) {
-    size_t toRead = std::min(max, m_queue.size());
+    size_t toRead = std::min(max, this->size());
     if (out) {
         this->peekData(out, toRead);
     }
-    m_queue.erase(m_queue.begin(), m_queue.begin() + toRead);
+    m_start += toRead;
+
+    if (m_start == m_queue.size()) {
+        this->clear();
+    }
+
     return toRead;
 }
 
 size_t AudioSampleQueue::peekData(float* out, size_t max) const {
-    size_t toRead = std::min(max, m_queue.size());
-    std::copy(m_queue.begin(), m_queue.begin() + toRead, out);
+    size_t toRead = std::min(max, this->size());
+    std::copy(m_queue.begin() + m_start, m_queue.begin() + m_start + toRead, out);
     return toRead;
 }
 
 size_t AudioSampleQueue::size() const {
-    return m_queue.size();
+    return m_queue.size() - m_start;
 }
 
 void AudioSampleQueue::clear() {
     m_queue.clear();
+    m_start = 0;
 }
 
 std::optional<const float*> AudioSampleQueue::contiguousData() const {
-    auto begin = &*m_queue.begin();
-    auto end = &*m_queue.end();
-
-    return end >= begin ? std::optional<const float*>{begin} : std::nullopt;
+    return m_queue.data() + m_start;
 }
 
 void AudioSampleQueue::setLimit(size_t limit) {
     m_limit = limit;
 }
 
-}
\ No newline at end of file
+void AudioSampleQueue::compact() {
+    // only move the remaining samples once the consumed ones take up at least half the buffer, so this is amortized O(1)
+    if (m_start != 0 && m_start >= m_queue.size() / 2) {
+        m_queue.erase(m_queue.begin(), m_queue.begin() + m_start);
+        m_start = 0;
+    }
+}
+
+}
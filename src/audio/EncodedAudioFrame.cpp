@@ -21,6 +21,32 @@ Result<> EncodedAudioFrame::pushOpusFrame(const EncodedOpusData& frame) {
     return Ok();
 }
 
+Result<> EncodedAudioFrame::pushOpusFrame(const EncodedOpusData& frame, uint32_t sequence) {
+    if (m_frames.empty()) {
+        GEODE_UNWRAP_INTO(auto header, frame.withSequence(sequence));
+        return this->pushOpusFrame(header);
+    }
+
+    if (this->nextSequence() != sequence) {
+        return Err("frame {} does not follow the previous frame in the packet", sequence);
+    }
+
+    return this->pushOpusFrame(frame);
+}
+
+std::optional<uint32_t> EncodedAudioFrame::firstSequence() const {
+    if (m_frames.empty()) return std::nullopt;
+
+    return m_frames.front().sequence();
+}
+
+std::optional<uint32_t> EncodedAudioFrame::nextSequence() const {
+    auto first = this->firstSequence();
+    if (!first) return std::nullopt;
+
+    return (*first + m_frames.size()) & 0xffffff;
+}
+
 void EncodedAudioFrame::setCapacity(size_t frames) {
     m_capacity = frames;
 }
@@ -0,0 +1,151 @@
+#include <globed/audio/SfxCache.hpp>
+#include <globed/audio/AudioManager.hpp>
+
+using namespace geode::prelude;
+
+namespace globed {
+
+SfxSample::SfxSample(FMOD::Sound* sound) : m_sound(sound) {}
+
+SfxSample::~SfxSample() {
+    if (m_sound) {
+        m_sound->release();
+    }
+}
+
+FMOD::Sound* SfxSample::sound() const {
+    return m_sound;
+}
+
+static FMOD_OPENSTATE openState(FMOD::Sound* sound) {
+    FMOD_OPENSTATE ostate;
+    unsigned int percent;
+    bool starving, busy;
+
+    if (FMOD_OK != sound->getOpenState(&ostate, &percent, &starving, &busy)) {
+        return FMOD_OPENSTATE_ERROR;
+    }
+
+    return ostate;
+}
+
+bool SfxSample::isLoaded() const {
+    auto state = openState(m_sound);
+    return state == FMOD_OPENSTATE_READY || state == FMOD_OPENSTATE_ERROR;
+}
+
+bool SfxSample::failed() const {
+    return openState(m_sound) == FMOD_OPENSTATE_ERROR;
+}
+
+size_t SfxSample::memoryUsage() const {
+    if (openState(m_sound) != FMOD_OPENSTATE_READY) return 0;
+
+    unsigned int bytes = 0;
+    m_sound->getLength(&bytes, FMOD_TIMEUNIT_PCMBYTES);
+    return bytes;
+}
+
+float SfxCache::Stats::hitRate() const {
+    size_t total = hits + misses;
+    return total ? static_cast<float>(hits) / total : 0.f;
+}
+
+Result<std::shared_ptr<SfxSample>> SfxCache::get(uint32_t id, const std::string& path) {
+    this->trim();
+
+    auto it = m_entries.find(id);
+    if (it != m_entries.end()) {
+        m_hits++;
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+        return Ok(it->second.sample);
+    }
+
+    m_misses++;
+    return this->load(id, path);
+}
+
+void SfxCache::warm(uint32_t id, const std::string& path) {
+    if (m_entries.contains(id)) return;
+
+    if (auto err = this->load(id, path).err()) {
+        log::warn("Failed to preload sfx {} ({}): {}", id, path, *err);
+    }
+}
+
+Result<std::shared_ptr<SfxSample>> SfxCache::load(uint32_t id, const std::string& path) {
+    FMOD::Sound* sound = nullptr;
+
+    // decoded into memory on fmod's loading thread
+    GEODE_UNWRAP(AudioManager::get().mapError(AudioManager::get().getSystem()->createSound(
+        path.c_str(),
+        FMOD_DEFAULT | FMOD_CREATESAMPLE | FMOD_NONBLOCKING,
+        nullptr,
+        &sound
+    )));
+
+    auto sample = std::make_shared<SfxSample>(sound);
+
+    m_lru.push_front(id);
+    m_entries.emplace(id, Entry{sample, m_lru.begin()});
+
+    return Ok(sample);
+}
+
+void SfxCache::trim() {
+    size_t usage = 0;
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+        if (it->second.sample->failed()) {
+            m_lru.erase(it->second.lruPos);
+            it = m_entries.erase(it);
+            continue;
+        }
+
+        usage += it->second.sample->memoryUsage();
+        ++it;
+    }
+
+    // evict from the back, but never the most recently used one, so a single big sample can still be cached.
+    // samples that are currently playing stay alive until their sounds stop.
+    // samples that are still loading are skipped, releasing those blocks until fmod finishes loading them
+    auto pos = m_lru.end();
+    while (usage > m_memoryLimit && m_lru.size() > 1 && std::prev(pos) != m_lru.begin()) {
+        --pos;
+
+        auto it = m_entries.find(*pos);
+        if (!it->second.sample->isLoaded()) continue;
+
+        usage -= std::min(usage, it->second.sample->memoryUsage());
+        pos = m_lru.erase(pos);
+        m_entries.erase(it);
+        m_evictions++;
+    }
+}
+
+void SfxCache::setMemoryLimit(size_t bytes) {
+    m_memoryLimit = bytes;
+    this->trim();
+}
+
+void SfxCache::clear() {
+    m_entries.clear();
+    m_lru.clear();
+}
+
+SfxCache::Stats SfxCache::stats() const {
+    Stats stats {
+        .hits = m_hits,
+        .misses = m_misses,
+        .evictions = m_evictions,
+        .entries = m_entries.size(),
+    };
+
+    for (auto& [_, entry] : m_entries) {
+        stats.memoryUsage += entry.sample->memoryUsage();
+    }
+
+    return stats;
+}
+
+}
@@ -0,0 +1,166 @@
+#include <globed/audio/VoiceActivityDetector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+// blocks quieter than this (about -70 dBFS) are never speech
+constexpr double MIN_BLOCK_ENERGY = 1e-7;
+// speech band energy has to be this far above the noise floor (4 dB)
+constexpr float SPEECH_SNR = 2.5f;
+// at least this much of the energy has to be in the speech band, white noise has about 25% at 24kHz, voiced speech well over 60%
+constexpr float SPEECH_BAND_RATIO = 0.4f;
+// very loud blocks (15 dB over the floor) only need a bit of speech band energy, so that fricatives ("s", "f") aren't lost
+constexpr float LOUD_SNR = 30.f;
+constexpr float LOUD_BAND_RATIO = 0.15f;
+// the noise floor follows quieter blocks quickly and creeps up otherwise, about 2 dB per second,
+// or much faster during the first half second, while it settles on the actual background noise
+constexpr float FLOOR_FALL = 0.2f;
+constexpr float FLOOR_RISE = 1.005f;
+constexpr float FLOOR_RISE_INITIAL = 1.1f;
+constexpr size_t INITIAL_BLOCKS = 50;
+constexpr float INITIAL_FLOOR = 1e-6f;
+constexpr float MIN_FLOOR = 1e-9f;
+
+constexpr float SPEECH_BAND_LOW = 300.f;
+constexpr float SPEECH_BAND_HIGH = 3400.f;
+
+namespace globed {
+
+float VoiceActivityDetector::Biquad::process(float in) {
+    // transposed direct form II
+    float out = b0 * in + z1;
+    z1 = b1 * in - a1 * out + z2;
+    z2 = b2 * in - a2 * out;
+    return out;
+}
+
+// second order butterworth filters, from the RBJ audio eq cookbook
+static void makeFilter(auto& filter, float cutoff, int sampleRate, bool highpass) {
+    float w0 = 2.f * std::numbers::pi_v<float> * cutoff / sampleRate;
+    float cosw = std::cos(w0);
+    float alpha = std::sin(w0) / std::numbers::sqrt2_v<float>; // q = 1/sqrt(2)
+    float a0 = 1.f + alpha;
+
+    float b = highpass ? (1.f + cosw) / 2.f : (1.f - cosw) / 2.f;
+    filter.b0 = b / a0;
+    filter.b1 = (highpass ? -2.f * b : 2.f * b) / a0;
+    filter.b2 = b / a0;
+    filter.a1 = -2.f * cosw / a0;
+    filter.a2 = (1.f - alpha) / a0;
+}
+
+static void trackFloor(float& floor, float energy, float rise) {
+    if (energy < floor) {
+        floor += (energy - floor) * FLOOR_FALL;
+    } else {
+        floor = std::min(floor * rise, energy);
+    }
+
+    floor = std::max(floor, MIN_FLOOR);
+}
+
+VoiceActivityDetector::VoiceActivityDetector(int sampleRate, int attackMs, int hangoverMs)
+    : m_sampleRate(sampleRate), m_blockSize(std::max<size_t>(sampleRate * BLOCK_MS / 1000, 1)), m_noiseFloor(INITIAL_FLOOR), m_totalNoiseFloor(INITIAL_FLOOR)
+{
+    if (sampleRate > 0) {
+        makeFilter(m_highpass, SPEECH_BAND_LOW, sampleRate, true);
+        makeFilter(m_lowpass, std::min(SPEECH_BAND_HIGH, sampleRate * 0.45f), sampleRate, false);
+    }
+
+    this->setTimings(attackMs, hangoverMs);
+}
+
+bool VoiceActivityDetector::process(const float* pcm, size_t samples) {
+    bool active = m_active;
+
+    for (size_t i = 0; i < samples; i++) {
+        float s = pcm[i];
+        float band = m_lowpass.process(m_highpass.process(s));
+
+        m_blockEnergy += s * s;
+        m_blockBandEnergy += band * band;
+
+        if (++m_blockFill == m_blockSize) {
+            this->finishBlock();
+            active = active || m_active;
+        }
+    }
+
+    return active;
+}
+
+void VoiceActivityDetector::finishBlock() {
+    float energy = m_blockEnergy / m_blockSize;
+    float bandEnergy = m_blockBandEnergy / m_blockSize;
+
+    m_blockFill = 0;
+    m_blockEnergy = 0.0;
+    m_blockBandEnergy = 0.0;
+
+    // the band ratio is taken from the energy above the noise floors, so that loud background noise doesn't drown out the speech in it
+    float snr = bandEnergy / m_noiseFloor;
+    float excess = energy - m_totalNoiseFloor;
+    float ratio = excess > 0.f ? std::max(bandEnergy - m_noiseFloor, 0.f) / excess : 0.f;
+
+    bool speech = energy > MIN_BLOCK_ENERGY && (
+        (snr > SPEECH_SNR && ratio > SPEECH_BAND_RATIO)
+        || (snr > LOUD_SNR && ratio > LOUD_BAND_RATIO)
+    );
+
+    float rise = m_blocksSeen < INITIAL_BLOCKS ? FLOOR_RISE_INITIAL : FLOOR_RISE;
+    trackFloor(m_noiseFloor, bandEnergy, rise);
+    trackFloor(m_totalNoiseFloor, energy, rise);
+    m_blocksSeen++;
+
+    m_lastSpeech = speech;
+
+    if (speech) {
+        m_speechRun++;
+
+        if (m_speechRun >= m_attackBlocks) {
+            m_active = true;
+            m_hangoverLeft = m_hangoverBlocks;
+        }
+    } else {
+        m_speechRun = 0;
+
+        if (m_hangoverLeft > 0) {
+            m_hangoverLeft--;
+        } else {
+            m_active = false;
+        }
+    }
+}
+
+bool VoiceActivityDetector::isActive() const {
+    return m_active;
+}
+
+bool VoiceActivityDetector::lastBlockSpeech() const {
+    return m_lastSpeech;
+}
+
+void VoiceActivityDetector::setTimings(int attackMs, int hangoverMs) {
+    m_attackBlocks = std::max<size_t>(std::max(attackMs, 0) / BLOCK_MS, 1);
+    m_hangoverBlocks = std::max(hangoverMs, 0) / BLOCK_MS;
+}
+
+void VoiceActivityDetector::reset() {
+    m_highpass.z1 = m_highpass.z2 = 0.f;
+    m_lowpass.z1 = m_lowpass.z2 = 0.f;
+
+    m_blockFill = 0;
+    m_blockEnergy = 0.0;
+    m_blockBandEnergy = 0.0;
+
+    m_noiseFloor = INITIAL_FLOOR;
+    m_totalNoiseFloor = INITIAL_FLOOR;
+    m_blocksSeen = 0;
+    m_speechRun = 0;
+    m_hangoverLeft = 0;
+    m_active = false;
+    m_lastSpeech = false;
+}
+
+}
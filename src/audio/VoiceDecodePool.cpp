@@ -0,0 +1,120 @@
+#include <globed/audio/VoiceDecodePool.hpp>
+#include <globed/audio/sound/VoiceStream.hpp>
+
+#include <arc/future/Select.hpp>
+#include <arc/time/Interval.hpp>
+
+using namespace geode::prelude;
+
+// decoding one frame takes well under a millisecond, two workers keep up with far more speakers than a room will have
+constexpr size_t DECODE_WORKERS = 2;
+// frames waiting per worker, at 60ms per frame this is several seconds of audio from a full room
+constexpr size_t WORKER_QUEUE_SIZE = 256;
+// how often streams with frames held in their jitter buffer are checked, so lost frames get concealed in time
+constexpr auto JITTER_PUMP_INTERVAL = asp::Duration::fromMillis(10);
+
+namespace globed {
+
+VoiceDecodePool::VoiceDecodePool() {
+    for (size_t i = 0; i < DECODE_WORKERS; i++) {
+        auto [tx, rx] = arc::mpsc::channel<Job>(WORKER_QUEUE_SIZE);
+        m_workers.push_back(std::move(tx));
+
+        auto task = async::spawn(this->workerFunc(std::move(rx)));
+        task.setName("[Globed] Voice decoder");
+        m_tasks.push_back(std::move(task));
+    }
+}
+
+void VoiceDecodePool::submit(int accountId, std::shared_ptr<VoiceStream> stream, EncodedAudioFrame frame) {
+    auto& worker = m_workers[static_cast<uint32_t>(accountId) % m_workers.size()];
+
+    if (auto err = worker.trySend(Job{std::move(stream), std::move(frame), accountId}).err()) {
+        log::warn("Voice decode queue is full, dropping a frame from {}", accountId);
+    }
+}
+
+bool VoiceDecodePool::submitRouted(int accountId, EncodedAudioFrame& frame) {
+    std::shared_ptr<VoiceStream> stream;
+
+    {
+        auto routes = m_routes.lock();
+        auto it = routes->find(accountId);
+        if (it == routes->end()) return false;
+
+        stream = it->second.lock();
+        if (!stream) {
+            routes->erase(it);
+            return false;
+        }
+    }
+
+    this->submit(accountId, std::move(stream), std::move(frame));
+    return true;
+}
+
+void VoiceDecodePool::addRoute(int accountId, const std::shared_ptr<VoiceStream>& stream) {
+    m_routes.lock()->insert_or_assign(accountId, std::weak_ptr{stream});
+}
+
+void VoiceDecodePool::removeRoute(int accountId) {
+    m_routes.lock()->erase(accountId);
+}
+
+void VoiceDecodePool::clearRoutes() {
+    m_routes.lock()->clear();
+}
+
+arc::Future<> VoiceDecodePool::workerFunc(arc::mpsc::Receiver<Job> rx) {
+    auto pumpInterval = arc::interval(JITTER_PUMP_INTERVAL);
+    pumpInterval.setMissedTickBehavior(arc::MissedTickBehavior::Skip);
+
+    // streams that are waiting on late frames
+    std::vector<std::shared_ptr<VoiceStream>> waiting;
+
+    while (true) {
+        std::optional<Job> job;
+        bool pump = false;
+
+        co_await arc::select(
+            arc::selectee(
+                rx.recv(),
+                [&](auto res) {
+                    if (res) job = std::move(res).unwrap();
+                }
+            ),
+
+            arc::selectee(pumpInterval.tick(), [&] {
+                pump = true;
+            }, !waiting.empty())
+        );
+
+        // opus decoding is synchronous, run it on a blocking thread so it never stalls the async executor.
+        // the worker waits for it to finish, so frames from one account are still decoded in order by one thread at a time
+        if (job) {
+            co_await arc::spawnBlocking<void>([&] {
+                if (auto err = job->stream->writeData(job->frame).err()) {
+                    log::warn("Failed to play voice data for player {}: {}", job->accountId, *err);
+                }
+            });
+
+            if (job->stream->hasHeldFrames() && std::find(waiting.begin(), waiting.end(), job->stream) == waiting.end()) {
+                waiting.push_back(std::move(job->stream));
+            }
+        }
+
+        if (pump) {
+            co_await arc::spawnBlocking<void>([&] {
+                for (auto& stream : waiting) {
+                    if (auto err = stream->pump().err()) {
+                        log::warn("Failed to play voice data: {}", *err);
+                    }
+                }
+            });
+
+            std::erase_if(waiting, [](auto& stream) { return !stream->hasHeldFrames(); });
+        }
+    }
+}
+
+}
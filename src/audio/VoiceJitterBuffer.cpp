@@ -0,0 +1,202 @@
+#include <globed/audio/VoiceJitterBuffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace asp::time;
+using enum std::memory_order;
+
+// jitter assumed before any packets were measured
+constexpr float INITIAL_JITTER = 0.02f;
+constexpr float MIN_TARGET_DELAY = 0.02f;
+constexpr float MAX_TARGET_DELAY = 0.3f;
+// packets further apart than this (beyond their expected spacing) are from separate talk spurts and don't count as jitter
+constexpr float MAX_JITTER_SAMPLE = 0.5f;
+// frames older than this many sequence numbers mean that the sender restarted its counter
+constexpr int32_t RESYNC_DISTANCE = 256;
+
+namespace globed {
+
+VoiceJitterBuffer::VoiceJitterBuffer(int sampleRate, float frameSecs)
+    : m_sampleRate(sampleRate), m_frameSecs(frameSecs), m_jitter(INITIAL_JITTER) {}
+
+bool VoiceJitterBuffer::push(const EncodedAudioFrame& packet, Instant now) {
+    auto& frames = packet.getFrames();
+    if (frames.empty()) return true;
+
+    auto firstSeq = packet.firstSequence();
+    if (!firstSeq) return false;
+
+    // interarrival jitter like in RFC 3550, measured per packet since all frames in a packet arrive at once
+    if (m_hasLastPacket) {
+        int32_t seqDelta = voiceSequenceDiff(*firstSeq, m_lastPacketSeq);
+
+        if (seqDelta > 0) {
+            float expected = seqDelta * m_frameSecs;
+            float deviation = std::abs(now.durationSince(m_lastPacketArrival).seconds<float>() - expected);
+
+            if (deviation < MAX_JITTER_SAMPLE) {
+                m_jitter += (deviation - m_jitter) / 16.f;
+                m_stats.jitterMicros.store(m_jitter * 1'000'000.f, relaxed);
+            }
+        }
+    }
+
+    if (!m_hasLastPacket || voiceSequenceDiff(*firstSeq, m_lastPacketSeq) > 0) {
+        m_lastPacketSeq = *firstSeq;
+        m_lastPacketArrival = now;
+        m_hasLastPacket = true;
+
+        // the sender can change its frame duration at any time (low latency mode), the spacing above was for the previous frames
+        if (size_t samples = frames.front().samples(m_sampleRate)) {
+            m_frameSecs = static_cast<float>(samples) / m_sampleRate;
+        }
+    }
+
+    // only the first frame carries a sequence number, the rest follow it
+    for (size_t i = 0; i < frames.size(); i++) {
+        this->insert(frames[i], (*firstSeq + i) & 0xffffff, now);
+    }
+
+    return true;
+}
+
+void VoiceJitterBuffer::insert(const EncodedOpusData& frame, uint32_t seq, Instant now) {
+    if (!m_started) {
+        m_nextSeq = seq;
+        m_started = true;
+    }
+
+    int32_t diff = voiceSequenceDiff(seq, m_nextSeq);
+
+    if (diff < 0) {
+        if (diff > -RESYNC_DISTANCE) {
+            // this frame was already concealed
+            m_stats.late.fetch_add(1, relaxed);
+            return;
+        }
+
+        this->reset(seq);
+    } else if (diff >= static_cast<int32_t>(SLOTS)) {
+        // too far ahead to hold on to the frames in between, give up on them
+        this->reset(seq);
+    }
+
+    auto& slot = m_slots[seq % SLOTS];
+    if (slot.used) return; // duplicate
+
+    slot.frame = frame;
+    slot.arrival = now;
+    slot.seq = seq;
+    slot.used = true;
+    m_held++;
+}
+
+void VoiceJitterBuffer::reset(uint32_t seq) {
+    for (auto& slot : m_slots) {
+        slot = Slot{};
+    }
+
+    m_held = 0;
+    m_nextSeq = seq;
+    m_prebuffering = true;
+}
+
+VoiceJitterBuffer::Step VoiceJitterBuffer::next(Instant now, float queuedSecs) {
+    if (m_held == 0) return {};
+
+    float target = this->targetDelay();
+    float waited = this->longestWait(now);
+
+    // when nothing is playing (start of a talk spurt, or playback ran dry), hold audio back for the target delay,
+    // so that there is enough queued to ride out packets arriving late
+    if (m_prebuffering) {
+        if (queuedSecs <= 0.f) {
+            if (waited < target) return {};
+
+            // frames missing before the held ones (e.g. the lost end of the previous spurt) are too late to conceal
+            while (!this->slotFor(m_nextSeq)) {
+                m_nextSeq = (m_nextSeq + 1) & 0xffffff;
+            }
+        }
+
+        m_prebuffering = false;
+    }
+
+    if (auto slot = this->slotFor(m_nextSeq)) {
+        return { Action::Decode, &slot->frame };
+    }
+
+    // the next frame is missing but later ones are here, so it's either lost or late.
+    // wait for it while there is still audio to play and it isn't overdue
+    if (queuedSecs > m_frameSecs / 2.f && waited < target) {
+        return {};
+    }
+
+    if (auto after = this->slotFor(m_nextSeq + 1)) {
+        return { Action::Recover, &after->frame };
+    }
+
+    return { Action::Conceal, nullptr };
+}
+
+void VoiceJitterBuffer::pop(const Step& step, Instant now) {
+    switch (step.action) {
+        case Action::None: return;
+
+        case Action::Decode: {
+            auto slot = this->slotFor(m_nextSeq);
+            m_stats.heldMicros.fetch_add(now.durationSince(slot->arrival).nanos() / 1000, relaxed);
+            *slot = Slot{};
+            m_held--;
+        } break;
+
+        case Action::Recover: m_stats.recovered.fetch_add(1, relaxed); break;
+        case Action::Conceal: m_stats.concealed.fetch_add(1, relaxed); break;
+    }
+
+    m_stats.frames.fetch_add(1, relaxed);
+    m_nextSeq = (m_nextSeq + 1) & 0xffffff;
+
+    if (m_held == 0) {
+        m_prebuffering = true;
+    }
+}
+
+VoiceJitterBuffer::Slot* VoiceJitterBuffer::slotFor(uint32_t seq) {
+    seq &= 0xffffff;
+
+    auto& slot = m_slots[seq % SLOTS];
+    return slot.used && slot.seq == seq ? &slot : nullptr;
+}
+
+float VoiceJitterBuffer::longestWait(Instant now) const {
+    float longest = 0.f;
+
+    for (auto& slot : m_slots) {
+        if (slot.used) {
+            longest = std::max(longest, now.durationSince(slot.arrival).seconds<float>());
+        }
+    }
+
+    return longest;
+}
+
+bool VoiceJitterBuffer::empty() const {
+    return m_held == 0;
+}
+
+float VoiceJitterBuffer::targetDelay() const {
+    // one extra frame, so that when a single frame is lost the next one arrives before playback runs dry and FEC can recover it
+    return std::clamp(m_frameSecs + m_jitter * 3.f, MIN_TARGET_DELAY, MAX_TARGET_DELAY);
+}
+
+float VoiceJitterBuffer::jitter() const {
+    return m_jitter;
+}
+
+const VoiceJitterStats& VoiceJitterBuffer::stats() const {
+    return m_stats;
+}
+
+}
@@ -0,0 +1,226 @@
+#include <globed/audio/VoiceMixer.hpp>
+#include <globed/audio/AudioManager.hpp>
+#include <globed/audio/sound/VoiceStream.hpp>
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define GLOBED_MIXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GLOBED_MIXER_NEON
+#endif
+
+// sources are mixed in chunks of at most this many frames, fmod usually asks for far less
+constexpr size_t MIX_CHUNK = 4096;
+
+namespace globed {
+
+void mixMonoToStereo(float* out, const float* in, size_t samples, float gainL, float gainR) {
+    size_t i = 0;
+
+#if defined(GLOBED_MIXER_SSE2)
+    __m128 gl = _mm_set1_ps(gainL);
+    __m128 gr = _mm_set1_ps(gainR);
+
+    for (; i + 4 <= samples; i += 4) {
+        __m128 s = _mm_loadu_ps(in + i);
+        __m128 l = _mm_mul_ps(s, gl);
+        __m128 r = _mm_mul_ps(s, gr);
+
+        // interleave into l0 r0 l1 r1 / l2 r2 l3 r3
+        float* o = out + i * 2;
+        _mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_unpacklo_ps(l, r)));
+        _mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_unpackhi_ps(l, r)));
+    }
+#elif defined(GLOBED_MIXER_NEON)
+    for (; i + 4 <= samples; i += 4) {
+        float32x4_t s = vld1q_f32(in + i);
+        // deinterleaving load, val[0] is the left channel and val[1] the right one
+        float32x4x2_t o = vld2q_f32(out + i * 2);
+        o.val[0] = vmlaq_n_f32(o.val[0], s, gainL);
+        o.val[1] = vmlaq_n_f32(o.val[1], s, gainR);
+        vst2q_f32(out + i * 2, o);
+    }
+#endif
+
+    for (; i < samples; i++) {
+        out[i * 2] += in[i] * gainL;
+        out[i * 2 + 1] += in[i] * gainR;
+    }
+}
+
+void clampSamples(float* data, size_t samples) {
+    size_t i = 0;
+
+#if defined(GLOBED_MIXER_SSE2)
+    __m128 lo = _mm_set1_ps(-1.f);
+    __m128 hi = _mm_set1_ps(1.f);
+
+    for (; i + 4 <= samples; i += 4) {
+        _mm_storeu_ps(data + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi));
+    }
+#elif defined(GLOBED_MIXER_NEON)
+    float32x4_t lo = vdupq_n_f32(-1.f);
+    float32x4_t hi = vdupq_n_f32(1.f);
+
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_f32(data + i, vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi));
+    }
+#endif
+
+    for (; i < samples; i++) {
+        data[i] = std::clamp(data[i], -1.f, 1.f);
+    }
+}
+
+VoiceMixer::VoiceMixer(FMOD::System* system)
+    : m_system(system), m_scratch(std::make_unique<float[]>(MIX_CHUNK)) {}
+
+VoiceMixer::~VoiceMixer() {
+    this->stop();
+}
+
+Result<> VoiceMixer::addSource(VoiceStream* stream) {
+    GEODE_UNWRAP(this->startOutput());
+
+    auto sources = m_sources.lock();
+    std::vector<VoiceStream*> list = *sources ? **sources : std::vector<VoiceStream*>{};
+
+    if (std::find(list.begin(), list.end(), stream) == list.end()) {
+        list.push_back(stream);
+        this->publishSources(*sources, std::move(list));
+    }
+
+    return Ok();
+}
+
+void VoiceMixer::removeSource(VoiceStream* stream) {
+    auto sources = m_sources.lock();
+    if (!*sources) return;
+
+    std::vector<VoiceStream*> list = **sources;
+    if (std::erase(list, stream) > 0) {
+        this->publishSources(*sources, std::move(list));
+    }
+}
+
+size_t VoiceMixer::sourceCount() {
+    auto sources = m_sources.lock();
+    return *sources ? (*sources)->size() : 0;
+}
+
+void VoiceMixer::publishSources(std::unique_ptr<std::vector<VoiceStream*>>& current, std::vector<VoiceStream*> sources) {
+    auto next = std::make_unique<std::vector<VoiceStream*>>(std::move(sources));
+    m_published.store(next.get());
+
+    // a mix that started before the store can still be reading the old list, wait for it before freeing the list.
+    // mixes that start afterwards see the new one, so this is at most the duration of a single mix
+    while (m_mixing.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    current = std::move(next);
+}
+
+Result<> VoiceMixer::startOutput() {
+    if (m_sound) return Ok();
+
+    auto& am = AudioManager::get();
+
+    FMOD_CREATESOUNDEXINFO exinfo = {};
+
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    exinfo.numchannels = 2;
+    exinfo.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+    exinfo.defaultfrequency = VOICE_TARGET_SAMPLERATE;
+    // same delay as separate voice streams, the size is in frames so it doesn't depend on the channel count
+    exinfo.decodebuffersize = exinfo.defaultfrequency * AUDIO_PLAYBACK_DELAY;
+    exinfo.userdata = this;
+    exinfo.length = sizeof(float) * exinfo.numchannels * exinfo.defaultfrequency * 0.03f;
+
+    exinfo.pcmreadcallback = [](FMOD_SOUND* sound_, void* data_, unsigned int len) -> FMOD_RESULT {
+        FMOD::Sound* sound = reinterpret_cast<FMOD::Sound*>(sound_);
+        VoiceMixer* mixer = nullptr;
+        sound->getUserData((void**)&mixer);
+        float* data = reinterpret_cast<float*>(data_);
+
+        if (!mixer || !data) {
+            log::warn("voice mixer is nullptr in cb, ignoring");
+            return FMOD_OK;
+        }
+
+        mixer->mix(data, len / (sizeof(float) * 2));
+
+        return FMOD_OK;
+    };
+
+    GEODE_UNWRAP(am.mapError(
+        m_system->createStream(nullptr, FMOD_OPENUSER | FMOD_2D | FMOD_LOOP_NORMAL, &exinfo, &m_sound)
+    ));
+
+    if (auto err = am.mapError(m_system->playSound(m_sound, nullptr, false, &m_channel)).err()) {
+        m_sound->release();
+        m_sound = nullptr;
+        return Err(std::move(*err));
+    }
+
+    return Ok();
+}
+
+void VoiceMixer::stop() {
+    if (m_channel) {
+        m_channel->stop();
+        m_channel = nullptr;
+    }
+
+    if (m_sound) {
+        m_sound->release();
+        m_sound = nullptr;
+    }
+}
+
+// Runs on the fmod mixer thread, never blocks. Sources being added or removed wait for it instead
+void VoiceMixer::mix(float* out, size_t frames) {
+    std::fill_n(out, frames * 2, 0.f);
+
+    m_mixing.fetch_add(1);
+    auto sources = m_published.load();
+    float* scratch = m_scratch.get();
+
+    if (!sources) {
+        m_mixing.fetch_sub(1);
+        return;
+    }
+
+    for (size_t offset = 0; offset < frames; offset += MIX_CHUNK) {
+        size_t count = std::min(MIX_CHUNK, frames - offset);
+        float* dest = out + offset * 2;
+
+        for (auto* stream : *sources) {
+            float gain = stream->mixGain();
+
+            // muted, deafened, out of proximity range or not talking, nothing to mix
+            if (gain <= 0.f || stream->queuedSamples() == 0) {
+                stream->skipPlayback(count);
+                continue;
+            }
+
+            // linear pan, the center keeps full gain on both sides
+            float pan = stream->mixPan();
+            float gainL = gain * std::min(1.f, 1.f - pan);
+            float gainR = gain * std::min(1.f, 1.f + pan);
+
+            stream->readCallback(scratch, count);
+            mixMonoToStereo(dest, scratch, count, gainL, gainR);
+        }
+    }
+
+    m_mixing.fetch_sub(1);
+
+    clampSamples(out, frames * 2);
+}
+
+}
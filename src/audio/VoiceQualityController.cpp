@@ -0,0 +1,134 @@
+#include <globed/audio/VoiceQualityController.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace asp::time;
+
+constexpr int MIN_BITRATE = 12000;
+constexpr int BITRATE_STEP_UP = 2000;
+constexpr float BITRATE_STEP_DOWN = 0.75f;
+// bitrate drops at most this often while congested, and only goes up again once the link was fine for a while
+constexpr auto BITRATE_DECREASE_HOLD = Duration::fromMillis(2000);
+constexpr auto BITRATE_INCREASE_HOLD = Duration::fromMillis(5000);
+
+// the link counts as congested with this much loss, or when the rtt is this far above the lowest one seen (packets are queueing up)
+constexpr float CONGESTED_LOSS = 0.05f;
+constexpr float QUEUEING_DELAY_MS = 100.f;
+// the rtt baseline creeps up by this much per update, so that a route change to a longer path isn't treated as congestion forever
+constexpr float RTT_BASELINE_RISE_MS = 0.5f;
+
+// encoding a frame normally takes around 1-2% of its duration, this much means the device is struggling
+constexpr float HIGH_ENCODER_LOAD = 0.1f;
+constexpr float LOW_ENCODER_LOAD = 0.03f;
+constexpr int MIN_COMPLEXITY = 2;
+constexpr int MAX_COMPLEXITY = 10;
+constexpr int COMPLEXITY_STEP_DOWN = 2;
+constexpr auto COMPLEXITY_DECREASE_HOLD = Duration::fromMillis(3000);
+constexpr auto COMPLEXITY_INCREASE_HOLD = Duration::fromMillis(15000);
+
+// fec is tuned for the measured loss in steps of 5%, never below 5% since voice losses come in bursts that the average hides
+constexpr int FEC_STEP = 5;
+constexpr int MIN_FEC_PERCENT = 5;
+constexpr int MAX_FEC_PERCENT = 25;
+
+namespace globed {
+
+// every listener gets their own copy from the server, so large rooms get a lower cap
+static int bitrateCeiling(size_t listeners) {
+    if (listeners <= 4) return 28000;
+    if (listeners <= 16) return 24000;
+    if (listeners <= 48) return 20000;
+    return 16000;
+}
+
+VoiceQualityController::VoiceQualityController() {
+    auto now = Instant::now();
+    m_lastBitrateChange = now;
+    m_lastComplexityChange = now;
+    m_lastCongestion = now;
+}
+
+std::optional<VoiceEncoderSettings> VoiceQualityController::update(const VoiceLinkStats& stats, Instant now) {
+    auto next = m_settings;
+    std::string_view reason;
+
+    if (stats.rttMs > 0.f) {
+        if (m_rttBaseline == 0.f || stats.rttMs < m_rttBaseline) {
+            m_rttBaseline = stats.rttMs;
+        } else {
+            m_rttBaseline += RTT_BASELINE_RISE_MS;
+        }
+    }
+
+    bool congested = stats.loss > CONGESTED_LOSS || (stats.rttMs > 0.f && stats.rttMs > m_rttBaseline + QUEUEING_DELAY_MS);
+    if (congested) {
+        m_lastCongestion = now;
+    }
+
+    // bitrate
+    int ceiling = bitrateCeiling(stats.listeners);
+
+    if (next.bitrate > ceiling) {
+        next.bitrate = ceiling;
+        reason = "more listeners";
+    } else if (congested && next.bitrate > MIN_BITRATE && now.durationSince(m_lastBitrateChange) >= BITRATE_DECREASE_HOLD) {
+        next.bitrate = std::max(MIN_BITRATE, static_cast<int>(next.bitrate * BITRATE_STEP_DOWN));
+        reason = "congested link";
+    } else if (
+        !congested && next.bitrate < ceiling
+        && now.durationSince(m_lastCongestion) >= BITRATE_INCREASE_HOLD
+        && now.durationSince(m_lastBitrateChange) >= BITRATE_INCREASE_HOLD
+    ) {
+        next.bitrate = std::min(ceiling, next.bitrate + BITRATE_STEP_UP);
+        reason = "stable link";
+    }
+
+    if (next.bitrate != m_settings.bitrate) {
+        m_lastBitrateChange = now;
+    }
+
+    // complexity, only when there's a fresh measurement
+    if (stats.encoderLoad > 0.f) {
+        auto sinceChange = now.durationSince(m_lastComplexityChange);
+
+        if (stats.encoderLoad > HIGH_ENCODER_LOAD && next.complexity > MIN_COMPLEXITY && sinceChange >= COMPLEXITY_DECREASE_HOLD) {
+            next.complexity = std::max(MIN_COMPLEXITY, next.complexity - COMPLEXITY_STEP_DOWN);
+            reason = "high cpu load";
+        } else if (stats.encoderLoad < LOW_ENCODER_LOAD && next.complexity < MAX_COMPLEXITY && sinceChange >= COMPLEXITY_INCREASE_HOLD) {
+            next.complexity++;
+            reason = "cpu headroom";
+        }
+
+        if (next.complexity != m_settings.complexity) {
+            m_lastComplexityChange = now;
+        }
+    }
+
+    // fec
+    int lossPercent = static_cast<int>(std::ceil(stats.loss * 100.f / FEC_STEP)) * FEC_STEP;
+    next.fecLossPercent = std::clamp(lossPercent, MIN_FEC_PERCENT, MAX_FEC_PERCENT);
+
+    if (next.fecLossPercent != m_settings.fecLossPercent && reason.empty()) {
+        reason = "measured loss";
+    }
+
+    if (next == m_settings) {
+        return std::nullopt;
+    }
+
+    m_settings = next;
+    m_reason = reason;
+
+    return next;
+}
+
+const VoiceEncoderSettings& VoiceQualityController::settings() const {
+    return m_settings;
+}
+
+std::string_view VoiceQualityController::reason() const {
+    return m_reason;
+}
+
+}
@@ -1,35 +1,114 @@
 #include <globed/audio/VolumeEstimator.hpp>
 #include <globed/audio/sound/VoiceStream.hpp>
 
-#include <asp/iter.hpp>
 #include <qunet/util/algo.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define GLOBED_ESTIMATOR_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GLOBED_ESTIMATOR_NEON
+#endif
 
 using namespace geode::prelude;
 using namespace asp::time;
 
+// a block is added for every feed that doesn't end on a block boundary, this leaves room for plenty of them
+constexpr size_t EXTRA_BLOCKS = 128;
+
 namespace globed {
 
-VolumeEstimator::VolumeEstimator(size_t sampleRate) : m_sampleRate(sampleRate) {}
+float sumOfSquares(const float* pcm, size_t samples) {
+    size_t i = 0;
+    float sum = 0.f;
+
+#if defined(GLOBED_ESTIMATOR_SSE2)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    for (; i + 8 <= samples; i += 8) {
+        __m128 a = _mm_loadu_ps(pcm + i);
+        __m128 b = _mm_loadu_ps(pcm + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(GLOBED_ESTIMATOR_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.f);
+    float32x4_t acc1 = vdupq_n_f32(0.f);
+
+    for (; i + 8 <= samples; i += 8) {
+        float32x4_t a = vld1q_f32(pcm + i);
+        float32x4_t b = vld1q_f32(pcm + i + 4);
+        acc0 = vmlaq_f32(acc0, a, a);
+        acc1 = vmlaq_f32(acc1, b, b);
+    }
+
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+
+    for (; i < samples; i++) {
+        sum += pcm[i] * pcm[i];
+    }
+
+    return sum;
+}
+
+VolumeEstimator::VolumeEstimator(size_t sampleRate)
+    : m_sampleRate(sampleRate),
+      m_blocks(static_cast<size_t>(sampleRate * BUFFER_SIZE) / BLOCK_SIZE + EXTRA_BLOCKS) {}
 
 void VolumeEstimator::feedData(const float* pcm, size_t samples) {
-    m_sampleQueue.writeData(pcm, samples);
-    m_writeHistory.emplace_back(Instant::now(), samples);
+    this->feedData(pcm, samples, Instant::now());
+}
+
+void VolumeEstimator::feedData(const float* pcm, size_t samples, Instant now) {
+    for (size_t offset = 0; offset < samples; offset += BLOCK_SIZE) {
+        size_t count = std::min(BLOCK_SIZE, samples - offset);
 
-    if (m_sampleQueue.size() > static_cast<float>(m_sampleRate) * BUFFER_SIZE) {
-        m_sampleQueue.clear();
-        m_writeHistory.clear();
+        this->feedBlock(Block {
+            .time = now,
+            .energy = sumOfSquares(pcm + offset, count),
+            .samples = static_cast<uint32_t>(count),
+        });
     }
 }
 
-static float calculatePcmVolume(const float* pcm, size_t samples) {
-    if (samples == 0) return 0.f;
+void VolumeEstimator::feedBlock(const Block& block) {
+    if (block.samples == 0) return;
+
+    if (m_blockCount == m_blocks.size()) {
+        this->clear();
+    }
 
-    double sum = asp::iter::from(pcm, samples).map([](float v) { return v * v; }).sum();
+    m_blocks[(m_blockStart + m_blockCount) % m_blocks.size()] = block;
+    m_blockCount++;
+    m_queuedSamples += block.samples;
+
+    if (m_queuedSamples > static_cast<float>(m_sampleRate) * BUFFER_SIZE) {
+        this->clear();
+    }
+}
 
-    return static_cast<float>(sqrt(sum / (double)samples));
+void VolumeEstimator::clear() {
+    m_blockStart = 0;
+    m_blockCount = 0;
+    m_queuedSamples = 0;
 }
 
 void VolumeEstimator::update(float dt) {
+    this->update(dt, Instant::now());
+}
+
+void VolumeEstimator::update(float dt, Instant now) {
     if (std::isnan(dt)) { // yes, this happens sometimes
         dt = 0.f;
     }
@@ -37,47 +116,44 @@ void VolumeEstimator::update(float dt) {
     dt = std::clamp(dt, 0.0f, 0.25f);
 
     const size_t needed = static_cast<size_t>(static_cast<float>(m_sampleRate) * BUFFER_SIZE * dt);
-    float buf[needed];
 
-    size_t copied = 0;
+    size_t taken = 0;
+    double energy = 0.0;
 
-    // Now, determine which samples we should copy and which we shouldn't
-    // We skip AUDIO_PLAYBACK_DELAY ms of samples, since this data hasn't been played yet
-    auto now = Instant::now();
-    while (copied < needed && !m_writeHistory.empty()) {
-        auto& [time, count] = m_writeHistory.front();
-        if (now.durationSince(time).seconds<float>() < AUDIO_PLAYBACK_DELAY) {
+    // We skip AUDIO_PLAYBACK_DELAY ms of samples, since this data hasn't been played yet.
+    // Anything missing counts as silence.
+    while (taken < needed && m_blockCount > 0) {
+        auto& block = m_blocks[m_blockStart];
+        if (now.durationSince(block.time).seconds<float>() < AUDIO_PLAYBACK_DELAY) {
             break;
         }
 
-        // these samples are ready to be used now
-        size_t toCopy = std::min(count, needed - copied);
-        size_t actuallyCopied = m_sampleQueue.readData(&buf[copied], toCopy);
-        GLOBED_DEBUG_ASSERT(actuallyCopied == toCopy); // should always hold
-
-        copied += actuallyCopied;
-        count -= actuallyCopied;
-
-        if (count == 0) {
-            m_writeHistory.pop_front();
+        size_t take = std::min<size_t>(block.samples, needed - taken);
+
+        if (take == block.samples) {
+            energy += block.energy;
+            m_blockStart = (m_blockStart + 1) % m_blocks.size();
+            m_blockCount--;
+        } else {
+            // only part of the block is needed
+            float part = block.energy * take / block.samples;
+            energy += part;
+            block.energy -= part;
+            block.samples -= take;
         }
-    }
 
-    if (copied < needed) {
-        // fill the rest with void
-        for (size_t i = copied; i < needed; i++) {
-            buf[i] = 0.f;
-        }
+        taken += take;
+        m_queuedSamples -= take;
     }
 
-    float newVolume = calculatePcmVolume(buf, needed);
+    float newVolume = needed ? static_cast<float>(std::sqrt(energy / needed)) : 0.f;
     m_emaVolume = qn::exponentialMovingAverage(m_emaVolume, newVolume, 0.2);
 
     // this / 0.2f might need some tweaking
     m_normalizedVolume = std::sqrt(std::clamp(m_emaVolume / 0.25f, 0.f, 1.f));
 }
 
-float VolumeEstimator::getVolume() {
+float VolumeEstimator::getVolume() const {
     return m_normalizedVolume;
 }
 
@@ -1,5 +1,6 @@
 #include <globed/audio/sound/PlayerSound.hpp>
 #include <globed/core/game/RemotePlayer.hpp>
+#include <globed/audio/SfxCache.hpp>
 
 using namespace geode::prelude;
 
@@ -39,6 +40,27 @@ Result<std::shared_ptr<PlayerSound>> PlayerSound::create(
     return Ok(s);
 }
 
+Result<std::shared_ptr<PlayerSound>> PlayerSound::create(
+    std::shared_ptr<SfxSample> sample,
+    std::shared_ptr<RemotePlayer> player,
+    bool paused
+) {
+    auto s = std::make_shared<PlayerSound>(
+        sample->sound(),
+        player,
+        player ? player->player1()->getLastPosition() : CCPoint{}
+    );
+    s->m_sample = std::move(sample);
+
+    // pre emptively register the sound so stop() gets called
+    s->registerSelf(s);
+
+    GEODE_UNWRAP(s->play(paused).mapErr([](auto err) {
+        return fmt::format("playSound failed: {}", err);
+    }));
+    return Ok(s);
+}
+
 void PlayerSound::setStatic(bool isStatic) {
     m_static = isStatic;
 }
@@ -1,5 +1,6 @@
 #include <globed/audio/sound/Sound.hpp>
 #include <globed/audio/AudioManager.hpp>
+#include <globed/audio/SfxCache.hpp>
 
 using namespace geode::prelude;
 
@@ -31,6 +32,16 @@ Result<std::shared_ptr<Sound>> Sound::create(const char* path, bool paused) {
     return Ok(s);
 }
 
+Result<std::shared_ptr<Sound>> Sound::create(std::shared_ptr<SfxSample> sample, bool paused) {
+    auto s = std::make_shared<Sound>(sample->sound());
+    s->m_sample = std::move(sample);
+    // pre emptively register the sound so stop() gets called
+    s->registerSelf(s);
+
+    GEODE_UNWRAP(s->play(paused));
+    return Ok(s);
+}
+
 Result<std::shared_ptr<Sound>> Sound::create(const float* pcm, size_t samples, int sampleRate, int channels, bool paused) {
     FMOD_CREATESOUNDEXINFO exinfo = {};
 
@@ -93,10 +104,13 @@ void Sound::stop() {
         m_channel = nullptr;
     }
 
-    if (m_sound) {
+    if (m_sample) {
+        m_sample.reset();
+    } else if (m_sound) {
         m_sound->release();
-        m_sound = nullptr;
     }
+
+    m_sound = nullptr;
 }
 
 Result<FMOD::Sound*> Sound::createRaw(const char* path) {
@@ -1,11 +1,26 @@
 #include <globed/audio/sound/VoiceStream.hpp>
 #include <globed/audio/AudioManager.hpp>
+#include <globed/audio/VoiceMixer.hpp>
 
 #include <fmod_errors.h>
+#include <bit>
 
 using namespace asp::time;
 using enum std::memory_order;
 
+// ~2.7 seconds of audio, the queue should never get anywhere near this unless playback is stuck
+constexpr size_t QUEUE_CAPACITY = 65536;
+// after an overflow, older samples are dropped so that at most this much audio is left queued
+constexpr size_t OVERFLOW_KEEP_SAMPLES = VOICE_TARGET_SAMPLERATE / 2;
+// when more than this much audio is queued beyond the jitter buffer's target, playback speeds up by 1/DRAIN_SPEEDUP_DIV (2%)
+// until the backlog is gone, which is not audible but keeps latency from building up after bursts
+constexpr size_t DRAIN_THRESHOLD_SAMPLES = VOICE_TARGET_SAMPLERATE / 10;
+constexpr size_t DRAIN_SPEEDUP_DIV = 50;
+constexpr size_t STRETCH_BUFFER_SIZE = 16384;
+// played blocks waiting for the main thread, enough for the whole queue, must be a power of two
+constexpr size_t PLAYED_BLOCKS = QUEUE_CAPACITY / globed::VolumeEstimator::BLOCK_SIZE;
+static_assert(std::has_single_bit(PLAYED_BLOCKS));
+
 namespace globed {
 
 VoiceStream::VoiceStream(
@@ -14,22 +29,42 @@ VoiceStream::VoiceStream(
 )
     : PlayerSound(sound, player, {}),
       m_decoder(VOICE_TARGET_SAMPLERATE, VOICE_TARGET_FRAMESIZE, VOICE_CHANNELS),
-      m_estimator(VolumeEstimator(VOICE_TARGET_SAMPLERATE)),
+      m_decodeBuffer(std::make_unique<float[]>(m_decoder.frameSamples())),
+      m_queue(QUEUE_CAPACITY),
+      m_jitter(VOICE_TARGET_SAMPLERATE, VOICE_CHUNK_RECORD_TIME),
+      m_stretchBuffer(std::make_unique<float[]>(STRETCH_BUFFER_SIZE)),
+      m_played(std::make_unique<VolumeEstimator::Block[]>(PLAYED_BLOCKS)),
+      m_estimator(VOICE_TARGET_SAMPLERATE),
       m_lastPlaybackTime(Instant::now())
 {
 }
 
 VoiceStream::~VoiceStream() {
+    this->logStats();
+
+    if (m_mixer) {
+        m_mixer->removeSource(this);
+    }
+
     if (m_channel) {
         m_channel->setUserData(nullptr);
     }
 }
 
 Result<std::shared_ptr<VoiceStream>> VoiceStream::create(
-    std::weak_ptr<RemotePlayer> player
+    std::weak_ptr<RemotePlayer> player,
+    VoiceMixer* mixer
 ) {
     auto stream = std::make_shared<VoiceStream>(nullptr, player);
 
+    if (mixer) {
+        stream->registerSelf(stream);
+        GEODE_UNWRAP(mixer->addSource(stream.get()));
+        stream->m_mixer = mixer;
+
+        return Ok(stream);
+    }
+
     FMOD_CREATESOUNDEXINFO exinfo = {};
 
     exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
@@ -73,9 +108,21 @@ Result<std::shared_ptr<VoiceStream>> VoiceStream::create(
 }
 
 void VoiceStream::stop() {
+    if (m_mixer) {
+        m_mixer->removeSource(this);
+        m_mixer = nullptr;
+    }
+
     PlayerSound::stop();
 }
 
+bool VoiceStream::isPlaying() const {
+    // mixed streams have no sound or channel of their own
+    if (m_mixer) return this->getPlayer() != nullptr;
+
+    return PlayerSound::isPlaying();
+}
+
 void VoiceStream::onUpdate() {
     PlayerSound::onUpdate();
 
@@ -86,9 +133,60 @@ void VoiceStream::onUpdate() {
     this->updateEstimator(elapsed.seconds<float>());
 }
 
+// Runs on the fmod mixer thread, must never block on the main thread
+void VoiceStream::trimAfterOverflow() {
+    // the writer ran out of space, so playback is far behind, skip ahead to recent audio
+    if (m_overflowed.exchange(false, relaxed)) {
+        size_t queued = m_queue.size();
+        if (queued > OVERFLOW_KEEP_SAMPLES) {
+            m_queue.discard(queued - OVERFLOW_KEEP_SAMPLES);
+        }
+    }
+}
+
+void VoiceStream::skipPlayback(size_t samples) {
+    this->trimAfterOverflow();
+
+    if (m_queue.discard(samples) == samples) {
+        m_starving.store(false, relaxed);
+        m_lastPlaybackTime = Instant::now();
+    } else {
+        m_starving.store(true, relaxed);
+    }
+}
+
+size_t VoiceStream::queuedSamples() const {
+    return m_queue.size();
+}
+
+// Runs on the fmod mixer thread, must never block on the main thread
 void VoiceStream::readCallback(float* data, unsigned int neededSamples) {
-    size_t copied = m_queue.lock()->readData(data, neededSamples);
-    m_estimator.lock()->feedData(data, copied);
+    this->trimAfterOverflow();
+
+    size_t copied;
+    size_t drainAbove = neededSamples + m_targetSamples.load(relaxed) + DRAIN_THRESHOLD_SAMPLES;
+    size_t fastSamples = neededSamples + neededSamples / DRAIN_SPEEDUP_DIV;
+
+    if (m_queue.size() > drainAbove && fastSamples <= STRETCH_BUFFER_SIZE && neededSamples > 1) {
+        // play slightly faster by resampling a bit more audio into the requested length
+        float* src = m_stretchBuffer.get();
+        m_queue.peek(src, fastSamples);
+
+        float step = static_cast<float>(fastSamples - 1) / static_cast<float>(neededSamples - 1);
+        for (size_t i = 0; i < neededSamples; i++) {
+            float pos = i * step;
+            size_t idx = std::min(static_cast<size_t>(pos), fastSamples - 2);
+            float frac = pos - idx;
+            data[i] = src[idx] + (src[idx + 1] - src[idx]) * frac;
+        }
+
+        m_queue.consume(fastSamples);
+        copied = neededSamples;
+    } else {
+        copied = m_queue.read(data, neededSamples);
+    }
+
+    this->pushPlayed(data, copied);
 
     if (copied != neededSamples) {
         m_starving.store(true, relaxed);
@@ -102,33 +200,153 @@ void VoiceStream::readCallback(float* data, unsigned int neededSamples) {
     }
 }
 
-Result<> VoiceStream::writeData(const EncodedAudioFrame& frame) {
-    const auto& frames = frame.getFrames();
-    for (const auto& opusFrame : frames) {
-        auto decodedFrame_ = m_decoder.decode(opusFrame);
-        GEODE_UNWRAP_INTO(auto decodedFrame, decodedFrame_);
+// Runs on the fmod mixer thread, only the energy of every block is passed on, never the samples
+void VoiceStream::pushPlayed(const float* data, size_t samples) {
+    auto now = Instant::now();
+    size_t head = m_playedHead.load(relaxed);
+    size_t tail = m_playedTail.load(acquire);
+
+    for (size_t offset = 0; offset < samples; offset += VolumeEstimator::BLOCK_SIZE) {
+        // if the main thread falls behind in draining these, the newest blocks are dropped, which only affects the volume estimate
+        if (head - tail == PLAYED_BLOCKS) break;
 
-        m_queue.lock()->writeData(decodedFrame.data.get(), decodedFrame.size);
+        size_t count = std::min(VolumeEstimator::BLOCK_SIZE, samples - offset);
+
+        m_played[head % PLAYED_BLOCKS] = VolumeEstimator::Block {
+            .time = now,
+            .energy = sumOfSquares(data + offset, count),
+            .samples = static_cast<uint32_t>(count),
+        };
+        head++;
+    }
+
+    m_playedHead.store(head, release);
+}
+
+Result<> VoiceStream::writeData(const EncodedAudioFrame& frame, Instant now) {
+    if (m_jitter.push(frame, now)) {
+        return this->pump(now);
+    }
+
+    // frames without sequence numbers (older clients) are played in the order they arrive
+    for (const auto& opusFrame : frame.getFrames()) {
+        GEODE_UNWRAP(this->decodeFrame([&](float* out, size_t samples) {
+            return m_decoder.decodeInto(opusFrame, out, samples);
+        }));
     }
 
     return Ok();
 }
 
+Result<> VoiceStream::pump(Instant now) {
+    while (true) {
+        auto step = m_jitter.next(now, static_cast<float>(m_queue.size()) / VOICE_TARGET_SAMPLERATE);
+
+        if (step.action == VoiceJitterBuffer::Action::None) break;
+
+        auto res = this->decodeFrame([&](float* out, size_t samples) -> Result<size_t> {
+            switch (step.action) {
+                case VoiceJitterBuffer::Action::Recover: return m_decoder.recoverInto(*step.frame, out, samples);
+                case VoiceJitterBuffer::Action::Conceal: return m_decoder.concealInto(out, samples);
+                default: return m_decoder.decodeInto(*step.frame, out, samples);
+            }
+        });
+
+        // the step is done even if decoding failed, so that one bad frame doesn't stall the stream
+        m_jitter.pop(step, now);
+        GEODE_UNWRAP(res);
+    }
+
+    m_targetSamples.store(m_jitter.targetDelay() * VOICE_TARGET_SAMPLERATE, relaxed);
+
+    return Ok();
+}
+
+bool VoiceStream::hasHeldFrames() const {
+    return !m_jitter.empty();
+}
+
+const VoiceJitterStats& VoiceStream::jitterStats() const {
+    return m_jitter.stats();
+}
+
+Result<> VoiceStream::decodeFrame(geode::FunctionRef<Result<size_t>(float*, size_t)> decode) {
+    // room for the longest possible frame, shorter ones (low latency senders) only commit what was decoded
+    size_t frameSamples = m_decoder.frameSamples();
+    m_queuedSamplesTotal.fetch_add(m_queue.size(), relaxed);
+
+    // decode straight into the queue when there is a contiguous region big enough, otherwise go through the buffer
+    auto spans = m_queue.writeSpans(frameSamples);
+
+    if (spans.first.size() == frameSamples) {
+        GEODE_UNWRAP_INTO(size_t decoded, decode(spans.first.data(), frameSamples));
+        m_queue.commitWrite(decoded);
+    } else {
+        GEODE_UNWRAP_INTO(size_t decoded, decode(m_decodeBuffer.get(), frameSamples));
+        this->writeData(m_decodeBuffer.get(), decoded);
+    }
+
+    return Ok();
+}
+
+void VoiceStream::logStats() {
+    auto& stats = m_jitter.stats();
+    uint64_t frames = stats.frames.load(relaxed);
+    if (frames == 0) return;
+
+    auto percent = [&](const std::atomic<uint64_t>& v) { return v.load(relaxed) * 100.0 / frames; };
+    double heldMs = stats.heldMicros.load(relaxed) / 1000.0 / frames;
+    double queueMs = m_queuedSamplesTotal.load(relaxed) * 1000.0 / VOICE_TARGET_SAMPLERATE / frames;
+
+    // mouth-to-ear latency is this plus the capture frame and the network one-way delay
+    log::debug(
+        "Voice stream ended: {} frames, {:.1f}% recovered with FEC, {:.1f}% concealed, {} late. "
+        "Jitter {:.1f}ms, target delay {:.1f}ms, receive latency {:.1f}ms (jitter buffer {:.1f}, queue {:.1f}, playback {:.0f})",
+        frames, percent(stats.recovered), percent(stats.concealed), stats.late.load(relaxed),
+        stats.jitterMicros.load(relaxed) / 1000.0, m_targetSamples.load(relaxed) * 1000.0 / VOICE_TARGET_SAMPLERATE,
+        heldMs + queueMs + AUDIO_PLAYBACK_DELAY * 1000.0, heldMs, queueMs, AUDIO_PLAYBACK_DELAY * 1000.0
+    );
+}
+
 void VoiceStream::writeData(const float* pcm, size_t samples) {
-    m_queue.lock()->writeData(pcm, samples);
+    if (m_queue.write(pcm, samples) != samples) {
+        m_overflowed.store(true, relaxed);
+    }
 }
 
 void VoiceStream::updateEstimator(float dt) {
-    m_estimator.lock()->update(dt);
+    size_t tail = m_playedTail.load(relaxed);
+    size_t head = m_playedHead.load(acquire);
+
+    for (; tail != head; tail++) {
+        m_estimator.feedBlock(m_played[tail % PLAYED_BLOCKS]);
+    }
+
+    m_playedTail.store(tail, release);
+
+    m_estimator.update(dt);
 }
 
 void VoiceStream::rawSetVolume(float volume) {
     PlayerSound::rawSetVolume(volume);
     m_rawVolume = volume;
+    m_mixGain.store(volume, relaxed);
+}
+
+void VoiceStream::rawSetPan(float pan) {
+    m_mixPan.store(pan, relaxed);
+}
+
+float VoiceStream::mixGain() const {
+    return m_mixGain.load(relaxed);
+}
+
+float VoiceStream::mixPan() const {
+    return m_mixPan.load(relaxed);
 }
 
 float VoiceStream::getAudibility() const {
-    return m_estimator.lock()->getVolume() * m_rawVolume;
+    return m_estimator.getVolume() * m_rawVolume;
 }
 
 Duration VoiceStream::sinceLastPlayback() {
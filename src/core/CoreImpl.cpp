@@ -1,6 +1,7 @@
 #include "CoreImpl.hpp"
 #include <globed/core/SettingsManager.hpp>
 #include <core/net/NetworkManagerImpl.hpp>
+#include <util/Profiler.hpp>
 
 using namespace geode::prelude;
 
@@ -135,15 +136,19 @@ void CoreImpl::onLocalPlayerDeath(GlobedGJBGL* gjbgl, bool real) {
     });
 }
 
-void CoreImpl::onUpdate(GlobedGJBGL* gjbgl, float dt) {
-    this->forEachEnabled([&](Module& mod) {
-        mod.onUpdate(gjbgl, dt);
+void CoreImpl::onUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) {
+    GLOBED_PROFILE_ZONE("Module Update");
+
+    this->forEachEnabledIn(ModuleUpdatePhase::Update, [&](Module& mod) {
+        mod.onFrameUpdate(gjbgl, ctx);
     });
 }
 
-void CoreImpl::onPreUpdate(GlobedGJBGL* gjbgl, float dt) {
-    this->forEachEnabled([&](Module& mod) {
-        mod.onPreUpdate(gjbgl, dt);
+void CoreImpl::onPreUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) {
+    GLOBED_PROFILE_ZONE("Module Pre Update");
+
+    this->forEachEnabledIn(ModuleUpdatePhase::PreUpdate, [&](Module& mod) {
+        mod.onFramePreUpdate(gjbgl, ctx);
     });
 }
 
@@ -187,4 +192,12 @@ void CoreImpl::forEachEnabled(geode::FunctionRef<void(Module&)>&& func) {
     }
 }
 
-}
\ No newline at end of file
+void CoreImpl::forEachEnabledIn(ModuleUpdatePhase phase, geode::FunctionRef<void(Module&)>&& func) {
+    for (auto& mod : m_modules) {
+        if (mod->m_enabled && !(mod->m_skippedPhases & phase)) {
+            func(*mod);
+        }
+    }
+}
+
+}
@@ -54,8 +54,8 @@ public:
 
     bool shouldSpeedUpNewBest(GlobedGJBGL* gjbgl);
     void onLocalPlayerDeath(GlobedGJBGL* gjbgl, bool real);
-    void onUpdate(GlobedGJBGL* gjbgl, float dt);
-    void onPreUpdate(GlobedGJBGL* gjbgl, float dt);
+    void onUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx);
+    void onPreUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx);
 
     bool wantsSyncReset();
 
@@ -65,6 +65,7 @@ private:
     void enableIf(geode::FunctionRef<bool(Module&)>&& func);
     void disableIf(geode::FunctionRef<bool(Module&)>&& func);
     void forEachEnabled(geode::FunctionRef<void(Module&)>&& func);
+    void forEachEnabledIn(ModuleUpdatePhase phase, geode::FunctionRef<void(Module&)>&& func);
 };
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <globed/core/EmoteManager.hpp>
 #include <globed/audio/AudioManager.hpp>
 #include <globed/audio/sound/PlayerSound.hpp>
+#include <globed/audio/SfxCache.hpp>
 #include <asp/time.hpp>
 #include <asp/format.hpp>
 #include <asp/fs.hpp>
@@ -73,9 +74,15 @@ std::shared_ptr<Sound> EmoteManager::playEmoteSfx(uint32_t id, std::shared_ptr<R
         return nullptr;
     }
 
+    auto sample = SfxCache::get().get(id, it->second);
+    if (!sample) {
+        log::warn("Failed to load emote sfx {} ({}): {}", id, it->second, sample.unwrapErr());
+        return nullptr;
+    }
+
     auto res = player
-        ? PlayerSound::create(it->second.c_str(), player, true).map([] (auto s) -> std::shared_ptr<Sound> { return s; })
-        : Sound::create(it->second.c_str(), true);
+        ? PlayerSound::create(*sample, player, true).map([] (auto s) -> std::shared_ptr<Sound> { return s; })
+        : Sound::create(*sample, true);
 
     if (!res) {
         log::warn("Failed to create emote sfx {} ({}): {}", id, it->second, res.unwrapErr());
@@ -97,6 +104,19 @@ bool EmoteManager::hasSfx(uint32_t id) {
     return m_sfxPaths.contains(id);
 }
 
+void EmoteManager::warmFavoriteSfx() {
+    auto& cache = SfxCache::get();
+
+    for (uint32_t i = 0; i < 8; i++) {
+        auto id = this->getFavoriteEmote(i);
+
+        auto it = m_sfxPaths.find(id);
+        if (it != m_sfxPaths.end()) {
+            cache.warm(id, it->second);
+        }
+    }
+}
+
 $on_game(Loaded) {
     auto now = Instant::now();
     auto& em = EmoteManager::get();
@@ -148,6 +168,8 @@ $on_game(Loaded) {
         }
     }
 
+    em.warmFavoriteSfx();
+
     log::debug("Added {} emotes in {}", em.getEmotes().size(), now.elapsed().toString());
 }
 
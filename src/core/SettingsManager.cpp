@@ -72,6 +72,9 @@ SettingsManager::SettingsManager() {
     this->registerSetting("core.player.rotate-names", true);
     this->registerSetting("core.player.death-effects", true);
     this->registerSetting("core.player.default-death-effects", false);
+    this->registerSetting("core.player.lod", true);
+    this->registerSetting("core.player.lod-budget", 20);
+    this->registerLimits("core.player.lod-budget", 1, 100);
     // invisible settings
     this->registerSetting("core.player.blacklisted-players", matjson::Value::array());
     this->registerSetting("core.player.whitelisted-players", matjson::Value::array());
@@ -111,6 +114,17 @@ SettingsManager::SettingsManager() {
     this->registerSetting("core.audio.buffer-size", 4);
     this->registerLimits("core.audio.buffer-size", 1, 10);
 
+    this->registerSetting("core.audio.frame-duration", 60); // in ms, anything lower enables low latency mode
+    this->registerLimits("core.audio.frame-duration", 10, 60);
+
+    this->registerSetting("core.audio.voice-activation", false);
+    this->registerSetting("core.audio.vad-attack", 20); // in ms
+    this->registerLimits("core.audio.vad-attack", 10, 200);
+    this->registerSetting("core.audio.vad-hangover", 300); // in ms
+    this->registerLimits("core.audio.vad-hangover", 50, 1000);
+
+    this->registerSetting("core.audio.voice-mixer", false);
+
     this->registerSetting("core.audio.playback-volume", 1.f);
     this->registerLimits("core.audio.playback-volume", 0.f, 2.f);
 
@@ -139,6 +153,8 @@ SettingsManager::SettingsManager() {
     this->registerSetting("core.dev.cert-verification", true);
     this->registerSetting("core.dev.ghost-follower", false);
     this->registerSetting("core.dev.profile-frame-time", false);
+    this->registerSetting("core.dev.profiler", false);
+    this->registerSetting("core.dev.binary-logs", false);
 }
 
 void SettingsManager::loadSaveSlots() {
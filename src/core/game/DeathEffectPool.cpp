@@ -0,0 +1,226 @@
+#include "DeathEffectPool.hpp"
+#include <globed/core/game/VisualPlayer.hpp>
+
+using namespace geode::prelude;
+
+// maximum amount of vanilla death effects that can be active at once
+constexpr size_t MAX_FULL_EFFECTS = 8;
+// maximum amount of vanilla death effects that can be started in a single frame
+constexpr size_t MAX_FULL_EFFECTS_PER_FRAME = 3;
+// particle budget, if exceeded new vanilla effects are played without particles
+constexpr size_t MAX_PARTICLES = 400;
+// rough amount of particles a single death effect emits at its peak
+constexpr size_t PARTICLES_PER_EFFECT = 60;
+// maximum amount of simple effects, this is also the size of the pool
+constexpr size_t MAX_SIMPLE_EFFECTS = 32;
+
+constexpr float SIMPLE_EFFECT_DURATION = 0.4f;
+constexpr float SIMPLE_EFFECT_START_RADIUS = 8.f;
+constexpr float SIMPLE_EFFECT_END_RADIUS = 45.f;
+
+namespace globed {
+
+static void collectParticles(CCNode* node, std::vector<Ref<CCParticleSystem>>& out) {
+    if (auto ps = typeinfo_cast<CCParticleSystem*>(node)) {
+        out.push_back(ps);
+    }
+
+    for (auto child : node->getChildrenExt()) {
+        collectParticles(child, out);
+    }
+}
+
+bool SimpleDeathEffect::init() {
+    if (!CCDrawNode::init()) return false;
+
+    this->setTag(DEATH_EFFECT_TAG);
+    this->setVisible(false);
+
+    return true;
+}
+
+void SimpleDeathEffect::play(CCPoint pos, ccColor3B color) {
+    m_color = ccc4FFromccc3B(color);
+    m_elapsed = 0.f;
+    m_playing = true;
+
+    this->setPosition(pos);
+    this->setVisible(true);
+    this->redraw();
+    this->scheduleUpdate();
+}
+
+void SimpleDeathEffect::stop() {
+    m_playing = false;
+    this->unscheduleUpdate();
+    this->clear();
+    this->setVisible(false);
+}
+
+bool SimpleDeathEffect::isPlaying() const {
+    return m_playing;
+}
+
+void SimpleDeathEffect::update(float dt) {
+    m_elapsed += dt;
+
+    if (m_elapsed >= SIMPLE_EFFECT_DURATION) {
+        this->stop();
+        return;
+    }
+
+    this->redraw();
+}
+
+void SimpleDeathEffect::redraw() {
+    float progress = std::clamp(m_elapsed / SIMPLE_EFFECT_DURATION, 0.f, 1.f);
+
+    // ease out, so the circle expands quickly and slows down
+    float eased = 1.f - (1.f - progress) * (1.f - progress);
+    float radius = std::lerp(SIMPLE_EFFECT_START_RADIUS, SIMPLE_EFFECT_END_RADIUS, eased);
+
+    auto color = m_color;
+    color.a = 0.8f * (1.f - progress);
+
+    this->clear();
+    this->drawDot(CCPoint{0.f, 0.f}, radius, color);
+}
+
+SimpleDeathEffect* SimpleDeathEffect::create() {
+    auto ret = new SimpleDeathEffect();
+    if (ret->init()) {
+        ret->autorelease();
+        return ret;
+    }
+    delete ret;
+    return nullptr;
+}
+
+DeathEffectPool::DeathEffectPool(CCNode* parentNode) : m_parentNode(parentNode) {}
+
+DeathEffectPool::~DeathEffectPool() {
+    this->clear();
+}
+
+DeathEffectTier DeathEffectPool::nextTier() {
+    unsigned int frame = CCDirector::get()->getTotalFrames();
+    if (frame != m_lastFrame) {
+        m_lastFrame = frame;
+        m_startedThisFrame = 0;
+    }
+
+    this->prune();
+
+    if (m_effects.size() < MAX_FULL_EFFECTS && m_startedThisFrame < MAX_FULL_EFFECTS_PER_FRAME) {
+        m_startedThisFrame++;
+
+        if (this->activeParticles() + PARTICLES_PER_EFFECT <= MAX_PARTICLES) {
+            return DeathEffectTier::Full;
+        } else {
+            return DeathEffectTier::Reduced;
+        }
+    }
+
+    bool simpleAvailable = m_simple.size() < MAX_SIMPLE_EFFECTS
+        || std::any_of(m_simple.begin(), m_simple.end(), [](auto& eff) { return !eff->isPlaying(); });
+
+    return simpleAvailable ? DeathEffectTier::Simple : DeathEffectTier::None;
+}
+
+void DeathEffectPool::trackEffect(const std::vector<CCNode*>& nodes, DeathEffectTier tier) {
+    TrackedEffect effect;
+    effect.nodes.reserve(nodes.size());
+
+    for (auto node : nodes) {
+        effect.nodes.push_back(node);
+        collectParticles(node, effect.particles);
+    }
+
+    if (tier == DeathEffectTier::Reduced) {
+        for (auto& ps : effect.particles) {
+            ps->removeFromParent();
+        }
+        effect.particles.clear();
+    }
+
+    m_effects.push_back(std::move(effect));
+}
+
+CCParticleSystemQuad* DeathEffectPool::emptyParticles() {
+    for (auto& ps : m_emptyParticles) {
+        if (!ps->getParent()) {
+            return ps;
+        }
+    }
+
+    // emission rate is zero, so nothing is ever emitted no matter how the effect sets it up
+    auto ps = CCParticleSystemQuad::createWithTotalParticles(1);
+    m_emptyParticles.push_back(ps);
+    return ps;
+}
+
+bool DeathEffectPool::playSimple(CCPoint pos, ccColor3B color) {
+    SimpleDeathEffect* effect = nullptr;
+
+    for (auto& eff : m_simple) {
+        if (!eff->isPlaying()) {
+            effect = eff;
+            break;
+        }
+    }
+
+    if (!effect) {
+        if (m_simple.size() >= MAX_SIMPLE_EFFECTS || !m_parentNode) {
+            return false;
+        }
+
+        effect = SimpleDeathEffect::create();
+        m_parentNode->addChild(effect);
+        m_simple.push_back(effect);
+    }
+
+    effect->play(pos, color);
+    return true;
+}
+
+void DeathEffectPool::clear() {
+    for (auto& eff : m_simple) {
+        eff->stop();
+        eff->removeFromParent();
+    }
+
+    m_simple.clear();
+    m_effects.clear();
+    m_emptyParticles.clear();
+}
+
+size_t DeathEffectPool::activeEffects() {
+    this->prune();
+
+    size_t simple = std::count_if(m_simple.begin(), m_simple.end(), [](auto& eff) { return eff->isPlaying(); });
+    return m_effects.size() + simple;
+}
+
+size_t DeathEffectPool::activeParticles() {
+    size_t count = 0;
+
+    for (auto& effect : m_effects) {
+        for (auto& ps : effect.particles) {
+            if (ps->getParent()) {
+                count += ps->getParticleCount();
+            }
+        }
+    }
+
+    return count;
+}
+
+void DeathEffectPool::prune() {
+    std::erase_if(m_effects, [](const TrackedEffect& effect) {
+        return std::none_of(effect.nodes.begin(), effect.nodes.end(), [](auto& node) {
+            return node->getParent() != nullptr;
+        });
+    });
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <globed/prelude.hpp>
+#include <Geode/Geode.hpp>
+#include <vector>
+
+namespace globed {
+
+/// How a single death effect should be played, picked by `DeathEffectPool` based on how many effects are active
+enum class DeathEffectTier {
+    /// Full death effect, same as in vanilla
+    Full,
+    /// Vanilla death effect without particles, its particle systems are replaced with pooled empty ones
+    Reduced,
+    /// Cheap pooled circle, no nodes are created
+    Simple,
+    /// Nothing is played at all
+    None,
+};
+
+/// Lightweight death effect, an expanding and fading circle that is reused between deaths.
+class SimpleDeathEffect : public cocos2d::CCDrawNode {
+public:
+    static SimpleDeathEffect* create();
+
+    void play(cocos2d::CCPoint pos, cocos2d::ccColor3B color);
+    void stop();
+    bool isPlaying() const;
+    void update(float dt) override;
+
+private:
+    cocos2d::ccColor4F m_color{};
+    float m_elapsed = 0.f;
+    bool m_playing = false;
+
+    bool init() override;
+    void redraw();
+};
+
+/// Keeps track of all death effects of remote players in a level, and enforces a budget on how many can be active at once.
+/// When a lot of players die at the same time (deathlink, hard levels), effects degrade to cheaper versions instead of
+/// creating dozens of particle systems in the same frame.
+class DeathEffectPool {
+public:
+    DeathEffectPool(cocos2d::CCNode* parentNode);
+    ~DeathEffectPool();
+    GLOBED_NOCOPY(DeathEffectPool);
+    GLOBED_NOMOVE(DeathEffectPool);
+
+    /// Picks the tier for a new death effect. Should be called right before playing it.
+    DeathEffectTier nextTier();
+
+    /// Registers the nodes created by a vanilla death effect. If the effect was played as `Reduced`,
+    /// all particle systems are removed.
+    void trackEffect(const std::vector<cocos2d::CCNode*>& nodes, DeathEffectTier tier);
+
+    /// Returns a particle system that never emits anything, created in place of the particles of a `Reduced` effect.
+    /// They are reused once `trackEffect` removes them from the effect.
+    cocos2d::CCParticleSystemQuad* emptyParticles();
+
+    /// Plays a simple death effect. Returns false if all pooled effects are currently in use.
+    bool playSimple(cocos2d::CCPoint pos, cocos2d::ccColor3B color);
+
+    /// Stops all effects and destroys the pooled nodes
+    void clear();
+
+    size_t activeEffects();
+    size_t activeParticles();
+
+private:
+    struct TrackedEffect {
+        std::vector<Ref<cocos2d::CCNode>> nodes;
+        std::vector<Ref<cocos2d::CCParticleSystem>> particles;
+    };
+
+    cocos2d::CCNode* m_parentNode;
+    std::vector<TrackedEffect> m_effects;
+    std::vector<Ref<SimpleDeathEffect>> m_simple;
+    std::vector<Ref<cocos2d::CCParticleSystemQuad>> m_emptyParticles;
+    unsigned int m_lastFrame = 0;
+    size_t m_startedThisFrame = 0;
+
+    void prune();
+};
+
+}
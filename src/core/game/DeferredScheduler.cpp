@@ -0,0 +1,116 @@
+#include "DeferredScheduler.hpp"
+#include <algorithm>
+
+using namespace asp::time;
+
+namespace globed {
+
+void DeferredScheduler::schedule(
+    int playerId,
+    DeferredTaskKind kind,
+    DeferredTaskPriority priority,
+    Duration maxDelay,
+    Func&& func
+) {
+    for (auto& task : m_tasks) {
+        if (task.playerId == playerId && task.kind == kind) {
+            // keep the original deadline, so that rescheduling can't postpone the task forever
+            task.func = std::move(func);
+            task.priority = std::min(task.priority, priority);
+            return;
+        }
+    }
+
+    m_tasks.push_back(Task {
+        .playerId = playerId,
+        .kind = kind,
+        .priority = priority,
+        .deadline = Instant::now() + maxDelay,
+        .seq = m_nextSeq++,
+        .func = std::move(func),
+    });
+}
+
+size_t DeferredScheduler::run(Duration budget, const std::vector<int>* onScreen) {
+    if (m_tasks.empty()) return 0;
+
+    auto start = Instant::now();
+
+    // tasks may schedule more tasks while running, so move them out first
+    m_running.clear();
+    std::swap(m_running, m_tasks);
+
+    auto isOnScreen = [&](const Task& task) {
+        return !onScreen || std::binary_search(onScreen->begin(), onScreen->end(), task.playerId);
+    };
+
+    // overdue tasks first, then on screen players, then by priority, deadline and insertion order
+    std::sort(m_running.begin(), m_running.end(), [&](const Task& a, const Task& b) {
+        bool aOverdue = a.deadline <= start, bOverdue = b.deadline <= start;
+        if (aOverdue != bOverdue) return aOverdue;
+
+        bool aVisible = isOnScreen(a), bVisible = isOnScreen(b);
+        if (aVisible != bVisible) return aVisible;
+
+        if (a.priority != b.priority) return a.priority < b.priority;
+        if (a.deadline != b.deadline) return a.deadline < b.deadline;
+        return a.seq < b.seq;
+    });
+
+    size_t executed = 0;
+    for (auto& task : m_running) {
+        bool overdue = task.deadline <= start;
+        if (!overdue && start.elapsed() >= budget) {
+            break;
+        }
+
+        auto func = std::move(task.func);
+        executed++;
+        func();
+    }
+
+    // put back everything that did not run, before the tasks that were scheduled during execution
+    m_running.erase(m_running.begin(), m_running.begin() + executed);
+
+    for (auto& task : m_tasks) {
+        bool merged = false;
+        for (auto& old : m_running) {
+            if (old.playerId == task.playerId && old.kind == task.kind) {
+                old.func = std::move(task.func);
+                merged = true;
+                break;
+            }
+        }
+
+        if (!merged) {
+            m_running.push_back(std::move(task));
+        }
+    }
+
+    std::swap(m_running, m_tasks);
+    m_running.clear();
+
+    return executed;
+}
+
+void DeferredScheduler::cancel(int playerId) {
+    std::erase_if(m_tasks, [&](const Task& task) {
+        return task.playerId == playerId;
+    });
+}
+
+void DeferredScheduler::clear() {
+    m_tasks.clear();
+}
+
+bool DeferredScheduler::isPending(int playerId, DeferredTaskKind kind) const {
+    return std::any_of(m_tasks.begin(), m_tasks.end(), [&](const Task& task) {
+        return task.playerId == playerId && task.kind == kind;
+    });
+}
+
+size_t DeferredScheduler::size() const {
+    return m_tasks.size();
+}
+
+}
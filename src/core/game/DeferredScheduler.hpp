@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Geode/utils/function.hpp>
+#include <asp/time/Duration.hpp>
+#include <asp/time/Instant.hpp>
+#include <vector>
+
+namespace globed {
+
+enum class DeferredTaskKind : uint8_t {
+    InitData,
+    UpdateTeam,
+};
+
+enum class DeferredTaskPriority : uint8_t {
+    High = 0,
+    Normal = 1,
+    Low = 2,
+};
+
+/// Scheduler for expensive per-player work (display data initialization, team updates).
+/// Instead of running immediately when triggered, tasks are executed within a per-frame time budget,
+/// players that are on screen go first. A task that reaches its deadline is executed regardless of the budget.
+class DeferredScheduler {
+public:
+    using Func = geode::Function<void()>;
+
+    /// Schedules a task. Only one task of each kind can be pending per player, scheduling another one replaces the function of the old one.
+    void schedule(
+        int playerId,
+        DeferredTaskKind kind,
+        DeferredTaskPriority priority,
+        asp::time::Duration maxDelay,
+        Func&& func
+    );
+
+    /// Runs tasks until the budget is exhausted. `onScreen` is the sorted list of players near the camera, or nullptr if every player should be considered on screen.
+    /// Returns the amount of executed tasks.
+    size_t run(asp::time::Duration budget, const std::vector<int>* onScreen);
+
+    /// Removes all pending tasks for this player
+    void cancel(int playerId);
+    void clear();
+
+    bool isPending(int playerId, DeferredTaskKind kind) const;
+    size_t size() const;
+
+private:
+    struct Task {
+        int playerId;
+        DeferredTaskKind kind;
+        DeferredTaskPriority priority;
+        asp::time::Instant deadline;
+        uint64_t seq;
+        Func func;
+    };
+
+    std::vector<Task> m_tasks;
+    std::vector<Task> m_running;
+    uint64_t m_nextSeq = 0;
+};
+
+}
@@ -1,16 +1,25 @@
 #include "Interpolator.hpp"
 #include <globed/util/algo.hpp>
 #include <globed/core/ValueManager.hpp>
+#include <util/BinLog.hpp>
 
+// lerp logs go to the binary log when it's enabled, since text logging is far too slow for this many messages.
+// in release builds they can only go to the binary log.
 #ifdef GLOBED_DEBUG
-# define LERP_LOG(...) if (::lerpDebug()) log::debug("[LERP] " __VA_ARGS__)
+# define LERP_LOG(...) do { \
+    if (::lerpDebug()) { \
+        if (::globed::BinLog::enabled()) GLOBED_BINLOG("[LERP] " __VA_ARGS__); \
+        else log::debug("[LERP] " __VA_ARGS__); \
+    } \
+} while (0)
 #else
-# define LERP_LOG(...) do {} while (0)
+# define LERP_LOG(...) do { if (::lerpDebug()) GLOBED_BINLOG("[LERP] " __VA_ARGS__); } while (0)
 #endif
 
-constexpr float TIME_DRIFT_THRESHOLD = 0.25f; // 250ms
-constexpr float TIME_DRIFT_SMALL_THRESHOLD = 0.10f; // 100ms
-constexpr float TIME_DRIFT_SMALL_ADJ_DEADLINE = 30.0f; // 30s
+constexpr globed::PlayerTimestamp TIME_DRIFT_THRESHOLD = globed::timestampFromSecs(0.25); // 250ms
+constexpr globed::PlayerTimestamp TIME_DRIFT_SMALL_THRESHOLD = globed::timestampFromSecs(0.10); // 100ms
+constexpr globed::PlayerTimestamp TIME_DRIFT_SMALL_ADJ_DEADLINE = globed::timestampFromSecs(30.0); // 30s
+constexpr globed::PlayerTimestamp HUGE_LAG_THRESHOLD = globed::timestampFromSecs(1.0); // 1s
 constexpr bool DO_EXTRAPOLATE = false;
 
 using namespace geode::prelude;
@@ -22,6 +31,11 @@ static inline bool lerpDebug() {
 
 namespace globed {
 
+// player states carry float seconds, all time math is done on integer timestamps
+static inline PlayerTimestamp frameTime(const PlayerState& state) {
+    return timestampFromWire(state.timestamp);
+}
+
 void Interpolator::addPlayer(int playerId) {
     m_players.emplace(playerId, LerpState{});
 }
@@ -55,7 +69,7 @@ static std::optional<SpiderTeleportData> detectSpiderTp(const PlayerObjectData&
     return data;
 }
 
-void Interpolator::updatePlayer(const PlayerState& player, float curTimestamp) {
+void Interpolator::updatePlayer(const PlayerState& player, PlayerTimestamp curTimestamp) {
     auto it = m_players.find(player.accountId);
     if (it == m_players.end()) {
         log::warn("Received update for unknown player {}", player.accountId);
@@ -98,13 +112,13 @@ void Interpolator::updatePlayer(const PlayerState& player, float curTimestamp) {
 
     // assert that the frame is newer than the last one
     if (!state.frames.empty() && !ignoreRepeated) {
-        float timeDifference = player.timestamp - state.newestFrame().timestamp;
-        if (timeDifference <= 0.f) {
+        PlayerTimestamp timeDifference = frameTime(player) - frameTime(state.newestFrame());
+        if (timeDifference <= 0) {
             LERP_LOG("!! Frame for {} is not newer than the last one: {} <= {}",
                 player.accountId, player.timestamp, state.newestFrame().timestamp
             );
 
-            if (timeDifference < -1.f) {
+            if (timeDifference < -HUGE_LAG_THRESHOLD) {
                 // more than 1 second behind, increment huge lag counter
                 state.hugeLagCounter++;
 
@@ -135,9 +149,9 @@ void Interpolator::updatePlayer(const PlayerState& player, float curTimestamp) {
 
     // account for potential drift in time
     if (state.frames.size() >= 2) {
-        float sinceLastCorrection = state.timeCounter - state.lastDriftCorrection;
+        PlayerTimestamp sinceLastCorrection = state.timeCounter - state.lastDriftCorrection;
 
-        float drift = state.newestFrame().timestamp - state.timeCounter;
+        PlayerTimestamp drift = frameTime(state.newestFrame()) - state.timeCounter;
         bool smallDrift = std::abs(drift) > TIME_DRIFT_SMALL_THRESHOLD;
         bool largeDrift = m_lowLatency ? smallDrift : std::abs(drift) > TIME_DRIFT_THRESHOLD;
 
@@ -151,15 +165,17 @@ void Interpolator::updatePlayer(const PlayerState& player, float curTimestamp) {
 
         // in realtime mode, always adjust. this *will* lead to poor visuals.
         if (m_realtime || doAdjust) {
-            float newTs = state.frames[state.frames.size() - 2].timestamp;
-            LERP_LOG("!! Time drift for {} ({:.3f}s), resetting {} -> {}", player.accountId, drift, state.timeCounter, newTs);
+            PlayerTimestamp newTs = frameTime(state.frames[state.frames.size() - 2]);
+            LERP_LOG("!! Time drift for {} ({:.3f}s), resetting {:.3f} -> {:.3f}",
+                player.accountId, timestampToSecs(drift), timestampToSecs(state.timeCounter), timestampToSecs(newTs)
+            );
             state.timeCounter = newTs;
             state.lastDriftCorrection = state.timeCounter;
         }
     }
 }
 
-void Interpolator::updateNoop(int accountId, float curTimestamp) {
+void Interpolator::updateNoop(int accountId, PlayerTimestamp curTimestamp) {
     auto& state = m_players.at(accountId);
     state.updatedAt = curTimestamp;
 }
@@ -363,7 +379,7 @@ static inline void lerpPlayer(
     }
 }
 
-void Interpolator::tick(float dt, CCPoint cameraDelta, CCPoint cameraVector) {
+void Interpolator::tick(PlayerTimestamp dt, CCPoint cameraDelta, CCPoint cameraVector) {
     if (cameraDelta.isZero()) {
         m_stationaryFrames++;
     } else {
@@ -381,7 +397,7 @@ void Interpolator::tick(float dt, CCPoint cameraDelta, CCPoint cameraVector) {
             auto& a = player.frames[i];
             auto& b = player.frames[i + 1];
 
-            if (a.timestamp <= player.timeCounter && b.timestamp >= player.timeCounter) {
+            if (frameTime(a) <= player.timeCounter && frameTime(b) >= player.timeCounter) {
                 older = &a;
                 newer = &b;
                 break;
@@ -390,7 +406,7 @@ void Interpolator::tick(float dt, CCPoint cameraDelta, CCPoint cameraVector) {
 
         if (!older || !newer) {
             // possibly the next frame is delayed, we may need to extrapolate
-            if (player.timeCounter >= player.newestFrame().timestamp) {
+            if (player.timeCounter >= frameTime(player.newestFrame())) {
                 if (DO_EXTRAPOLATE) {
                     older = &player.frames[player.frames.size() - 2]; // the one right before the newest
                     newer = &player.newestFrame();
@@ -398,7 +414,7 @@ void Interpolator::tick(float dt, CCPoint cameraDelta, CCPoint cameraVector) {
                     // rather than extrapolation, wait for a new frame.
                     continue;
                 }
-            } else if (player.timeCounter < player.oldestFrame().timestamp) {
+            } else if (player.timeCounter < frameTime(player.oldestFrame())) {
                 older = &player.oldestFrame();
                 newer = &player.frames[1]; // the one right after the oldest
             }
@@ -422,8 +438,8 @@ void Interpolator::tick(float dt, CCPoint cameraDelta, CCPoint cameraVector) {
             player.frames.pop_front();
         }
 
-        float frameDelta = newer->timestamp - older->timestamp;
-        float t = frameDelta == 0.0f ? 0.0f : (player.timeCounter - older->timestamp) / frameDelta;
+        PlayerTimestamp frameDelta = frameTime(*newer) - frameTime(*older);
+        float t = frameDelta == 0 ? 0.0f : (float)((double)(player.timeCounter - frameTime(*older)) / (double)frameDelta);
 
         LerpContext ctx {
             *older,
@@ -438,7 +454,10 @@ void Interpolator::tick(float dt, CCPoint cameraDelta, CCPoint cameraVector) {
         lerpPlayer(ctx, player);
 
         LERP_LOG("{}: t = {:.3f}, timeCounter = {:.3f}, time = {:.3f} -> {:.3f}",
-            playerId, t, player.timeCounter, older->timestamp, newer->timestamp
+            playerId, t,
+            timestampToSecs(player.timeCounter),
+            older->timestamp,
+            newer->timestamp
         );
         if (older->player1 && newer->player1) {
             LERP_LOG("pos: ({:.4f}, {:.4f}) -> ({:.4f}, {:.4f})",
@@ -463,17 +482,21 @@ PlayerState& Interpolator::getPlayerState(int playerId, PlayerStateFlags& flags)
     return player.interpolatedState;
 }
 
+const PlayerState& Interpolator::peekPlayerState(int playerId) const {
+    return m_players.at(playerId).interpolatedState;
+}
+
 PlayerState& Interpolator::getNewerState(int playerId) {
     return m_players.at(playerId).newestFrame();
 }
 
-bool Interpolator::isPlayerStale(int playerId, float curTimestamp) {
+bool Interpolator::isPlayerStale(int playerId, PlayerTimestamp curTimestamp) {
     auto& state = m_players.at(playerId);
     if (state.totalFrames < 2) {
         return false;
     }
 
-    return std::abs(state.updatedAt - curTimestamp) > 0.5f;
+    return std::abs(state.updatedAt - curTimestamp) > timestampFromSecs(0.5);
 }
 
 void Interpolator::setLowLatencyMode(bool enable) {
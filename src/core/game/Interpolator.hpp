@@ -1,6 +1,7 @@
 #pragma once
 
 #include <globed/core/data/PlayerState.hpp>
+#include <globed/util/FlatIntMap.hpp>
 #include "SpeedTracker.hpp"
 #include <deque>
 #include <optional>
@@ -15,13 +16,15 @@ public:
     void removePlayer(int playerId);
     void resetPlayer(int playerId);
     bool hasPlayer(int playerId) const;
-    void updatePlayer(const PlayerState& player, float curTimestamp);
-    void updateNoop(int accountId, float curTimestamp);
-    void tick(float dt, cocos2d::CCPoint cameraDelta, cocos2d::CCPoint cameraVector);
+    void updatePlayer(const PlayerState& player, PlayerTimestamp curTimestamp);
+    void updateNoop(int accountId, PlayerTimestamp curTimestamp);
+    void tick(PlayerTimestamp dt, cocos2d::CCPoint cameraDelta, cocos2d::CCPoint cameraVector);
 
     PlayerState& getPlayerState(int playerId, PlayerStateFlags& outFlags);
+    /// Same as `getPlayerState`, but doesn't consume any pending events (deaths, jumps, teleports)
+    const PlayerState& peekPlayerState(int playerId) const;
     PlayerState& getNewerState(int playerId);
-    bool isPlayerStale(int playerId, float curTimestamp);
+    bool isPlayerStale(int playerId, PlayerTimestamp curTimestamp);
 
     // settings
 
@@ -51,9 +54,9 @@ public:
         std::optional<PlayerDeath> lastDeath;
         std::optional<SpiderTeleportData> lastSpiderTp1, lastSpiderTp2;
         uint8_t lastDeathCount = 0;
-        float timeCounter = -100.0f;
-        float lastDriftCorrection = -100.0f;
-        float updatedAt = 0.0f;
+        PlayerTimestamp timeCounter = timestampFromSecs(-100.0);
+        PlayerTimestamp lastDriftCorrection = timestampFromSecs(-100.0);
+        PlayerTimestamp updatedAt = 0;
         size_t hugeLagCounter = 0;
 
         std::optional<PlayerDeath> takeDeath();
@@ -64,7 +67,7 @@ public:
     };
 
 private:
-    std::unordered_map<int, LerpState> m_players;
+    FlatIntMap<LerpState> m_players;
     size_t m_stationaryFrames = 0;
     bool m_realtime = false;
     bool m_lowLatency = false;
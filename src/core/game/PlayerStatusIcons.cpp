@@ -1,4 +1,5 @@
 #include <globed/core/game/PlayerStatusIcons.hpp>
+#include <core/game/StatusIconBatch.hpp>
 
 #include <cue/Util.hpp>
 #include <UIBuilder.hpp>
@@ -7,10 +8,24 @@ using namespace geode::prelude;
 
 namespace globed {
 
-bool PlayerStatusIcons::init(unsigned char opacity) {
+static constexpr float ICON_GAP = 6.5f;
+static constexpr float BG_HEIGHT = 40.f;
+
+PlayerStatusIcons::~PlayerStatusIcons() {
+    if (m_batchRoot) {
+        m_batchRoot->removeFromParent();
+    }
+}
+
+bool PlayerStatusIcons::init(unsigned char opacity, StatusIconBatch* batch) {
     if (!CCNode::init()) return false;
 
     m_opacity = opacity;
+    m_batch = batch;
+
+    if (m_batch) {
+        m_batchRoot = m_batch->createRoot();
+    }
 
     this->updateStatus(PlayerStatusFlags{}, true);
 
@@ -24,6 +39,11 @@ void PlayerStatusIcons::updateStatus(const PlayerStatusFlags& flags, bool force)
 
     m_flags = flags;
 
+    if (m_batch) {
+        this->updateBatched(flags);
+        return;
+    }
+
     this->removeAllChildren();
 
     if (!flags.paused && !flags.practicing && !flags.speaking && !flags.editing && !flags.speakingMuted) {
@@ -32,7 +52,7 @@ void PlayerStatusIcons::updateStatus(const PlayerStatusFlags& flags, bool force)
 
     m_iconWrapper = Build<CCNode>::create()
         .anchorPoint(0.f, 0.5f)
-        .layout(RowLayout::create()->setGap(6.5f)->setAutoScale(false))
+        .layout(RowLayout::create()->setGap(ICON_GAP)->setAutoScale(false))
         .parent(this);
 
     CCSize iconSize{24.f, 24.f};
@@ -83,7 +103,7 @@ void PlayerStatusIcons::updateStatus(const PlayerStatusFlags& flags, bool force)
     width += static_cast<RowLayout*>(m_iconWrapper->getLayout())->getGap() * (count - 1);
 
     auto cc9s = Build<CCScale9Sprite>::create("square02_001.png")
-        .contentSize({ width * 3.f, 40.f * 3.f })
+        .contentSize({ width * 3.f, BG_HEIGHT * 3.f })
         .scale(1.f / 3.f)
         .opacity(m_opacity / 3)
         .zOrder(-1)
@@ -97,10 +117,98 @@ void PlayerStatusIcons::updateStatus(const PlayerStatusFlags& flags, bool force)
     m_iconWrapper->updateLayout();
 }
 
+void PlayerStatusIcons::updateBatched(const PlayerStatusFlags& flags) {
+    m_batchRoot->removeAllChildrenWithCleanup(true);
+
+    std::vector<CCSprite*> icons;
+
+    if (flags.paused) {
+        icons.push_back(m_batch->createIcon(StatusIcon::Paused));
+    }
+
+    if (flags.practicing) {
+        icons.push_back(m_batch->createIcon(StatusIcon::Practice));
+    }
+
+    if (flags.speaking) {
+        icons.push_back(m_batch->createIcon(flags.speakingMuted ? StatusIcon::SpeakingMuted : StatusIcon::Speaking));
+    }
+
+    if (flags.editing) {
+        icons.push_back(m_batch->createIcon(StatusIcon::Editing));
+    }
+
+    if (icons.empty()) {
+        this->setContentSize(CCSizeZero);
+        this->syncBatchRoot();
+        return;
+    }
+
+    // same layout as the unbatched row layout: icons centered vertically, with 10 units of space on both sides
+    float width = 20.f + ICON_GAP * (icons.size() - 1);
+    for (auto icon : icons) {
+        width += icon->getContentWidth();
+    }
+
+    float x = 10.f;
+    for (auto icon : icons) {
+        icon->setAnchorPoint({0.f, 0.5f});
+        icon->setPosition({x, BG_HEIGHT / 2.f});
+        icon->setOpacity(m_opacity);
+        m_batchRoot->addChild(icon, 1);
+
+        x += icon->getContentWidth() + ICON_GAP;
+    }
+
+    m_batch->addBackground(m_batchRoot, {width, BG_HEIGHT}, m_opacity / 3);
+
+    this->setContentSize({width, BG_HEIGHT});
+    this->syncBatchRoot();
+}
+
+void PlayerStatusIcons::syncBatchRoot() {
+    if (!m_batchRoot) return;
+
+    // the root mirrors the transform of this node, the batch must be a sibling of this node
+    m_batchRoot->setVisible(m_bVisible);
+    m_batchRoot->setContentSize(m_obContentSize);
+    m_batchRoot->setAnchorPoint(m_obAnchorPoint);
+    m_batchRoot->setPosition(m_obPosition);
+    m_batchRoot->setRotationX(m_fRotationX);
+    m_batchRoot->setRotationY(m_fRotationY);
+    m_batchRoot->setScaleX(m_fScaleX);
+    m_batchRoot->setScaleY(m_fScaleY);
+}
+
 void PlayerStatusIcons::setOpacity(unsigned char opacity) {
     m_opacity = opacity;
 }
 
+void PlayerStatusIcons::setPosition(const CCPoint& pos) {
+    CCNode::setPosition(pos);
+    if (m_batchRoot) m_batchRoot->setPosition(pos);
+}
+
+void PlayerStatusIcons::setRotation(float rot) {
+    CCNode::setRotation(rot);
+    if (m_batchRoot) m_batchRoot->setRotation(rot);
+}
+
+void PlayerStatusIcons::setScale(float scale) {
+    CCNode::setScale(scale);
+    if (m_batchRoot) m_batchRoot->setScale(scale);
+}
+
+void PlayerStatusIcons::setAnchorPoint(const CCPoint& point) {
+    CCNode::setAnchorPoint(point);
+    if (m_batchRoot) m_batchRoot->setAnchorPoint(point);
+}
+
+void PlayerStatusIcons::setVisible(bool visible) {
+    CCNode::setVisible(visible);
+    if (m_batchRoot) m_batchRoot->setVisible(visible);
+}
+
 PlayerStatusIcons* PlayerStatusIcons::create(unsigned char opacity) {
     auto ret = new PlayerStatusIcons();
     if (ret->init(opacity)) {
@@ -112,4 +220,15 @@ PlayerStatusIcons* PlayerStatusIcons::create(unsigned char opacity) {
     return nullptr;
 }
 
+PlayerStatusIcons* PlayerStatusIcons::createBatched(unsigned char opacity, StatusIconBatch* batch) {
+    auto ret = new PlayerStatusIcons();
+    if (ret->init(opacity, batch)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
+
 }
\ No newline at end of file
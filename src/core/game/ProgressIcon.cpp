@@ -1,6 +1,7 @@
 #include <globed/core/game/ProgressIcon.hpp>
 #include <globed/core/SettingsManager.hpp>
 #include <globed/util/singleton.hpp>
+#include <core/game/ProgressIconBatch.hpp>
 
 #include <UIBuilder.hpp>
 #include <cue/Util.hpp>
@@ -9,17 +10,49 @@ using namespace geode::prelude;
 
 namespace globed {
 
-bool ProgressIcon::init() {
+static const CCPoint ICON_POS{0.f, -10.f};
+static const CCPoint LINE_POS{0.f, 5.f};
+static const CCSize LINE_SIZE{2.f, 6.f};
+
+ProgressIcon::~ProgressIcon() {
+    if (m_iconCell) {
+        if (auto batch = m_batch.lock()) {
+            static_cast<ProgressIconBatch*>(batch.data())->releaseIcon(*m_iconCell);
+        }
+    }
+
+    if (m_batchRoot) {
+        m_batchRoot->removeFromParent();
+    }
+}
+
+bool ProgressIcon::init(ProgressIconBatch* batch) {
     if (!CCNode::init()) return false;
 
+    if (batch) {
+        m_batch = batch;
+        m_batchRoot = batch->createRoot();
+
+        m_batchLine = batch->createLine(LINE_SIZE);
+        m_batchLine->setAnchorPoint({0.f, 0.f});
+        m_batchLine->setPosition(LINE_POS);
+        m_batchLine->setColor({0, 0, 0});
+        m_batchLine->setOpacity(0);
+        m_batchRoot->addChild(m_batchLine);
+
+        this->updateBatchedIcons(cue::Icons{});
+        this->syncBatchRoot();
+        return true;
+    }
+
     m_icon = Build(LazyPlayerIcon::create(cue::Icons{}))
         .scale(0.5f)
         .anchorPoint(0.5f, 0.5f)
-        .pos(0.f, -10.f)
+        .pos(ICON_POS)
         .parent(this);
 
-    m_line = Build<CCLayerColor>::create(ccColor4B{0, 0, 0, 0}, 2.f, 6.f)
-        .pos(0.f, 5.f)
+    m_line = Build<CCLayerColor>::create(ccColor4B{0, 0, 0, 0}, LINE_SIZE.width, LINE_SIZE.height)
+        .pos(LINE_POS)
         .parent(this);
 
     return true;
@@ -27,13 +60,61 @@ bool ProgressIcon::init() {
 
 void ProgressIcon::updateIcons(const cue::Icons& data) {
     auto col1 = singleton<GameManager>()->colorForIdx(data.color1);
-    m_line->setColor(col1);
-    m_line->setOpacity(255);
-    m_icon->updateIcons(data);
+
+    if (m_batchLine) {
+        m_batchLine->setColor(col1);
+        m_batchLine->setOpacity(255);
+        this->updateBatchedIcons(data);
+    } else {
+        m_line->setColor(col1);
+        m_line->setOpacity(255);
+        m_icon->updateIcons(data);
+    }
 
     this->recalcOpacity();
 }
 
+void ProgressIcon::updateBatchedIcons(const cue::Icons& data) {
+    auto batchRef = m_batch.lock();
+    if (!batchRef) return;
+    auto batch = static_cast<ProgressIconBatch*>(batchRef.data());
+
+    // acquire before releasing, so the cell is kept if the icons did not change
+    auto cell = batch->acquireIcon(data);
+    if (m_iconCell) {
+        batch->releaseIcon(*m_iconCell);
+    }
+    m_iconCell = cell;
+
+    if (cell) {
+        if (!m_batchIcon) {
+            m_batchIcon = batch->createIconSprite(*cell);
+            m_batchIcon->setPosition(ICON_POS);
+            m_batchRoot->addChild(m_batchIcon, -1);
+        } else {
+            batch->setIconSprite(m_batchIcon, *cell);
+        }
+
+        m_batchIcon->setVisible(true);
+        if (m_icon) m_icon->setVisible(false);
+        return;
+    }
+
+    // the atlas is full, fall back to a regular player icon
+    if (m_batchIcon) m_batchIcon->setVisible(false);
+
+    if (m_icon) {
+        m_icon->setVisible(true);
+        m_icon->updateIcons(data);
+    } else {
+        m_icon = Build(LazyPlayerIcon::create(data))
+            .scale(0.5f)
+            .anchorPoint(0.5f, 0.5f)
+            .pos(ICON_POS)
+            .parent(this);
+    }
+}
+
 void ProgressIcon::updatePosition(float progress, bool isPracticing) {
     auto parent = this->getParent()->getParent();
     if (!parent) return;
@@ -54,10 +135,30 @@ void ProgressIcon::updatePosition(float progress, bool isPracticing) {
     }
 
     this->setPositionX(prOffset);
+    this->syncBatchRoot();
+}
+
+void ProgressIcon::syncBatchRoot() {
+    if (!m_batchRoot) return;
+
+    // the root mirrors the transform of this node, the batch must be a sibling of this node
+    m_batchRoot->setVisible(m_bVisible);
+    m_batchRoot->setPosition(m_obPosition);
+
+    // CCNode::setZOrder does not resort children of a batch node, reorder through the batch instead
+    auto parent = m_batchRoot->getParent();
+    if (parent && m_batchRoot->getZOrder() != m_nZOrder) {
+        parent->reorderChild(m_batchRoot, m_nZOrder);
+    }
+}
+
+void ProgressIcon::setVisible(bool visible) {
+    CCNode::setVisible(visible);
+    if (m_batchRoot) m_batchRoot->setVisible(visible);
 }
 
 void ProgressIcon::toggleLine(bool enabled) {
-    m_line->setVisible(enabled);
+    (m_batchLine ? static_cast<CCNode*>(m_batchLine) : m_line)->setVisible(enabled);
 }
 
 void ProgressIcon::togglePracticeSprite(bool enabled) {
@@ -71,7 +172,10 @@ void ProgressIcon::setForceOnTop(bool state) {
 
 void ProgressIcon::recalcOpacity() {
     float progressOpacity = globed::setting<float>("core.level.progress-opacity");
-    m_icon->setOpacity(m_forceOnTop ? 255 : static_cast<uint8_t>(progressOpacity * 255));
+    auto opacity = m_forceOnTop ? 255 : static_cast<uint8_t>(progressOpacity * 255);
+
+    if (m_icon) m_icon->setOpacity(opacity);
+    if (m_batchIcon) m_batchIcon->setOpacity(opacity);
 }
 
 ProgressIcon* ProgressIcon::create() {
@@ -85,5 +189,15 @@ ProgressIcon* ProgressIcon::create() {
     return nullptr;
 }
 
+ProgressIcon* ProgressIcon::createBatched(ProgressIconBatch* batch) {
+    auto ret = new ProgressIcon;
+    if (ret->init(batch)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
 
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "ProgressIconBatch.hpp"
+
+using namespace geode::prelude;
+
+namespace globed {
+
+static const CCSize CELL_SIZE{24.f, 24.f};
+// the unbatched progress icon is a player icon at half scale
+static constexpr float ICON_SCALE = 0.5f;
+
+static bool sameIcons(const cue::Icons& a, const cue::Icons& b) {
+    return a.type == b.type
+        && a.id == b.id
+        && a.color1 == b.color1
+        && a.color2 == b.color2
+        && a.glowColor == b.glowColor;
+}
+
+bool ProgressIconBatch::init() {
+    m_atlas.emplace(CELL_SIZE, 10, 10);
+
+    if (!CCSpriteBatchNode::initWithTexture(m_atlas->getTexture(), 64)) return false;
+    m_atlas->setupBatchNode(this);
+
+    m_lineCell = *m_atlas->allocCell();
+    auto white = CCLayerColor::create(ccColor4B{255, 255, 255, 255}, CELL_SIZE.width, CELL_SIZE.height);
+    m_atlas->render(m_lineCell, white);
+
+    return true;
+}
+
+CCSprite* ProgressIconBatch::createRoot() {
+    auto root = CCSprite::createWithTexture(this->getTexture(), CCRect{});
+    root->setCascadeOpacityEnabled(false);
+    this->addChild(root);
+    return root;
+}
+
+CCSprite* ProgressIconBatch::createLine(CCSize size) {
+    // take the middle of the cell, edges may be blended with the transparent padding
+    CCRect rect{CELL_SIZE.width / 4.f, CELL_SIZE.height / 4.f, CELL_SIZE.width / 2.f, CELL_SIZE.height / 2.f};
+
+    auto spr = m_atlas->createSprite(m_lineCell, rect);
+    spr->setScaleX(size.width / rect.size.width);
+    spr->setScaleY(size.height / rect.size.height);
+    return spr;
+}
+
+std::optional<size_t> ProgressIconBatch::acquireIcon(const cue::Icons& icons) {
+    for (auto& entry : m_icons) {
+        if (sameIcons(entry.icons, icons)) {
+            entry.refs++;
+            return entry.cell;
+        }
+    }
+
+    auto cell = m_atlas->allocCell();
+    if (!cell) return std::nullopt;
+
+    auto icon = LazyPlayerIcon::create(icons);
+    icon->setScale(ICON_SCALE);
+    icon->setAnchorPoint({0.5f, 0.5f});
+    icon->setPosition({CELL_SIZE.width / 2.f, CELL_SIZE.height / 2.f});
+
+    // icons that are not loaded yet are rendered as the default icon first, and rendered again once loaded
+    icon->setUpdateCallback([this, cell = *cell, icon = icon] {
+        m_atlas->render(cell, icon);
+    });
+    m_atlas->render(*cell, icon);
+
+    m_icons.push_back(IconCell {
+        .icons = icons,
+        .cell = *cell,
+        .refs = 1,
+        .icon = icon,
+    });
+
+    return cell;
+}
+
+void ProgressIconBatch::releaseIcon(size_t cell) {
+    auto it = std::ranges::find_if(m_icons, [&](auto& entry) { return entry.cell == cell; });
+    if (it == m_icons.end()) return;
+
+    if (--it->refs == 0) {
+        it->icon->setUpdateCallback({});
+        m_atlas->freeCell(cell);
+        m_icons.erase(it);
+    }
+}
+
+CCSprite* ProgressIconBatch::createIconSprite(size_t cell) {
+    return m_atlas->createSprite(cell);
+}
+
+void ProgressIconBatch::setIconSprite(CCSprite* sprite, size_t cell) {
+    m_atlas->setSpriteCell(sprite, cell, CCRect{CCPointZero, CELL_SIZE});
+}
+
+ProgressIconBatch* ProgressIconBatch::create() {
+    auto ret = new ProgressIconBatch;
+    if (ret->init()) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <globed/prelude.hpp>
+#include <ui/misc/RenderAtlas.hpp>
+#include <ui/misc/LazyPlayerIcon.hpp>
+#include <Geode/Geode.hpp>
+
+namespace globed {
+
+/// Sprite batch that draws the progress bar icons of all players in a level in a single draw call.
+/// Player icons are rendered into an atlas, players with the same icons share the same cell.
+class ProgressIconBatch : public cocos2d::CCSpriteBatchNode {
+public:
+    static ProgressIconBatch* create();
+
+    /// Creates an empty sprite in the batch, that the sprites of a single `ProgressIcon` are added to
+    cocos2d::CCSprite* createRoot();
+    /// Creates a solid white sprite of the given size
+    cocos2d::CCSprite* createLine(cocos2d::CCSize size);
+
+    /// Returns the cell with these icons rendered into it, or `std::nullopt` if the atlas is full.
+    /// Every acquired cell must be released with `releaseIcon`.
+    std::optional<size_t> acquireIcon(const cue::Icons& icons);
+    void releaseIcon(size_t cell);
+
+    /// Creates a sprite displaying an icon cell, it has the same size as the unbatched progress icon
+    cocos2d::CCSprite* createIconSprite(size_t cell);
+    void setIconSprite(cocos2d::CCSprite* sprite, size_t cell);
+
+private:
+    struct IconCell {
+        cue::Icons icons;
+        size_t cell;
+        size_t refs;
+        geode::Ref<LazyPlayerIcon> icon;
+    };
+
+    std::optional<RenderAtlas> m_atlas;
+    std::vector<IconCell> m_icons;
+    size_t m_lineCell = 0;
+
+    bool init();
+};
+
+}
@@ -2,11 +2,13 @@
 #include <globed/core/SettingsManager.hpp>
 #include <globed/core/RoomManager.hpp>
 #include <globed/audio/AudioManager.hpp>
+#include <globed/audio/VoiceDecodePool.hpp>
 #include <globed/util/gd.hpp>
 #include <core/preload/PreloadManager.hpp>
 #include <core/hooks/GJBaseGameLayer.hpp>
 #include <core/game/Interpolator.hpp>
 #include <core/game/SettingCache.hpp>
+#include <core/game/VisualPlayerPool.hpp>
 #include <core/CoreImpl.hpp>
 
 #include <UIBuilder.hpp>
@@ -28,20 +30,36 @@ RemotePlayer::RemotePlayer(int playerId, GJBaseGameLayer* gameLayer, CCNode* par
     auto gjbgl = GlobedGJBGL::get(gameLayer);
     auto start = asp::Instant::now();
 
-    Build<VisualPlayer>::create(gameLayer, this, m_parentNode, false, playerId == 0)
-        .id(fmt::format("{}-player1", playerId).c_str())
-        .parent(m_parentNode)
-        .visible(false)
-        .store(m_player1);
+    // the local player is never pooled, as it's created only once
+    std::optional<VisualPlayerPool::Pair> pooled;
+    if (!m_localPlayer && gjbgl->m_fields->m_playerPool) {
+        m_pool = gjbgl->m_fields->m_playerPool;
+        pooled = gjbgl->m_fields->m_playerPool->acquire();
+    }
 
-    Build<VisualPlayer>::create(gameLayer, this, m_parentNode, true, playerId == 0)
-        .id(fmt::format("{}-player2", playerId).c_str())
-        .parent(m_parentNode)
-        .visible(false)
-        .store(m_player2);
+    if (pooled) {
+        m_player1 = std::move(pooled->player1);
+        m_player2 = std::move(pooled->player2);
+        m_player1->setID(fmt::format("{}-player1", playerId));
+        m_player2->setID(fmt::format("{}-player2", playerId));
+        m_player1->rebind(this);
+        m_player2->rebind(this);
+    } else {
+        Build<VisualPlayer>::create(gameLayer, this, m_parentNode, false, playerId == 0)
+            .id(fmt::format("{}-player1", playerId).c_str())
+            .parent(m_parentNode)
+            .visible(false)
+            .store(m_player1);
+
+        Build<VisualPlayer>::create(gameLayer, this, m_parentNode, true, playerId == 0)
+            .id(fmt::format("{}-player2", playerId).c_str())
+            .parent(m_parentNode)
+            .visible(false)
+            .store(m_player2);
+    }
 
     auto taken = start.elapsed();
-    log::trace("Created player in {}", taken);
+    log::trace("Created player in {} (pooled: {})", taken, pooled.has_value());
 #ifdef GLOBED_DEBUG
 #endif
 
@@ -61,7 +79,9 @@ RemotePlayer::RemotePlayer(int playerId, GJBaseGameLayer* gameLayer, CCNode* par
                 .parent(gjbgl->m_fields->m_uiNode);
 
         } else if (!plat && globed::setting<bool>("core.level.progress-indicators")) {
-            m_progIcon = Build<ProgressIcon>::create()
+            auto batch = gjbgl->m_fields->m_progressIconBatch;
+
+            m_progIcon = Build(batch ? ProgressIcon::createBatched(batch) : ProgressIcon::create())
                 .zOrder(2)
                 .id(fmt::format("remote-player-progress-{}"_spr, playerId))
                 .parent(gjbgl->m_fields->m_progressBarContainer);
@@ -125,6 +145,11 @@ RemotePlayer::~RemotePlayer() {
     cue::resetNode(m_progArrow);
     cue::resetNode(m_progIcon);
 
+    // try to return the visual players to the pool, otherwise destroy them
+    if (auto pool = m_pool.lock(); pool && pool->release(m_player1, m_player2)) {
+        return;
+    }
+
     m_player1->cleanupObjectLayer();
     m_player2->cleanupObjectLayer();
     m_player1->removeFromParent();
@@ -154,6 +179,8 @@ void RemotePlayer::update(const RemotePlayerUpdate& update) {
         .forceHideEverything = hideEverything,
         .forceVisibility = update.forceVisibility,
         .noCulling = update.noCulling,
+        .lod = update.lod,
+        .farBatch = update.farBatch,
     };
 
     if (m_state.player1) {
@@ -170,6 +197,34 @@ void RemotePlayer::update(const RemotePlayerUpdate& update) {
         m_player2->setVisible(false);
     }
 
+    this->updateShared(update, hideIcon, hideEverything);
+}
+
+void RemotePlayer::updateOffscreen(const RemotePlayerUpdate& update) {
+    bool forceHide = update.forceHide || m_forceHide;
+
+    m_state = update.state;
+
+    m_player1Culled = !m_state.player1;
+    m_player2Culled = !m_state.player2;
+
+    if (m_state.player1) {
+        m_player1->updateOffscreen(*m_state.player1);
+    } else {
+        m_player1->setVisible(false);
+    }
+
+    if (m_state.player2) {
+        m_player2->updateOffscreen(*m_state.player2);
+    } else {
+        m_player2->setVisible(false);
+    }
+
+    // progress icons and death handlers still need to run, visual effects will be skipped by the visual players
+    this->updateShared(update, forceHide, forceHide);
+}
+
+void RemotePlayer::updateShared(const RemotePlayerUpdate& update, bool hideIcon, bool hideEverything) {
     // update progress icons
 
     auto shownOrHide = [&](auto node, bool extraCond, auto&& onShown) {
@@ -321,6 +376,7 @@ bool RemotePlayer::isPlayer2Culled() {
 
 void RemotePlayer::stopVoiceStream() {
     if (m_voiceStream) {
+        VoiceDecodePool::get().removeRoute(m_state.accountId);
         m_voiceStream->stop();
     }
 }
@@ -331,7 +387,7 @@ VoiceStream* RemotePlayer::getVoiceStream() {
 
 void RemotePlayer::playVoiceData(EncodedAudioFrame frame) {
     if (!m_voiceStream) {
-        auto res = VoiceStream::create(weak_from_this());
+        auto res = VoiceStream::create(weak_from_this(), AudioManager::get().getVoiceMixer());
         if (!res) {
             log::error("Failed to create voice stream for player {}: {}", m_state.accountId, res.unwrapErr());
             return;
@@ -344,24 +400,15 @@ void RemotePlayer::playVoiceData(EncodedAudioFrame frame) {
         if (m_player1->m_isEditor) {
             m_voiceStream->setGlobal(true);
         }
-
-        m_voiceStreamMutex = std::make_shared<std::mutex>();
     }
 
-    // audio decoding can be expensive, so offload it to a blocking task
-    arc::spawnBlocking<void>([
-        stream = m_voiceStream,
-        mtx = m_voiceStreamMutex,
-        frame = std::move(frame),
-        id = m_state.accountId
-    ] mutable {
-        std::lock_guard lock(*mtx);
-        auto res = stream->writeData(frame);
-        if (!res) {
-            log::warn("Failed to play voice data for player {}: {}", id, res.unwrapErr());
-        }
-    });
+    VoiceDecodePool::get().submit(m_state.accountId, m_voiceStream, std::move(frame));
+}
 
+void RemotePlayer::routeVoiceData() {
+    if (m_voiceStream) {
+        VoiceDecodePool::get().addRoute(m_state.accountId, m_voiceStream);
+    }
 }
 
 }
@@ -25,6 +25,8 @@ struct CachedSettings {
     bool dualName = globed::setting<bool>("core.player.dual-name");
     bool rotateNames = globed::setting<bool>("core.player.rotate-names");
     bool defaultDeathEffects = globed::setting<bool>("core.player.default-death-effects");
+    bool lodEnabled = globed::setting<bool>("core.player.lod");
+    int lodBudget = globed::setting<int>("core.player.lod-budget");
     float playerOpacity = globed::setting<float>("core.player.opacity");
     float nameOpacity = globed::setting<float>("core.player.name-opacity");
     float emoteOpacity = globed::setting<float>("core.player.emote-opacity");
@@ -2,8 +2,8 @@
 
 namespace globed {
 
-std::pair<double, double> VectorSpeedTracker::pushMeasurement(float time, double x, double y) {
-    double dt = (double)(time - m_lastTime);
+std::pair<double, double> VectorSpeedTracker::pushMeasurement(PlayerTimestamp time, double x, double y) {
+    double dt = timestampToSecs(time - m_lastTime);
     if (dt == 0.0) {
         // first frame, we have nothing to go off of to measure speed
         return {0.0, 0.0};
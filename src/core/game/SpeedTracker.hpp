@@ -1,4 +1,5 @@
 #pragma once
+#include <globed/core/data/PlayerState.hpp>
 #include <deque>
 #include <qunet/util/algo.hpp>
 
@@ -7,19 +8,19 @@ namespace globed {
 class VectorSpeedTracker {
 public:
     // Push new measurement, return the delta
-    std::pair<double, double> pushMeasurement(float time, double x, double y);
+    std::pair<double, double> pushMeasurement(PlayerTimestamp time, double x, double y);
     std::pair<double, double> getVector();
 
 private:
     struct Measurement {
-        float time;
+        PlayerTimestamp time;
         double x, y;
     };
 
     std::pair<double, double> m_avgVector{};
     std::deque<Measurement> m_measurements;
-    float m_lastTime = 0.f;
-    float m_limit = 0.15f;
+    PlayerTimestamp m_lastTime = 0;
+    PlayerTimestamp m_limit = timestampFromSecs(0.15);
     double m_lastX = 0.f, m_lastY = 0.f;
     bool m_hasAverage = false;
 };
@@ -0,0 +1,111 @@
+#include "StatusIconBatch.hpp"
+
+using namespace geode::prelude;
+
+namespace globed {
+
+static const CCSize CELL_SIZE{32.f, 32.f};
+static constexpr float ICON_HEIGHT = 24.f;
+
+static CCSprite* createSourceSprite(StatusIcon icon) {
+    switch (icon) {
+        case StatusIcon::Paused: return CCSprite::createWithSpriteFrameName("GJ_pauseBtn_clean_001.png");
+        case StatusIcon::Practice: return CCSprite::createWithSpriteFrameName("checkpoint_01_001.png");
+        case StatusIcon::Speaking: return CCSprite::create("speaker-icon.png"_spr);
+        case StatusIcon::SpeakingMuted: return CCSprite::create("speaker-icon-mute.png"_spr);
+        case StatusIcon::Editing: return CCSprite::createWithSpriteFrameName("GJ_hammerIcon_001.png");
+    }
+
+    return nullptr;
+}
+
+bool StatusIconBatch::init() {
+    m_atlas.emplace(CELL_SIZE, 3, 2);
+
+    if (!CCSpriteBatchNode::initWithTexture(m_atlas->getTexture(), 64)) return false;
+    m_atlas->setupBatchNode(this);
+
+    for (size_t i = 0; i < ICON_COUNT; i++) {
+        // a fresh atlas hands out cells in order, so the cell of an icon is the same as its index
+        auto spr = createSourceSprite(static_cast<StatusIcon>(i));
+        size_t cell = *m_atlas->allocCell();
+        if (!spr) continue;
+
+        // same scale as the unbatched icons, unless the icon is too wide for the cell
+        float scale = ICON_HEIGHT / spr->getContentHeight();
+        scale = std::min(scale, CELL_SIZE.width / spr->getContentWidth());
+
+        spr->setAnchorPoint({0.f, 0.f});
+        spr->setScale(scale);
+        m_atlas->render(cell, spr);
+        m_iconSizes[i] = spr->getScaledContentSize();
+    }
+
+    // the unbatched background is a CCScale9Sprite scaled down to a third, render it at that scale
+    auto bg = CCSprite::create("square02_001.png");
+    m_bgCell = *m_atlas->allocCell();
+
+    if (bg) {
+        auto size = bg->getContentSize();
+        float scale = std::min({1.f / 3.f, CELL_SIZE.width / size.width, CELL_SIZE.height / size.height});
+
+        bg->setAnchorPoint({0.f, 0.f});
+        bg->setScale(scale);
+        m_atlas->render(m_bgCell, bg);
+
+        m_bgRenderedSize = bg->getScaledContentSize();
+        // corners of the scale9 sprite are a third of the texture, scaled down by a third
+        m_bgCornerSize = size / 9.f;
+    }
+
+    return true;
+}
+
+CCSprite* StatusIconBatch::createRoot() {
+    auto root = CCSprite::createWithTexture(this->getTexture(), CCRect{});
+    root->setCascadeOpacityEnabled(false);
+    this->addChild(root);
+    return root;
+}
+
+CCSprite* StatusIconBatch::createIcon(StatusIcon icon) {
+    auto idx = static_cast<size_t>(icon);
+    return m_atlas->createSprite(idx, CCRect{CCPointZero, m_iconSizes[idx]});
+}
+
+void StatusIconBatch::addBackground(CCSprite* root, CCSize size, GLubyte opacity) {
+    if (m_bgRenderedSize.width <= 0.f) return;
+
+    CCSize src = m_bgRenderedSize / 3.f;
+    CCSize corner = m_bgCornerSize;
+
+    float xs[3] = {0.f, corner.width, size.width - corner.width};
+    float ws[3] = {corner.width, std::max(size.width - corner.width * 2.f, 0.f), corner.width};
+    float ys[3] = {0.f, corner.height, size.height - corner.height};
+    float hs[3] = {corner.height, std::max(size.height - corner.height * 2.f, 0.f), corner.height};
+
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            auto piece = m_atlas->createSprite(m_bgCell, CCRect{src.width * i, src.height * j, src.width, src.height});
+            piece->setAnchorPoint({0.f, 0.f});
+            piece->setPosition({xs[i], ys[j]});
+            piece->setScaleX(ws[i] / src.width);
+            piece->setScaleY(hs[j] / src.height);
+            piece->setOpacity(opacity);
+            root->addChild(piece, -1);
+        }
+    }
+}
+
+StatusIconBatch* StatusIconBatch::create() {
+    auto ret = new StatusIconBatch;
+    if (ret->init()) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
+
+}
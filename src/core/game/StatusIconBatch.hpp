@@ -0,0 +1,42 @@
+#pragma once
+
+#include <globed/prelude.hpp>
+#include <ui/misc/RenderAtlas.hpp>
+#include <Geode/Geode.hpp>
+
+namespace globed {
+
+enum class StatusIcon : uint8_t {
+    Paused,
+    Practice,
+    Speaking,
+    SpeakingMuted,
+    Editing,
+};
+
+/// Sprite batch that draws the status icons of all players in a level in a single draw call.
+/// The icons and the background come from different textures, so they are rendered into a small atlas once on creation.
+class StatusIconBatch : public cocos2d::CCSpriteBatchNode {
+public:
+    static StatusIconBatch* create();
+
+    /// Creates an empty sprite in the batch, that the sprites of a single `PlayerStatusIcons` are added to
+    cocos2d::CCSprite* createRoot();
+    /// Creates an icon sprite, it has the same size as an unbatched status icon
+    cocos2d::CCSprite* createIcon(StatusIcon icon);
+    /// Adds the background of the icons to `root`, stretched the same way as the unbatched `CCScale9Sprite`
+    void addBackground(cocos2d::CCSprite* root, cocos2d::CCSize size, GLubyte opacity);
+
+private:
+    static constexpr size_t ICON_COUNT = 5;
+
+    std::optional<RenderAtlas> m_atlas;
+    std::array<cocos2d::CCSize, ICON_COUNT> m_iconSizes{};
+    size_t m_bgCell = 0;
+    cocos2d::CCSize m_bgRenderedSize;
+    cocos2d::CCSize m_bgCornerSize;
+
+    bool init();
+};
+
+}
@@ -10,6 +10,7 @@
 #include <ui/misc/NameLabel.hpp>
 #include <ui/game/EmoteBubble.hpp>
 #include <Geode/modify/CCScheduler.hpp>
+#include <Geode/modify/CCParticleSystemQuad.hpp>
 
 #include <UIBuilder.hpp>
 #include <cue/Util.hpp>
@@ -25,6 +26,8 @@ namespace $unity {
 
 static auto& g_settings = CachedSettings::get();
 static bool g_changeParticleUpdate = false;
+// set while a reduced death effect is played, particle systems it creates are taken from this pool instead
+static DeathEffectPool* g_reducedDeathEffect = nullptr;
 
 static inline bool lerpDebug() {
     static bool val = Loader::get()->getLaunchFlag("globed/core.dev.lerp-debug");
@@ -104,7 +107,10 @@ bool VisualPlayer::init(GJBaseGameLayer* gameLayer, RemotePlayer* rp, CCNode* pl
 
     m_forceHideName = !showName;
 
-    m_nameLabel = Build<NameLabel>::create("", "chatFont.fnt")
+    // names of all players are drawn by a single batch node if the level has one
+    auto nameBatch = GlobedGJBGL::get(gameLayer)->m_fields->m_nameBatch;
+
+    m_nameLabel = Build(nameBatch ? NameLabel::createBatched("", nameBatch) : NameLabel::create("", "chatFont.fnt"))
         .visible(showName)
         .pos(0.f, NAME_OFFSET)
         .parent(playerNode)
@@ -130,7 +136,9 @@ bool VisualPlayer::init(GJBaseGameLayer* gameLayer, RemotePlayer* rp, CCNode* pl
 
     if (showStatus) {
         float opacity = static_cast<unsigned char>(g_settings.playerOpacity * 255.f);
-        m_statusIcons = Build<PlayerStatusIcons>::create(opacity)
+        auto statusBatch = GlobedGJBGL::get(gameLayer)->m_fields->m_statusBatch;
+
+        m_statusIcons = Build(statusBatch ? PlayerStatusIcons::createBatched(opacity, statusBatch) : PlayerStatusIcons::create(opacity))
             .scale(0.8f)
             .anchorPoint(0.5f, 0.f)
             .pos(0.f, showName ? STATUS_ICONS_OFFSET : NAME_OFFSET)
@@ -217,6 +225,10 @@ void VisualPlayer::updateFromData(const VisualPlayerUpdate& vpu) {
     bool cameNearby = isNearby && !m_prevNearby;
     m_prevNearby = isNearby;
 
+    auto lod = (m_isLocalPlayer || vpu.noCulling) ? PlayerLod::Near : vpu.lod.select(data.position, camState);
+    bool lodRaised = lod < m_lod;
+    this->applyLod(lod);
+
     // determine if the player should be visible
     bool shouldMiscVisible = !forceHideEverything;
     bool shouldIconVisible = !forceHideIcon && !forceHideEverything;
@@ -238,6 +250,19 @@ void VisualPlayer::updateFromData(const VisualPlayerUpdate& vpu) {
         if (m_shipStreak) m_shipStreak->setVisible(false);
     }
 
+    // far away players are only drawn as a dot in a shared draw node, everything else is skipped
+    if (lod == PlayerLod::Far) {
+        this->setVisible(false, false);
+
+        if (shouldIconVisible && vpu.farBatch) {
+            auto color = ccc4FFromccc3B(m_color1);
+            color.a = g_settings.playerOpacity;
+            vpu.farBatch->drawDot(data.position, FAR_PLAYER_DOT_RADIUS, color);
+        }
+
+        return;
+    }
+
     bool extraProcessing = anyVisible || m_isLocalPlayer || vpu.noCulling;
 
     // XXX: sticky is pretty broken so not handled
@@ -373,9 +398,11 @@ void VisualPlayer::updateFromData(const VisualPlayerUpdate& vpu) {
 
     // TODO (low): dashing
 
-    // animate robot and spider
+    // animate robot and spider, mid LOD players keep a static frame
     if (data.iconType == PlayerIconType::Robot || data.iconType == PlayerIconType::Spider) {
-        if (m_prevGrounded != data.isGrounded || m_prevStationary != data.isStationary || m_prevFalling != data.isFalling || switchedMode || cameNearby) {
+        bool changed = m_prevGrounded != data.isGrounded || m_prevStationary != data.isStationary || m_prevFalling != data.isFalling;
+
+        if (lod == PlayerLod::Near && (changed || switchedMode || cameNearby || lodRaised)) {
             m_prevGrounded = data.isGrounded;
             m_prevStationary = data.isStationary;
             m_prevFalling = data.isFalling;
@@ -398,7 +425,7 @@ void VisualPlayer::updateFromData(const VisualPlayerUpdate& vpu) {
             m_swingFireMiddle->animateFireIn();
         }
 
-        if (cameNearby || ((changedGravity || switchedMode) && isNearby)) {
+        if (cameNearby || lodRaised || ((changedGravity || switchedMode) && isNearby)) {
             // now depending on the gravity, toggle either the bottom or top fire
             this->animateSwingFire(!data.isUpsideDown);
         }
@@ -426,10 +453,57 @@ void VisualPlayer::updateFromData(const VisualPlayerUpdate& vpu) {
             CCNode::onExit();
         } else {
             CCNode::onEnter();
+
+            // onEnter resumes everything, including animations frozen by LOD
+            if (m_lod != PlayerLod::Near) {
+                this->setAnimationsFrozen(true);
+            }
         }
     }
 }
 
+void VisualPlayer::applyLod(PlayerLod lod) {
+    if (lod == m_lod) return;
+
+    if (m_lod == PlayerLod::Near) {
+        // drop trails and particles, they are only shown for nearby players
+        m_playEffects = false;
+        if (m_regularTrail) m_regularTrail->setVisible(false);
+        if (m_shipStreak) m_shipStreak->setVisible(false);
+        this->setAnimationsFrozen(true);
+    } else if (lod == PlayerLod::Near) {
+        this->setAnimationsFrozen(false);
+    }
+
+    m_lod = lod;
+}
+
+void VisualPlayer::setAnimationsFrozen(bool frozen) {
+    // when the whole player is paused, animations are already stopped and will be handled when unpausing
+    if (m_prevPaused) return;
+
+    for (auto node : std::initializer_list<CCNode*>{m_robotSprite, m_spiderSprite, m_robotFire}) {
+        if (!node) continue;
+
+        frozen ? node->onExit() : node->onEnter();
+    }
+}
+
+void VisualPlayer::updateOffscreen(const PlayerObjectData& data) {
+    // only keep track of the position, it's used by progress arrows
+    m_prevPosition = data.position;
+    m_prevRotation = data.rotation;
+
+    if (!m_prevNearby) return;
+
+    // player just went out of range, hide everything once
+    m_prevNearby = false;
+    this->setVisible(false, false);
+    m_playEffects = false;
+    if (m_regularTrail) m_regularTrail->setVisible(false);
+    if (m_shipStreak) m_shipStreak->setVisible(false);
+}
+
 void VisualPlayer::updateLerpTrajectory(const PlayerObjectData& data) {
     if (!m_playerTrajectory) {
         return;
@@ -475,6 +549,12 @@ bool VisualPlayer::hideNearby(GJBaseGameLayer* gjbgl) {
 }
 
 PlayerIconData& VisualPlayer::icons() {
+    // pooled players are not bound to any remote player, use the default icons for them
+    if (!m_remotePlayer) {
+        static PlayerIconData defaultIcons = DEFAULT_PLAYER_DATA.icons;
+        return defaultIcons;
+    }
+
     return m_remotePlayer->m_data.icons;
 }
 
@@ -613,10 +693,16 @@ void VisualPlayer::callUpdate(PlayerIconData& icons, PlayerIconType ty) {
             this->updatePlayerDartFrame(icons.wave);
         } break;
         case PlayerIconType::Robot: {
-            this->updatePlayerRobotFrame(icons.robot);
+            // robot and spider have dedicated sprites that keep their frames while hidden,
+            // so switching back to them only needs an update if the icon changed
+            if (this->updateShownIcon(m_robotShown, icons.robot)) {
+                this->updatePlayerRobotFrame(icons.robot);
+            }
         } break;
         case PlayerIconType::Spider: {
-            this->updatePlayerSpiderFrame(icons.spider);
+            if (this->updateShownIcon(m_spiderShown, icons.spider)) {
+                this->updatePlayerSpiderFrame(icons.spider);
+            }
         } break;
         case PlayerIconType::Swing: {
             this->updatePlayerSwingFrame(icons.swing);
@@ -632,6 +718,30 @@ void VisualPlayer::callUpdate(PlayerIconData& icons, PlayerIconType ty) {
     }
 }
 
+/// Records what the robot or spider sprite is about to show, returns false if it already shows exactly that
+bool VisualPlayer::updateShownIcon(ShownIcon& shown, int id) {
+    ShownIcon next {
+        .id = id,
+        .color1 = m_color1,
+        .color2 = m_color2,
+        .glowColor = m_hasGlow ? std::optional{this->icons().glowColor.asColor()} : std::nullopt,
+    };
+
+    auto sameColor = [](const ccColor3B& a, const ccColor3B& b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b;
+    };
+
+    bool same = shown.id != 0
+        && next.id == shown.id
+        && sameColor(next.color1, shown.color1)
+        && sameColor(next.color2, shown.color2)
+        && next.glowColor.has_value() == shown.glowColor.has_value()
+        && (!next.glowColor || sameColor(*next.glowColor, *shown.glowColor));
+
+    shown = next;
+    return !same;
+}
+
 void VisualPlayer::updateRobotAnimation() {
     if (m_prevGrounded && m_prevStationary) {
         // if on ground and not moving, play the idle animation
@@ -750,6 +860,73 @@ void VisualPlayer::cleanupObjectLayer() {
 #undef $clear
 }
 
+void VisualPlayer::rebind(RemotePlayer* rp) {
+    m_remotePlayer = rp;
+
+    m_teamInitialized = false;
+    m_nameLabel->updateNoTeam();
+    m_nameLabel->updateNoRoles();
+
+    if (m_statusIcons) {
+        m_statusIcons->updateStatus(PlayerStatusFlags{}, true);
+    }
+
+    if (m_playerTrajectory) {
+        m_playerTrajectory->clear();
+    }
+
+    m_isDead = false;
+    m_isHidden = false;
+    m_playingDeathEffect = false;
+    m_prevNearby = false;
+    m_prevUpsideDown = false;
+    m_prevRotating = false;
+    m_prevMini = false;
+    m_robotShown = {};
+    m_spiderShown = {};
+    m_p1Sticky = false;
+    m_p2Sticky = false;
+    m_tpColorDelta = 0.f;
+
+    // the previous player may have died or been mid animation, undo what playerDestroyed and the fire animations
+    // left behind, so that the player starts out the same way as a freshly initialized one
+    m_robotFire->stopActionByTag(ROBOT_FIRE_ACTION);
+    this->hideRobotFire();
+    m_swingFireTop->setVisible(false);
+    m_swingFireMiddle->setVisible(false);
+    m_swingFireBottom->setVisible(false);
+
+    this->updateIconType(PlayerIconType::Cube);
+    m_prevMode = PlayerIconType::Cube;
+    this->updateOpacity();
+
+    this->setVisible(false);
+}
+
+void VisualPlayer::unbind() {
+    this->setVisible(false);
+    m_playEffects = false;
+    if (m_regularTrail) m_regularTrail->setVisible(false);
+    if (m_shipStreak) m_shipStreak->setVisible(false);
+
+    this->stopActionByTag(SPIDER_TELEPORT_COLOR_ACTION);
+    this->cancelPlatformerJumpAnim();
+    this->applyLod(PlayerLod::Near);
+
+    if (m_prevPaused) {
+        m_prevPaused = false;
+        CCNode::onEnter();
+    }
+
+    // stop any emote that might still be playing, the bubble will be recreated when needed
+    if (m_emoteBubble && m_playerNode.valid()) {
+        m_emoteBubble->removeFromParent();
+        m_emoteBubble = nullptr;
+    }
+
+    m_remotePlayer = nullptr;
+}
+
 void VisualPlayer::updateDisplayData() {
     auto gm = singleton<GameManager>();
     auto& rm = RoomManager::get();
@@ -787,6 +964,19 @@ void VisualPlayer::playDeathEffect() {
 
     this->hideRobotFire();
 
+    auto deathEffects = GlobedGJBGL::get(m_gameLayer)->m_fields->m_deathEffects;
+    auto tier = deathEffects ? deathEffects->nextTier() : DeathEffectTier::Full;
+
+    // too many effects already playing, the player only gets hidden, with a cheap pooled effect if one is free
+    if (tier == DeathEffectTier::Simple || tier == DeathEffectTier::None) {
+        if (tier == DeathEffectTier::Simple) {
+            deathEffects->playSimple(m_prevPosition, m_color1);
+        }
+
+        m_playingDeathEffect = true;
+        return;
+    }
+
     auto* gm = globed::singleton<GameManager>();
 
     int oldEffect = gm->getPlayerDeathEffect();
@@ -800,21 +990,30 @@ void VisualPlayer::playDeathEffect() {
     gm->setPlayerDeathEffect(newEffect);
 
     // find all children in the object layer so we can later compare and see what nodes were added by playerDestroyed
-    auto children = m_gameLayer->m_objectLayer->getChildrenExt();
-    std::unordered_set<CCNode*> prevChildren{children.begin(), children.end()};
+    auto prevChildrenList = m_gameLayer->m_objectLayer->getChildrenExt();
+    std::unordered_set<CCNode*> prevChildren{prevChildrenList.begin(), prevChildrenList.end()};
 
     // cause the actual death
     m_playEffects = true;
     m_isHidden = false;
+
+    if (tier == DeathEffectTier::Reduced) $unity::g_reducedDeathEffect = deathEffects;
     this->playerDestroyed(false);
+    $unity::g_reducedDeathEffect = nullptr;
 
     // set the death effect tag to every new child
-    for (auto child : children) {
+    std::vector<CCNode*> added;
+    for (auto child : m_gameLayer->m_objectLayer->getChildrenExt()) {
         if (!prevChildren.contains(child)) {
             child->setTag(DEATH_EFFECT_TAG);
+            added.push_back(child);
         }
     }
 
+    if (deathEffects) {
+        deathEffects->trackEffect(added, tier);
+    }
+
     gm->setPlayerDeathEffect(oldEffect);
 
     m_playingDeathEffect = true;
@@ -974,22 +1173,11 @@ bool VisualPlayer::isPlayerNearby(const PlayerObjectData& data, const GameCamera
     if (m_isEditor) return true;
 
     // check if they are inside a grid of 3x3 screens
-    float fullScaleMult = 3.f;
-    float originMoveMult = (fullScaleMult - 1.f) / 2.f; // magic
-
-    CCSize origCoverage = camState.cameraCoverage();
-    CCSize cameraCoverage = origCoverage * fullScaleMult;
-    CCPoint cameraOrigin = camState.cameraOrigin - origCoverage * originMoveMult;
-
-    float cameraLeft = cameraOrigin.x;
-    float cameraRight = cameraOrigin.x + cameraCoverage.width;
-    float cameraBottom = cameraOrigin.y;
-    float cameraTop = cameraOrigin.y + cameraCoverage.height;
-
+    auto rect = camState.nearbyRect();
     auto& pos = data.position;
 
-    return pos.x >= cameraLeft && pos.x <= cameraRight &&
-           pos.y >= cameraBottom && pos.y <= cameraTop;
+    return pos.x >= rect.getMinX() && pos.x <= rect.getMaxX() &&
+           pos.y >= rect.getMinY() && pos.y <= rect.getMaxY();
 }
 
 CCPoint VisualPlayer::getLastPosition() {
@@ -1052,6 +1240,16 @@ struct GLOBED_MODIFY_ATTR VPSchedulerHook : Modify<VPSchedulerHook, CCScheduler>
     }
 };
 
+struct GLOBED_MODIFY_ATTR VPParticleHook : Modify<VPParticleHook, CCParticleSystemQuad> {
+    static CCParticleSystemQuad* create(const char* file, bool p1) {
+        if ($unity::g_reducedDeathEffect) {
+            return $unity::g_reducedDeathEffect->emptyParticles();
+        }
+
+        return CCParticleSystemQuad::create(file, p1);
+    }
+};
+
 }
 
 // Note for self after reversing PlayerObject:
@@ -0,0 +1,124 @@
+#include "VisualPlayerPool.hpp"
+
+#include <UIBuilder.hpp>
+
+using namespace geode::prelude;
+
+// free pairs kept around, at least as many as there are players (up to MIN_FREE_PAIRS) and at most MAX_FREE_PAIRS
+constexpr size_t MIN_FREE_PAIRS = 8;
+constexpr size_t MAX_FREE_PAIRS = 48;
+
+namespace globed {
+
+VisualPlayerPool::VisualPlayerPool(GJBaseGameLayer* gameLayer, CCNode* parentNode)
+    : m_gameLayer(gameLayer), m_parentNode(parentNode) {}
+
+VisualPlayerPool::~VisualPlayerPool() {
+    this->clear();
+}
+
+std::optional<VisualPlayerPool::Pair> VisualPlayerPool::acquire() {
+    if (m_free.empty()) {
+        return std::nullopt;
+    }
+
+    auto pair = std::move(m_free.back());
+    m_free.pop_back();
+    return pair;
+}
+
+bool VisualPlayerPool::release(Ref<VisualPlayer> player1, Ref<VisualPlayer> player2) {
+    if (m_free.size() >= m_target || !player1 || !player2) {
+        return false;
+    }
+
+    player1->unbind();
+    player2->unbind();
+
+    m_free.push_back(Pair { std::move(player1), std::move(player2) });
+    return true;
+}
+
+void VisualPlayerPool::resize(size_t activePlayers, size_t playerLimit) {
+    m_activePlayers = activePlayers;
+    m_playerLimit = playerLimit;
+
+    // once someone joined, the players that were on the level have arrived
+    if (activePlayers != 0) {
+        m_expectedPlayers = 0;
+    }
+
+    // keep enough headroom for a good chunk of the current players to join again at once.
+    // on an empty level nothing is prepared, so offline play doesn't pay for it
+    size_t target = m_expectedPlayers != 0
+        ? std::min(m_expectedPlayers, MAX_FREE_PAIRS)
+        : std::clamp(activePlayers / 2, std::min(activePlayers, MIN_FREE_PAIRS), MAX_FREE_PAIRS);
+
+    // in a room there is no point in having more players prepared than can ever join
+    if (playerLimit != 0) {
+        target = std::min(target, playerLimit > activePlayers ? playerLimit - activePlayers : 0);
+    }
+
+    m_target = target;
+
+    while (m_free.size() > m_target) {
+        auto& pair = m_free.back();
+        destroy(pair.player1);
+        destroy(pair.player2);
+        m_free.pop_back();
+    }
+}
+
+void VisualPlayerPool::setExpectedPlayers(size_t count) {
+    if (m_activePlayers != 0) return;
+
+    m_expectedPlayers = count;
+    this->resize(m_activePlayers, m_playerLimit);
+}
+
+bool VisualPlayerPool::fillOne() {
+    if (m_free.size() >= m_target) {
+        return false;
+    }
+
+    Pair pair;
+
+    Build<VisualPlayer>::create(m_gameLayer, nullptr, m_parentNode, false, false)
+        .parent(m_parentNode)
+        .visible(false)
+        .store(pair.player1);
+
+    Build<VisualPlayer>::create(m_gameLayer, nullptr, m_parentNode, true, false)
+        .parent(m_parentNode)
+        .visible(false)
+        .store(pair.player2);
+
+    m_free.push_back(std::move(pair));
+    return true;
+}
+
+void VisualPlayerPool::clear() {
+    for (auto& pair : m_free) {
+        destroy(pair.player1);
+        destroy(pair.player2);
+    }
+
+    m_free.clear();
+}
+
+void VisualPlayerPool::destroy(VisualPlayer* player) {
+    if (!player) return;
+
+    player->cleanupObjectLayer();
+    player->removeFromParent();
+}
+
+size_t VisualPlayerPool::available() const {
+    return m_free.size();
+}
+
+size_t VisualPlayerPool::target() const {
+    return m_target;
+}
+
+}
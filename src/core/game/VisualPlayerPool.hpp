@@ -0,0 +1,53 @@
+#pragma once
+
+#include <globed/core/game/VisualPlayer.hpp>
+#include <vector>
+
+namespace globed {
+
+/// Pool of pre-initialized `VisualPlayer` pairs. Creating a `VisualPlayer` runs the full `PlayerObject::init`,
+/// which is expensive enough to cause a visible hitch when many players join at once.
+/// The pool is filled incrementally in idle frame time, and players are returned to it when they leave the level.
+class VisualPlayerPool {
+public:
+    struct Pair {
+        Ref<VisualPlayer> player1;
+        Ref<VisualPlayer> player2;
+    };
+
+    VisualPlayerPool(GJBaseGameLayer* gameLayer, cocos2d::CCNode* parentNode);
+    ~VisualPlayerPool();
+    GLOBED_NOCOPY(VisualPlayerPool);
+    GLOBED_NOMOVE(VisualPlayerPool);
+
+    /// Takes a pair out of the pool, returns `std::nullopt` if the pool is empty
+    std::optional<Pair> acquire();
+    /// Returns a pair to the pool. Returns false if the pool is already full, in which case the caller should destroy the players.
+    bool release(Ref<VisualPlayer> player1, Ref<VisualPlayer> player2);
+
+    /// Computes and sets the target amount of free pairs, based on the amount of players on the level and the room player limit (0 if no limit)
+    void resize(size_t activePlayers, size_t playerLimit);
+    /// Sets how many players were on the level when joining it. Until the first of them joins, the pool is sized for all of them,
+    /// since they are all sent in the same level data message.
+    void setExpectedPlayers(size_t count);
+    /// Creates a single pair if the pool is below its target size. Returns whether a pair was created.
+    bool fillOne();
+    /// Destroys all pooled players
+    void clear();
+
+    size_t available() const;
+    size_t target() const;
+
+private:
+    GJBaseGameLayer* m_gameLayer;
+    cocos2d::CCNode* m_parentNode;
+    std::vector<Pair> m_free;
+    size_t m_target = 0;
+    size_t m_expectedPlayers = 0;
+    size_t m_activePlayers = 0;
+    size_t m_playerLimit = 0;
+
+    static void destroy(VisualPlayer* player);
+};
+
+}
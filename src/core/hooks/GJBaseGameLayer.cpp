@@ -1,5 +1,6 @@
 #include "GJBaseGameLayer.hpp"
 #include <globed/audio/AudioManager.hpp>
+#include <globed/audio/VoiceDecodePool.hpp>
 #include <globed/core/RoomManager.hpp>
 #include <globed/core/PlayerCacheManager.hpp>
 #include <globed/core/SettingsManager.hpp>
@@ -14,6 +15,8 @@
 #include <core/preload/PreloadManager.hpp>
 #include <core/net/NetworkManagerImpl.hpp>
 #include <core/game/SettingCache.hpp>
+#include <util/Profiler.hpp>
+#include <util/BinLog.hpp>
 #include <ui/settings/DiscordLinkPopup.hpp>
 
 #include <Geode/modify/GameObject.hpp>
@@ -30,29 +33,33 @@ using namespace geode::prelude;
 using namespace asp::time;
 
 constexpr auto EMOTE_COOLDOWN = Duration::fromMillis(2500);
+// only fill the player pool on frames where globed took less than this much time
+constexpr auto POOL_FILL_IDLE_THRESHOLD = Duration::fromMillis(2);
+// deferred player work (icon updates, death effects, ..) may take this fraction of a frame
+constexpr double DEFERRED_WORK_FRAME_FRACTION = 0.1;
+constexpr auto DEFERRED_WORK_MIN_BUDGET = Duration::fromMicros(250);
+constexpr auto INIT_DATA_MAX_DELAY = Duration::fromMillis(250);
+constexpr auto UPDATE_TEAM_MAX_DELAY = Duration::fromMillis(500);
 
 namespace globed {
 
 static auto& g_settings = CachedSettings::get();
 
 static std::optional<Instant> g_lastEmoteTime;
-static struct {
-    Instant start;
-    Instant postLerp;
-    Instant postRPUpdate;
-    Instant postAudioUpdate;
-    Instant postPreUpdateEnd;
-
-    Instant postGameUpdate;
-    Instant postSendPlayerData;
-    Instant postPeriodicalUpdate;
-    Instant postPostUpdateEnd;
-} g_profilerFrame;
+// start of the current frame, used for idle work and the profiler
+static Instant g_frameStart;
+static uint64_t g_profFrameStart = 0;
+static uint64_t g_profPreUpdateEnd = 0;
 
 static int myAccountId() {
     return singleton<GJAccountManager>()->m_accountID;
 }
 
+static bool isPlayerInRect(const PlayerState& state, const CCRect& rect) {
+    return (state.player1 && rect.containsPoint(state.player1->position))
+        || (state.player2 && rect.containsPoint(state.player2->position));
+}
+
 GlobedGJBGL::Fields::~Fields() {
     if (m_self && m_active) {
         this->cleanup();
@@ -101,6 +108,20 @@ void GlobedGJBGL::setupPreInit(GJGameLevel* level, bool editor) {
     if (fields.m_active) {
         RoomManager::get().joinLevel(level);
         CoreImpl::get().onJoinLevel(this, level, editor);
+
+        // ask how many players are already on the level, so that the player pool can be filled before they all join at once
+        auto session = isEditorCollab ? *ecId : RoomManager::get().makeSessionId(level->m_levelID);
+        fields.m_playerCountListener = nm.listen<msg::PlayerCountsMessage>([this, session](const msg::PlayerCountsMessage& message) {
+            auto& pool = m_fields->m_playerPool;
+            if (!pool) return;
+
+            for (auto& [id, count] : message.counts) {
+                if (id.asU64() == session.asU64()) {
+                    pool->setExpectedPlayers(count);
+                }
+            }
+        });
+        nm.sendRequestPlayerCounts(session);
     }
 
     // this should happen immediately after joining, otherwise we race on localhost
@@ -225,6 +246,13 @@ void GlobedGJBGL::setupAudio() {
         // set audio device
         am.refreshDevices();
         am.setRecordBufferCapacity(globed::setting<int>("core.audio.buffer-size"));
+        am.setRecordFrameDuration(globed::setting<int>("core.audio.frame-duration"));
+        am.setVoiceActivation(
+            globed::setting<bool>("core.audio.voice-activation"),
+            globed::setting<int>("core.audio.vad-attack"),
+            globed::setting<int>("core.audio.vad-hangover")
+        );
+        am.setEncoderSettings(m_fields->m_voiceQuality.settings());
 
         AudioRecordConfig config {
             .encodedCallback = [this](const auto& frame) {
@@ -271,7 +299,7 @@ void GlobedGJBGL::setupUi() {
     auto& fields = *m_fields.self();
     auto winSize = CCDirector::get()->getWinSize();
 
-    Build<CCNode>::create()
+    Build<DrawCounterNode>::create()
         .id("player-node"_spr)
         .parent(m_objectLayer)
         .store(fields.m_playerNode);
@@ -279,11 +307,36 @@ void GlobedGJBGL::setupUi() {
     // gd PlayerObject is drawn on z 59, use 58 to appear on same in-game layer but behind the player
     fields.m_playerNode->setZOrder(58);
 
-    fields.m_progressBarContainer = Build<CCNode>::create()
+    fields.m_farPlayerNode = Build<CCDrawNode>::create()
+        .id("far-player-node"_spr)
+        .parent(fields.m_playerNode);
+    fields.m_farPlayerNode->m_bUseArea = false;
+
+    // drawn above the players
+    fields.m_nameBatch = Build(NameLabelBatch::create("chatFont.fnt"))
+        .id("name-batch"_spr)
+        .zOrder(1)
+        .parent(fields.m_playerNode);
+
+    fields.m_statusBatch = Build(StatusIconBatch::create())
+        .id("status-icon-batch"_spr)
+        .zOrder(1)
+        .parent(fields.m_playerNode);
+
+    fields.m_playerPool = std::make_shared<VisualPlayerPool>(this, fields.m_playerNode);
+    fields.m_playerPool->resize(0, RoomManager::get().getSettings().playerLimit);
+
+    fields.m_deathEffects = std::make_shared<DeathEffectPool>(fields.m_playerNode);
+
+    fields.m_progressBarContainer = Build<DrawCounterNode>::create()
         .id("progress-bar-wrapper"_spr)
         .visible(globed::setting<bool>("core.level.progress-indicators"))
         .zOrder(-1);
 
+    fields.m_progressIconBatch = Build(ProgressIconBatch::create())
+        .id("progress-icon-batch"_spr)
+        .parent(fields.m_progressBarContainer);
+
     if (auto pl = this->asPlayLayer()) {
         if (pl->m_progressBar) {
             pl->m_progressBar->addChild(fields.m_progressBarContainer);
@@ -312,6 +365,11 @@ void GlobedGJBGL::setupListeners() {
         this->onLevelMetaReceived(message);
     });
 
+    // voice from players that were already let through goes straight to a decode worker, without a trip through the main thread
+    fields.m_voiceRouteListener = nm.listen<msg::VoiceBroadcastMessage>([](msg::VoiceBroadcastMessage& message) {
+        return VoiceDecodePool::get().submitRouted(message.accountId, message.frame) ? ListenerResult::Stop : ListenerResult::Propagate;
+    }, 0, true);
+
     fields.m_voiceListener = nm.listen<msg::VoiceBroadcastMessage>([this](msg::VoiceBroadcastMessage& message) {
         // skip processing completely if voice chat is off
         if (!g_settings.voiceChat) return ListenerResult::Propagate;
@@ -457,6 +515,16 @@ void GlobedGJBGL::setupKeybinds() {
         }
     );
 
+    this->addEventListener(
+        KeybindSettingPressedEventV3(Mod::get(), "keybind-export-trace"),
+        [this](Keybind const& keybind, bool down, bool repeat, double time) {
+            if (repeat || !down || ignoreKeybind() || !Profiler::enabled()) return;
+
+            auto path = Profiler::get().exportChromeTrace();
+            globed::toastSuccess("Saved profiler trace to {}", utils::string::pathToString(path.filename()));
+        }
+    );
+
     for (size_t i = 0; i < 8; i++) {
         this->addEventListener(
             KeybindSettingPressedEventV3(Mod::get(), fmt::format("keybind-emote-{}", i)),
@@ -525,7 +593,8 @@ void GlobedGJBGL::onQuit() {
 }
 
 void GlobedGJBGL::selPreUpdate(float tsdt) {
-    g_profilerFrame.start = Instant::now();
+    g_frameStart = Instant::now();
+    g_profFrameStart = Profiler::get().now();
 
     auto& fields = *m_fields.self();
 
@@ -549,28 +618,53 @@ void GlobedGJBGL::selPreUpdate(float tsdt) {
     auto& rm = RoomManager::get();
 
     float dt = tsdt / CCScheduler::get()->getTimeScale();
-    fields.m_timeCounter += dt;
+    auto dtTicks = timestampFromSecs(dt);
+    fields.m_timeCounter += dtTicks;
 
     auto camPos = m_gameState.m_cameraPosition;
     auto cameraDelta = fields.m_cameraTracker.pushMeasurement(fields.m_timeCounter, camPos.x, camPos.y);
     auto cameraVector = fields.m_cameraTracker.getVector();
 
     // process stuff
+    ProfilerZone zone{"Interpolation"};
     fields.m_interpolator.tick(
-        dt,
+        dtTicks,
         CCPoint{(float) cameraDelta.first, (float) cameraVector.second},
         CCPoint{(float) cameraVector.first, (float) cameraVector.second}
     );
 
-    g_profilerFrame.postLerp = Instant::now();
+    zone.next("Player Upd");
 
     fields.m_unknownPlayers.clear();
 
-    auto camState = this->getCameraState();
+    // everything below (and modules) reads the camera and room settings from the frame context instead of querying them again
+    auto& frame = fields.m_frame;
+    frame.frameNumber++;
+    frame.dt = dt;
+    frame.timeCounter = fields.m_timeCounter;
+    frame.camState = this->getCameraState();
+    frame.roomSettings = rm.getSettings();
+    frame.nearbyPlayers = nullptr;
+    frame.onScreenPlayers = nullptr;
+    frame.localState = nullptr;
+    frame.editor = fields.m_editor;
 
+    auto& camState = frame.camState;
+
+    bool cullPlayers = !fields.m_noGlobalCulling && !fields.m_editor;
+    bool useLod = cullPlayers && g_settings.lodEnabled;
+
+    auto nearbyRect = camState.nearbyRect();
+    auto coverage = camState.cameraCoverage();
+    CCRect screenRect{camState.cameraOrigin.x, camState.cameraOrigin.y, coverage.width, coverage.height};
+
+    fields.m_nearbyPlayers.clear();
+    fields.m_onScreenPlayers.clear();
+
+    // remove players that left, and find players near the camera and on screen by their interpolated position.
+    // checking every player is cheaper than maintaining a spatial index, even with thousands of players
     for (auto it = fields.m_players.begin(); it != fields.m_players.end();) {
         int playerId = it->first;
-        auto& player = it->second;
 
         if (!fields.m_interpolator.hasPlayer(playerId)) {
             log::error("Interpolator is missing a player: {}", playerId);
@@ -585,14 +679,61 @@ void GlobedGJBGL::selPreUpdate(float tsdt) {
             continue;
         }
 
+        if (cullPlayers) {
+            auto& rstate = fields.m_interpolator.peekPlayerState(playerId);
+
+            if (isPlayerInRect(rstate, nearbyRect)) {
+                fields.m_nearbyPlayers.push_back(playerId);
+            }
+
+            if (useLod && isPlayerInRect(rstate, screenRect)) {
+                fields.m_onScreenPlayers.push_back(playerId);
+            }
+        }
+
+        ++it;
+    }
+
+    // sorted so that the scheduler and modules can look players up with a binary search
+    if (cullPlayers) {
+        std::sort(fields.m_nearbyPlayers.begin(), fields.m_nearbyPlayers.end());
+        frame.nearbyPlayers = &fields.m_nearbyPlayers;
+    }
+
+    // pick LOD parameters based on how many players are on screen, far players get redrawn into the draw node every frame
+    PlayerLodParams lodParams{};
+    if (useLod) {
+        std::sort(fields.m_onScreenPlayers.begin(), fields.m_onScreenPlayers.end());
+        lodParams = PlayerLodParams::create(fields.m_onScreenPlayers.size(), g_settings.lodBudget);
+        frame.onScreenPlayers = &fields.m_onScreenPlayers;
+    }
+
+    if (fields.m_farPlayerNode) {
+        fields.m_farPlayerNode->clear();
+    }
+
+    for (auto& entry : fields.m_players) {
+        int playerId = entry.first;
+        auto& player = entry.second;
+
+        if (!fields.m_interpolator.hasPlayer(playerId)) continue;
+
         RemotePlayerUpdate rpupdate{
             .camState = camState,
             .forceHide = fields.m_playersHidden,
             .forceVisibility = fields.m_forceAllPlayerVisibility,
             .noCulling = fields.m_noGlobalCulling,
+            .lod = lodParams,
+            .farBatch = fields.m_farPlayerNode,
         };
         rpupdate.state = fields.m_interpolator.getPlayerState(playerId, rpupdate.flags);
-        player->update(rpupdate);
+
+        // players that aren't near the camera skip all visual updates
+        if (!cullPlayers || isPlayerInRect(rpupdate.state, nearbyRect)) {
+            player->update(rpupdate);
+        } else {
+            player->updateOffscreen(rpupdate);
+        }
 
         // if we don't know player's data yet (username, icons, etc.), request it
         bool dataInit = player->isDataInitialized();
@@ -607,32 +748,63 @@ void GlobedGJBGL::selPreUpdate(float tsdt) {
                 fields.m_unknownPlayers.push_back(playerId);
             }
 
-            // if not initialized, use whatever we have
-            if (!dataInit && inAny) {
-                player->initData(*pcm.get(playerId), !inLayer1);
-            } else if (dataOutdated && inLayer1) {
-                // if outdated and we received layer 1 data, update from there
-                player->initData(*pcm.get(playerId), false);
+            // if not initialized, use whatever we have.
+            // if outdated and we received layer 1 data, update from there.
+            // the cache is read again when the task runs, so it always picks up the newest data
+            bool canInit = (!dataInit && inAny) || (dataOutdated && inLayer1);
+            if (canInit && !fields.m_scheduler.isPending(playerId, DeferredTaskKind::InitData)) {
+                fields.m_scheduler.schedule(
+                    playerId,
+                    DeferredTaskKind::InitData,
+                    dataInit ? DeferredTaskPriority::Low : DeferredTaskPriority::Normal,
+                    INIT_DATA_MAX_DELAY,
+                    [wplayer = std::weak_ptr{player}, playerId] {
+                        auto player = wplayer.lock();
+                        auto& cache = PlayerCacheManager::get();
+                        if (!player || !cache.has(playerId)) return;
+
+                        player->initData(*cache.get(playerId), !cache.hasInLayer1(playerId));
+                    }
+                );
             }
-        } else if (!player->isTeamInitialized() && rm.getSettings().teams) {
+        } else if (!player->isTeamInitialized() && frame.roomSettings.teams) {
             if (auto teamId = rm.getTeamIdForPlayer(playerId)) {
-                player->updateTeam(*teamId);
+                if (!fields.m_scheduler.isPending(playerId, DeferredTaskKind::UpdateTeam)) {
+                    fields.m_scheduler.schedule(
+                        playerId,
+                        DeferredTaskKind::UpdateTeam,
+                        DeferredTaskPriority::Low,
+                        UPDATE_TEAM_MAX_DELAY,
+                        [wplayer = std::weak_ptr{player}, teamId = *teamId] {
+                            if (auto player = wplayer.lock()) {
+                                player->updateTeam(teamId);
+                            }
+                        }
+                    );
+                }
             } else {
                 log::debug("player {} has unknown team", playerId);
             }
         }
-
-        ++it;
     }
 
-    g_profilerFrame.postRPUpdate = Instant::now();
+    zone.next("Deferred Work");
+
+    // run deferred player work, players near the camera go first
+    auto budget = std::max(
+        Duration::fromMicros(static_cast<uint64_t>(CCDirector::get()->getAnimationInterval() * DEFERRED_WORK_FRAME_FRACTION * 1'000'000.0)),
+        DEFERRED_WORK_MIN_BUDGET
+    );
+    fields.m_scheduler.run(budget, cullPlayers ? &fields.m_nearbyPlayers : nullptr);
+
+    zone.next("Audio Upd");
 
     // update audio
     if (fields.m_audioInterval.tick()) {
         AudioManager::get().updatePlayback(camState.cameraCenter(), fields.m_isVoiceProximity);
     }
 
-    g_profilerFrame.postAudioUpdate = Instant::now();
+    zone.next("Pre Misc");
 
     // -- commented chunk below is from globed v2, we no longer do this optimization for now --
     // // the server might not send any updates if there are no players on the level,
@@ -646,8 +818,8 @@ void GlobedGJBGL::selPreUpdate(float tsdt) {
     // }
 
     // refresh teams if needed
-    if (rm.getSettings().teams) {
-        if (fields.m_timeCounter - fields.m_lastTeamRefresh > 10.f) {
+    if (frame.roomSettings.teams) {
+        if (fields.m_timeCounter - fields.m_lastTeamRefresh > timestampFromSecs(10.0)) {
             NetworkManagerImpl::get().sendGetTeamMembers();
             fields.m_lastTeamRefresh = fields.m_timeCounter;
         }
@@ -668,27 +840,36 @@ void GlobedGJBGL::selPreUpdate(float tsdt) {
         }
     }
 
-    CoreImpl::get().onPreUpdate(this, dt);
+    CoreImpl::get().onPreUpdate(this, frame);
 
-    g_profilerFrame.postPreUpdateEnd = Instant::now();
+    zone.end();
+    g_profPreUpdateEnd = Profiler::get().now();
 }
 
 void GlobedGJBGL::selPostUpdate(float dt) {
-    g_profilerFrame.postGameUpdate = Instant::now();
-
     auto& fields = *m_fields.self();
     if (!fields.m_active) return;
 
-    auto camState = this->getCameraState();
+    auto& prof = Profiler::get();
+    prof.record("Game Update", g_profPreUpdateEnd, prof.now());
+
+    ProfilerZone zone{"Send Data"};
+
+    // the camera moved during the game update, but the start of frame state is close enough for culling and the server
+    auto& frame = fields.m_frame;
+    auto& camState = frame.camState;
+
+    // the local state is needed every frame for the ghost player, so compute it once and share it with modules
+    fields.m_localState = this->getPlayerState();
+    auto& state = fields.m_localState;
+    frame.localState = &state;
 
-    // send player data to the server
-    auto state = this->getPlayerState();
     auto& sendInterval = fields.m_throttleUpdates
         ? fields.m_sendThrottledInterval
         : fields.m_sendInterval;
 
     if (sendInterval.tick()) {
-        this->sendPlayerData(state);
+        this->sendPlayerData(state, camState);
     }
 
     bool fullMeta = fields.m_metaFullInterval.tick();
@@ -696,7 +877,7 @@ void GlobedGJBGL::selPostUpdate(float dt) {
         this->sendPlayerLevelMeta(fullMeta);
     }
 
-    g_profilerFrame.postSendPlayerData = Instant::now();
+    zone.next("Periodical Upd");
 
     // update ghost player
     RemotePlayerUpdate rpupdate{
@@ -712,34 +893,30 @@ void GlobedGJBGL::selPostUpdate(float dt) {
         fields.m_periodicalDelta = 0.f;
     }
 
-    g_profilerFrame.postPeriodicalUpdate = Instant::now();
+    zone.next("Post Misc");
 
     // fix progressbar
     if (globed::setting<bool>("core.level.fix-progress-bar")) {
         this->fixProgressBar(state.progress());
     }
 
-    CoreImpl::get().onUpdate(this, dt);
+    CoreImpl::get().onUpdate(this, frame);
+
+    // if this frame had time to spare, prepare a player for the pool
+    if (fields.m_playerPool && g_frameStart.elapsed() < POOL_FILL_IDLE_THRESHOLD) {
+        fields.m_playerPool->fillOne();
+    }
+
+    zone.end();
 
-    g_profilerFrame.postPostUpdateEnd = Instant::now();
+#ifdef GLOBED_ALLOC_AUDIT
+    AllocAudit::endFrame(fields.m_players.size());
+#endif
 
     if (fields.m_profilerOverlay) {
-        auto& fr = g_profilerFrame;
-
-        auto totalTime = fr.postPostUpdateEnd.durationSince(fr.start);
-        fields.m_profilerOverlay->updateWithFrame(ProfilerFrame {
-            .totalTime = totalTime,
-            .samples = {
-                ProfilerSample { "Interpolation", fr.start, fr.postLerp, "#23e8fa" },
-                ProfilerSample { "Player Upd", fr.postLerp, fr.postRPUpdate, "#4caf50" },
-                ProfilerSample { "Audio Upd", fr.postRPUpdate, fr.postAudioUpdate, "#0707f2" },
-                ProfilerSample { "Pre Misc", fr.postAudioUpdate, fr.postPreUpdateEnd, "#757575" },
-                ProfilerSample { "Game Update", fr.postPreUpdateEnd, fr.postGameUpdate, "#ffeb3b" },
-                ProfilerSample { "Send Data", fr.postGameUpdate, fr.postSendPlayerData, "#fb8c00" },
-                ProfilerSample { "Periodical Upd", fr.postSendPlayerData, fr.postPeriodicalUpdate, "#e91e63" },
-                ProfilerSample { "Post Misc", fr.postPeriodicalUpdate, fr.postPostUpdateEnd, "#455a64" },
-            }
-        });
+        // counted while drawing the previous frame
+        size_t drawCalls = fields.m_playerNode->getLastDrawCalls() + fields.m_progressBarContainer->getLastDrawCalls();
+        fields.m_profilerOverlay->collectFrame(g_profFrameStart, fields.m_scheduler.size(), drawCalls);
     }
 }
 
@@ -776,6 +953,13 @@ void GlobedGJBGL::selPeriodicalUpdate(float dt) {
 
     fields.m_pingOverlay->updatePing();
 
+#ifdef GLOBED_VOICE_CAN_TALK
+    // adapt the voice encoder to the current loss, latency and listener count
+    if (g_settings.voiceChat) {
+        this->updateVoiceQuality();
+    }
+#endif
+
     // check if the user is afk
     auto state = getCurrentGameState();
     if (state != GameState::Active) {
@@ -794,9 +978,13 @@ void GlobedGJBGL::selPeriodicalUpdate(float dt) {
     if (prevThrottle != fields.m_throttleUpdates) {
         log::debug("updating data send interval to {}", fields.m_throttleUpdates ? "throttled" : "normal");
     }
+
+    if (fields.m_playerPool) {
+        fields.m_playerPool->resize(fields.m_players.size(), RoomManager::get().getSettings().playerLimit);
+    }
 }
 
-void GlobedGJBGL::sendPlayerData(const PlayerState& state) {
+void GlobedGJBGL::sendPlayerData(const PlayerState& state, const GameCameraState& camState) {
     auto& nm = NetworkManagerImpl::get();
     // do not do anything if we aren't connected
     if (!nm.isGameConnected()) return;
@@ -805,10 +993,10 @@ void GlobedGJBGL::sendPlayerData(const PlayerState& state) {
     fields.m_totalSentPackets++;
 
     std::vector<int> toRequest;
-    float sinceRequest = fields.m_timeCounter - fields.m_lastDataRequest;
+    PlayerTimestamp sinceRequest = fields.m_timeCounter - fields.m_lastDataRequest;
 
     // only request data if there's no in flight request or more than 1 second has passed since one was made (likely lost)
-    if (fields.m_lastDataRequest == 0.f || sinceRequest > 1.f) {
+    if (fields.m_lastDataRequest == 0 || sinceRequest > timestampFromSecs(1.0)) {
         toRequest.reserve(std::min<size_t>(fields.m_unknownPlayers.size(), 64));
 
         for (int player : m_fields->m_unknownPlayers) {
@@ -830,7 +1018,6 @@ void GlobedGJBGL::sendPlayerData(const PlayerState& state) {
     }
 
     // get camera position and radius
-    auto camState = this->getCameraState();
     auto coverage = camState.cameraCoverage();
 
     CCPoint camCenter = camState.cameraOrigin + coverage / 2.f;
@@ -887,7 +1074,11 @@ void GlobedGJBGL::sendPlayerLevelMeta(bool fullCheck) {
         }).collect();
     }
 
-    log::debug("Requesting player metas: {}", toCheck);
+    if (BinLog::enabled()) {
+        GLOBED_BINLOG("Requesting player metas: {}", toCheck);
+    } else {
+        log::debug("Requesting player metas: {}", toCheck);
+    }
 
     NetworkManagerImpl::get().sendPlayerUpdateMeta(meta, toCheck);
 }
@@ -897,7 +1088,7 @@ PlayerState GlobedGJBGL::getPlayerState() {
 
     PlayerState out{};
     out.accountId = myAccountId();
-    out.timestamp = fields.m_timeCounter;
+    out.timestamp = timestampToWire(fields.m_timeCounter);
     out.frameNumber = 0;
     out.deathCount = fields.m_deathCount;
 
@@ -1088,6 +1279,8 @@ void GlobedGJBGL::handlePlayerLeave(int playerId, bool removeFromMap) {
     }
 
     fields.m_interpolator.removePlayer(playerId);
+    fields.m_playerGrid.remove(playerId);
+    fields.m_scheduler.cancel(playerId);
     PlayerCacheManager::get().evictToLayer2(playerId);
 
     if (fields.m_voiceOverlay) {
@@ -1234,6 +1427,10 @@ CameraDirection GlobedGJBGL::getCameraDirection() {
     };
 }
 
+const FrameContext& GlobedGJBGL::frameContext() {
+    return m_fields->m_frame;
+}
+
 GameCameraState GlobedGJBGL::getCameraState() {
     GameCameraState state{};
     state.visibleOrigin = CCPoint{0.f, 0.f};
@@ -1399,6 +1596,35 @@ void GlobedGJBGL::pauseVoiceRecording() {
 #endif
 }
 
+void GlobedGJBGL::updateVoiceQuality() {
+    auto& fields = *m_fields.self();
+    auto& nm = NetworkManagerImpl::get();
+    auto& am = AudioManager::get();
+
+    VoiceLinkStats stats {
+        .loss = nm.getGameLoss(),
+        .rttMs = static_cast<float>(nm.getGamePing().millis()),
+        .listeners = fields.m_players.size(),
+        .encoderLoad = am.sampleEncoderLoad(),
+    };
+
+    auto settings = fields.m_voiceQuality.update(stats, Instant::now());
+    if (!settings) return;
+
+    auto reason = fields.m_voiceQuality.reason();
+    log::debug(
+        "Voice encoder: {} bps, complexity {}, fec {}% ({}; loss {:.1f}%, rtt {}ms, {} listeners, encoder load {:.1f}%)",
+        settings->bitrate, settings->complexity, settings->fecLossPercent, reason,
+        stats.loss * 100.f, stats.rttMs, stats.listeners, stats.encoderLoad * 100.f
+    );
+
+    am.setEncoderSettings(*settings);
+
+    if (fields.m_voiceOverlay) {
+        fields.m_voiceOverlay->showQualityChange(*settings, reason);
+    }
+}
+
 void GlobedGJBGL::setCameraFollowPlayer(PlayerObject* player) {
     // TODO: this weird syntax because operator=(T*) is broken right now in geode
     m_fields->m_cameraFollows = WeakRef{player};
@@ -1441,7 +1667,7 @@ void GlobedGJBGL::onLevelDataReceived(const msg::LevelDataMessage& message) {
     }
 
     if (!message.displayDatas.empty()) {
-        fields.m_lastDataRequest = 0.f;
+        fields.m_lastDataRequest = 0;
     }
 }
 
@@ -1469,6 +1695,7 @@ void GlobedGJBGL::onVoiceDataReceived(msg::VoiceBroadcastMessage& message) {
 
     if (auto player = this->getPlayer(message.accountId)) {
         player->playVoiceData(std::move(message.frame));
+        player->routeVoiceData();
     }
 }
 
@@ -1507,7 +1734,7 @@ void GlobedGJBGL::onJoinSessionFailed(const msg::JoinSessionFailedMessage& messa
 void GlobedGJBGL::onDisplayDataRefreshed(const DisplayDataRefreshedEvent& event) {
     // refresh this player's data
     PlayerCacheManager::get().evictToLayer2(event.playerId);
-    m_fields->m_lastDataRequest = 0.f;
+    m_fields->m_lastDataRequest = 0;
     if (auto rp = this->getPlayer(event.playerId)) {
         rp->markDataOutdated();
     }
@@ -1519,12 +1746,21 @@ void GlobedGJBGL::cleanupGlobedAdditions() {
     am.stopAllOutputSources();
 
     auto& fields = *m_fields.self();
+    fields.m_scheduler.clear();
+    fields.m_playerPool.reset();
+    fields.m_deathEffects.reset();
+    // owned by the player node and the progress bar container
+    fields.m_farPlayerNode = nullptr;
+    fields.m_nameBatch = nullptr;
+    fields.m_statusBatch = nullptr;
+    fields.m_progressIconBatch = nullptr;
     cue::resetNode(fields.m_playerNode);
     cue::resetNode(fields.m_progressBarContainer);
     cue::resetNode(fields.m_voiceOverlay);
     cue::resetNode(fields.m_profilerOverlay);
     fields.m_ghost.reset();
     fields.m_interpolator.fullReset();
+    fields.m_playerGrid.clear();
     if (fields.m_pingOverlay) {
         fields.m_pingOverlay->updateWithDisconnected();
     }
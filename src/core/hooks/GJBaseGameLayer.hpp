@@ -2,20 +2,29 @@
 #include <Geode/Geode.hpp>
 #include <Geode/modify/GJBaseGameLayer.hpp>
 #include <globed/config.hpp>
+#include <globed/audio/VoiceQualityController.hpp>
 #include <globed/core/game/RemotePlayer.hpp>
 #include <globed/core/game/GameEvents.hpp>
 #include <globed/core/game/GameCameraState.hpp>
+#include <globed/core/game/FrameContext.hpp>
 #include <globed/core/net/MessageListener.hpp>
 #include <globed/core/data/Messages.hpp>
 #include <globed/util/BoolExt.hpp>
 #include <globed/util/Interval.hpp>
+#include <globed/util/FlatIntMap.hpp>
 #include <ui/game/VoiceOverlay.hpp>
 #include <ui/game/PingOverlay.hpp>
 #include <ui/game/EmoteBubble.hpp>
 #include <ui/game/ProfilerOverlay.hpp>
 #include <ui/misc/NameLabel.hpp>
+#include <ui/misc/NameLabelBatch.hpp>
+#include <core/game/StatusIconBatch.hpp>
+#include <core/game/ProgressIconBatch.hpp>
 #include <core/game/Interpolator.hpp>
 #include <core/game/SpeedTracker.hpp>
+#include <core/game/VisualPlayerPool.hpp>
+#include <core/game/DeferredScheduler.hpp>
+#include <core/game/DeathEffectPool.hpp>
 
 namespace globed {
 
@@ -32,9 +41,11 @@ struct GLOBED_MODIFY_ATTR GlobedGJBGL : geode::Modify<GlobedGJBGL, GJBaseGameLay
         bool m_disallowThrottle = false;
         float m_periodicalDelta = 0.f;
 
-        float m_timeCounter = 0.0f;
-        float m_lastServerUpdate = 0.0f;
-        float m_lastTeamRefresh = 0.0f;
+        PlayerTimestamp m_timeCounter = 0;
+        FrameContext m_frame;
+        PlayerState m_localState;
+        PlayerTimestamp m_lastServerUpdate = 0;
+        PlayerTimestamp m_lastTeamRefresh = 0;
         Interval m_sendInterval;
         Interval m_sendThrottledInterval;
         Interval m_audioInterval;
@@ -42,14 +53,22 @@ struct GLOBED_MODIFY_ATTR GlobedGJBGL : geode::Modify<GlobedGJBGL, GJBaseGameLay
         Interval m_metaFullInterval;
         uint32_t m_totalSentPackets = 0;
         Interpolator m_interpolator;
+        std::vector<int> m_nearbyPlayers;
+        std::vector<int> m_onScreenPlayers;
+        std::shared_ptr<VisualPlayerPool> m_playerPool;
+        std::shared_ptr<DeathEffectPool> m_deathEffects;
+        DeferredScheduler m_scheduler;
         VectorSpeedTracker m_cameraTracker;
-        std::unordered_map<int, std::shared_ptr<RemotePlayer>> m_players;
+        FlatIntMap<std::shared_ptr<RemotePlayer>> m_players;
+        VoiceQualityController m_voiceQuality;
         std::shared_ptr<RemotePlayer> m_ghost; // player that always follows the local player
         std::vector<int> m_unknownPlayers;
-        float m_lastDataRequest = 0.f;
+        PlayerTimestamp m_lastDataRequest = 0;
         MessageListener<msg::LevelDataMessage> m_levelDataListener;
         MessageListener<msg::LevelMetaMessage> m_levelMetaListener;
+        MessageListener<msg::PlayerCountsMessage> m_playerCountListener;
         MessageListener<msg::VoiceBroadcastMessage> m_voiceListener;
+        MessageListener<msg::VoiceBroadcastMessage> m_voiceRouteListener;
         MessageListener<msg::QuickChatBroadcastMessage> m_quickChatListener;
         MessageListener<msg::ChatNotPermittedMessage> m_mutedListener;
         MessageListener<msg::JoinSessionFailedMessage> m_joinFailedListener;
@@ -75,10 +94,14 @@ struct GLOBED_MODIFY_ATTR GlobedGJBGL : geode::Modify<GlobedGJBGL, GJBaseGameLay
         bool m_spectating = false;
         BoolExt m_didJustJump1, m_didJustJump2;
 
-        CCNode* m_playerNode = nullptr;
+        DrawCounterNode* m_playerNode = nullptr;
+        cocos2d::CCDrawNode* m_farPlayerNode = nullptr; // dots for players rendered at the lowest LOD
+        NameLabelBatch* m_nameBatch = nullptr;
+        StatusIconBatch* m_statusBatch = nullptr;
         CCNode* m_uiNode = nullptr;
         GlobedGJBGL* m_self = nullptr;
-        Ref<CCNode> m_progressBarContainer;
+        Ref<DrawCounterNode> m_progressBarContainer;
+        ProgressIconBatch* m_progressIconBatch = nullptr;
         Ref<VoiceOverlay> m_voiceOverlay;
         Ref<ProfilerOverlay> m_profilerOverlay;
         Ref<PingOverlay> m_pingOverlay;
@@ -138,7 +161,7 @@ struct GLOBED_MODIFY_ATTR GlobedGJBGL : geode::Modify<GlobedGJBGL, GJBaseGameLay
     /// By default, the send rate is throttled if no other players are on the level.
     void setDisallowThrottleUpdates();
     void setSpectating(bool spectate);
-    void sendPlayerData(const PlayerState& state);
+    void sendPlayerData(const PlayerState& state, const GameCameraState& camState);
     void sendPlayerLevelMeta(bool fullCheck = false);
     PlayerLevelMeta getMyLevelMeta();
     /// Kills the local player, by default the death will not be counted as 'real'.
@@ -163,6 +186,8 @@ struct GLOBED_MODIFY_ATTR GlobedGJBGL : geode::Modify<GlobedGJBGL, GJBaseGameLay
     bool active();
     CameraDirection getCameraDirection();
     GameCameraState getCameraState();
+    /// Context of the current frame, camera state and other data here is only computed once per frame
+    const FrameContext& frameContext();
     std::shared_ptr<RemotePlayer> getPlayer(int playerId);
     std::optional<PlayerLevelMeta> getPlayerLevelMeta(int playerId);
     void recordPlayerJump(bool p1);
@@ -180,6 +205,8 @@ struct GLOBED_MODIFY_ATTR GlobedGJBGL : geode::Modify<GlobedGJBGL, GJBaseGameLay
     void toggleDeafen();
     void resumeVoiceRecording();
     void pauseVoiceRecording();
+    /// Adapts the voice encoder settings to the current connection, listeners and cpu load
+    void updateVoiceQuality();
 
     void setCameraFollowPlayer(PlayerObject* player);
 
@@ -6,34 +6,108 @@ using namespace geode::prelude;
 
 namespace globed {
 
+// Every robot and spider sprite builds its own SpriteAnimationManager, which stores the type and priority
+// of each animation as a CCString in its own dictionaries, plus a "<name>_first" key for the first frame.
+// These never change after being loaded, so the first manager that loads an animation description keeps its
+// dictionaries, and every later manager loading the same description retains those instead of building its own.
+// The animate actions are still created per manager, as they hold the state of a running animation.
+
+/// Type and priority of every animation in a single animation description, shared by all managers that load it.
+/// Neither dictionary is modified after the first manager finishes loading.
+struct AnimationDefinition {
+    Ref<CCDictionary> types;
+    Ref<CCDictionary> priorities;
+};
+
+static utils::StringMap<AnimationDefinition> g_definitions;
+// set while a manager loads a description that already has a shared definition
+static bool g_loadingShared = false;
+
 static CCString* createCCString(std::string_view data) {
     auto str = new CCString();
-    str->autorelease();
     str->m_sString = gd::string{data.data(), data.size()};
     return str;
 }
 
+/// Returns a shared string holding the given integer. The returned object is never freed.
+static CCString* internIntString(int value) {
+    static std::unordered_map<int, CCString*> strings;
+
+    auto it = strings.find(value);
+    if (it != strings.end()) {
+        return it->second;
+    }
+
+    fmt::format_int f{value};
+    auto str = createCCString(std::string_view{f.data(), f.size()});
+    strings.emplace(value, str);
+    return str;
+}
+
+static const gd::string& getFirstFrameKey(const gd::string& name) {
+    static utils::StringMap<gd::string> keys;
+
+    std::string_view key{name.data(), name.size()};
+    auto it = keys.find(key);
+    if (it != keys.end()) {
+        return it->second;
+    }
+
+    StringBuffer<> firstbuf;
+    firstbuf.append("{}_first", key);
+
+    auto& out = keys[std::string{key}];
+    out = gd::string{firstbuf.data(), firstbuf.size()};
+    return out;
+}
+
+static void replaceDict(CCDictionary*& dict, CCDictionary* shared) {
+    if (dict == shared) return;
+
+    shared->retain();
+    CC_SAFE_RELEASE(dict);
+    dict = shared;
+}
+
 struct GLOBED_MODIFY_ATTR SAMHook : Modify<SAMHook, SpriteAnimationManager> {
     static void onModify(auto& self) {
         (void) self.setHookPriority("SpriteAnimationManager::storeAnimation", Priority::Replace);
     }
 
+    void loadAnimations(gd::string path) {
+        std::string_view key{path.data(), path.size()};
+
+        auto it = g_definitions.find(key);
+        if (it == g_definitions.end()) {
+            SpriteAnimationManager::loadAnimations(path);
+
+            // this manager's dictionaries become the shared definition
+            g_definitions.emplace(std::string{key}, AnimationDefinition {
+                .types = m_typeDict,
+                .priorities = m_priorityDict,
+            });
+            return;
+        }
+
+        replaceDict(m_typeDict, it->second.types);
+        replaceDict(m_priorityDict, it->second.priorities);
+
+        g_loadingShared = true;
+        SpriteAnimationManager::loadAnimations(path);
+        g_loadingShared = false;
+    }
+
     void storeAnimation(CCAnimate* action, CCAnimate* frames, gd::string name, int priority, spriteMode type, CCSpriteFrame* first) {
         m_animateDict->setObject(action, name);
         m_frameDict->setObject(frames, name);
+        m_frameDict->setObject(first, getFirstFrameKey(name));
 
-        StringBuffer<> firstbuf;
-        firstbuf.append("{}_first", name);
-        m_frameDict->setObject(first, gd::string{firstbuf.data(), firstbuf.size()});
-
-        StringBuffer<> typebuf;
-        typebuf.append("{}", (int)type);
-        m_typeDict->setObject(createCCString(typebuf.view()), name);
+        // already in the shared dictionaries
+        if (g_loadingShared) return;
 
-        StringBuffer<> prioBuf;
-        prioBuf.append("{}", priority);
-        m_priorityDict->setObject(createCCString(prioBuf.view()), name);
+        m_typeDict->setObject(internIntString((int)type), name);
+        m_priorityDict->setObject(internIntString(priority), name);
     }
 };
 
-}
\ No newline at end of file
+}
@@ -10,6 +10,9 @@
 #include <globed/util/gd.hpp>
 #include <globed/util/scary.hpp>
 #include <util/SentryClient.hpp>
+#include <util/Profiler.hpp>
+#include <util/BinLog.hpp>
+#include "TaskMonitor.hpp"
 #include <core/CoreImpl.hpp>
 #include "data/helpers.hpp"
 #include <bb_public.hpp>
@@ -385,6 +388,7 @@ NetworkManagerImpl::NetworkManagerImpl() : m_runtime(async::runtime().weakFromTh
     });
 
     async::spawn(this->asyncInit());
+    async::spawn(TaskMonitor::get().run()).setName("[Globed] Task Monitor");
 }
 
 NetworkManagerImpl::~NetworkManagerImpl() {
@@ -1376,6 +1380,14 @@ void NetworkManagerImpl::dumpNetworkStats() {
         log::info("- {}: {} polls, {} runtime", name.empty() ? "<unnamed>" : name, task->totalPolls(), task->totalRuntime().toString());
     }
 
+    log::info("===== Async task poll times =====");
+    TaskMonitor::get().dump();
+
+    log::info("========== Lock stats ==========");
+    for (auto& line : utils::string::split(LockStats::summary(), "\n")) {
+        if (!line.empty()) log::info("{}", line);
+    }
+
     log::info("================================");
 }
 
@@ -2378,7 +2390,11 @@ void NetworkManagerImpl::sendEvent(std::string_view id, std::vector<uint8_t> dat
     auto info = this->connInfo();
     if (!info) return;
 
-    log::debug("Enqueue event '{}' ({} bytes), central: {}, game: {}", id, data.size(), central, game);
+    if (BinLog::enabled()) {
+        GLOBED_BINLOG("Enqueue event '{}' ({} bytes), central: {}, game: {}", id, data.size(), central, game);
+    } else {
+        log::debug("Enqueue event '{}' ({} bytes), central: {}, game: {}", id, data.size(), central, game);
+    }
 
     if (central) {
         info->m_centralEventQueue.emplace_back(id, data, options);
@@ -2466,6 +2482,8 @@ void NetworkManagerImpl::sendLeaveSession() {
 }
 
 Result<> NetworkManagerImpl::onCentralDataReceived(CentralMessage::Reader& msg) {
+    GLOBED_PROFILE_ZONE("Central Message");
+
     using enum CentralMessage::Which;
 
     switch (msg.which()) {
@@ -2810,6 +2828,8 @@ Result<> NetworkManagerImpl::onCentralDataReceived(CentralMessage::Reader& msg)
 }
 
 Result<> NetworkManagerImpl::onGameDataReceived(GameMessage::Reader& msg) {
+    GLOBED_PROFILE_ZONE("Game Message");
+
     using enum GameMessage::Which;
 
     switch (msg.which()) {
@@ -2873,7 +2893,9 @@ Result<> NetworkManagerImpl::onGameDataReceived(GameMessage::Reader& msg) {
             if (auto rtt = connInfo.handleIncomingMessageId(messageId)) {
                 m_gameConn->updateLatency(*rtt);
 
-                if (m_debugLogs.load(relaxed)) {
+                if (BinLog::enabled()) {
+                    GLOBED_BINLOG("Game server RTT: {}", *rtt);
+                } else if (m_debugLogs.load(relaxed)) {
                     log::debug("Game server RTT: {}", *rtt);
                 }
             }
@@ -12,6 +12,7 @@
 #include <globed/core/data/UserPermissions.hpp>
 #include <globed/core/net/MessageListener.hpp>
 #include <globed/util/FunctionQueue.hpp>
+#include <globed/util/InstrumentedLock.hpp>
 #include <modules/scripting/data/EmbeddedScript.hpp>
 #include "ConnectionLogger.hpp"
 #include "EventEncoder.hpp"
@@ -168,7 +169,9 @@ struct ConnectionInfo {
 
 struct GLOBED_DLL LockedConnInfo {
 public:
-    LockedConnInfo(asp::MutexGuard<std::optional<ConnectionInfo>, false>&& guard) : _guard(std::move(guard)) {}
+    using Guard = InstrumentedMutex<std::optional<ConnectionInfo>>::Guard;
+
+    LockedConnInfo(Guard&& guard) : _guard(std::move(guard)) {}
     LockedConnInfo(const LockedConnInfo&) = delete;
     LockedConnInfo& operator=(const LockedConnInfo&) = delete;
     LockedConnInfo(LockedConnInfo&&) = default;
@@ -200,7 +203,7 @@ public:
         GLOBED_DEBUG_ASSERT(_guard->has_value());
     }
 private:
-    asp::MutexGuard<std::optional<ConnectionInfo>, false> _guard;
+    Guard _guard;
 };
 
 class GLOBED_DLL NetworkManagerImpl {
@@ -407,14 +410,14 @@ private:
     std::atomic<bool> m_debugLogs{false};
     std::atomic<bool> m_gameMustReauth{false};
 
-    asp::Mutex<std::optional<ConnectionInfo>> m_connInfo;
+    InstrumentedMutex<std::optional<ConnectionInfo>> m_connInfo{"NetworkManager::connInfo"};
     std::string m_connectingCentralUrl;
     PlayerIconData m_connectingIcons;
     asp::SpinLock<std::pair<std::string, bool>> m_abortCause;
     std::atomic<bool> m_manualDisconnect{false};
 
-    asp::Mutex<EventEncoder> m_gameEventEncoder;
-    asp::Mutex<EventEncoder> m_centralEventEncoder;
+    InstrumentedMutex<EventEncoder> m_gameEventEncoder{"NetworkManager::gameEventEncoder"};
+    InstrumentedMutex<EventEncoder> m_centralEventEncoder{"NetworkManager::centralEventEncoder"};
 
     arc::Future<> asyncInit();
 
@@ -0,0 +1,105 @@
+#include "TaskMonitor.hpp"
+#include <globed/util/InstrumentedLock.hpp>
+
+#include <Geode/Geode.hpp>
+#include <arc/time/Sleep.hpp>
+
+using namespace geode::prelude;
+using namespace asp::time;
+
+// average poll duration over a sampling window above which a task is considered to be blocking the runtime
+constexpr auto SLOW_POLL_THRESHOLD = Duration::fromMillis(2);
+constexpr auto SAMPLE_INTERVAL = Duration::fromSecs(1);
+
+namespace globed {
+
+arc::Future<> TaskMonitor::run() {
+    while (true) {
+        co_await arc::sleep(SAMPLE_INTERVAL);
+
+        if (LockStats::enabled()) {
+            this->sample();
+        }
+    }
+}
+
+void TaskMonitor::sample() {
+    auto tasks = m_tasks.lock();
+    auto stats = async::runtime().getTaskStats();
+
+    // tasks are keyed by address, forget the ones that finished so a new task at the same address starts clean
+    std::unordered_set<const void*> alive;
+    alive.reserve(stats.size());
+    for (auto& task : stats) {
+        alive.insert(task.get());
+    }
+
+    std::erase_if(*tasks, [&](auto& entry) { return !alive.contains(entry.first); });
+
+    for (auto& task : stats) {
+        auto& info = (*tasks)[task.get()];
+        if (info.name.empty()) {
+            auto name = task->name();
+            info.name = name.empty() ? "<unnamed>" : std::string{name};
+        }
+
+        uint64_t polls = task->totalPolls();
+        auto runtime = task->totalRuntime();
+
+        uint64_t deltaPolls = polls - info.lastPolls;
+        auto deltaRuntime = runtime - info.lastRuntime;
+        info.lastPolls = polls;
+        info.lastRuntime = runtime;
+
+        if (deltaPolls == 0) continue;
+
+        info.lastAvgPoll = Duration::fromNanos(deltaRuntime.nanos() / deltaPolls);
+        info.worstAvgPoll = std::max(info.worstAvgPoll, info.lastAvgPoll);
+
+        if (info.lastAvgPoll >= SLOW_POLL_THRESHOLD) {
+            info.slowWindows++;
+
+            if (!info.warned) {
+                info.warned = true;
+                log::warn(
+                    "Task '{}' averaged {} per poll ({} polls in the last {}), it is likely doing blocking work on the runtime",
+                    info.name, info.lastAvgPoll.toString(), deltaPolls, SAMPLE_INTERVAL.toString()
+                );
+            }
+        }
+    }
+}
+
+std::string TaskMonitor::summary() {
+    auto tasks = m_tasks.lock();
+    std::string out;
+
+    for (auto& [_, info] : *tasks) {
+        fmt::format_to(
+            std::back_inserter(out),
+            "- {}: last avg poll {}, worst avg poll {}, slow windows: {}{}\n",
+            info.name,
+            info.lastAvgPoll.toString(),
+            info.worstAvgPoll.toString(),
+            info.slowWindows,
+            info.worstAvgPoll >= SLOW_POLL_THRESHOLD ? " (BLOCKING)" : ""
+        );
+    }
+
+    return out;
+}
+
+void TaskMonitor::dump() {
+    auto out = this->summary();
+
+    if (out.empty()) {
+        log::info("No samples yet, enable network stat dumps to start sampling tasks");
+        return;
+    }
+
+    for (auto& line : utils::string::split(out, "\n")) {
+        if (!line.empty()) log::info("{}", line);
+    }
+}
+
+}
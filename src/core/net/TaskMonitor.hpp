@@ -0,0 +1,46 @@
+#pragma once
+
+#include <globed/util/singleton.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <asp/time/Duration.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace globed {
+
+/// Periodically samples the async runtime task stats and tracks the average poll duration of every task.
+/// A task that takes long to poll is doing blocking work on the runtime and delays every other task on that thread.
+class TaskMonitor : public SingletonLeakBase<TaskMonitor> {
+    friend class SingletonLeakBase;
+    TaskMonitor() = default;
+
+public:
+    /// Task loop that samples the runtime while lock instrumentation is enabled
+    arc::Future<> run();
+
+    /// Takes a sample of all tasks, comparing against the previous one
+    void sample();
+
+    /// Describes the collected stats, one line per task
+    std::string summary();
+
+    /// Logs the collected stats
+    void dump();
+
+private:
+    struct TaskInfo {
+        std::string name;
+        uint64_t lastPolls = 0;
+        asp::Duration lastRuntime;
+        asp::Duration lastAvgPoll;
+        asp::Duration worstAvgPoll;
+        size_t slowWindows = 0;
+        bool warned = false;
+    };
+
+    asp::Mutex<std::unordered_map<const void*, TaskInfo>> m_tasks;
+};
+
+}
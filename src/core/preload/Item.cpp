@@ -3,6 +3,7 @@
 #include "OpenGL.hpp"
 #include "PreloadManager.hpp"
 #include "spriteframes.hpp"
+#include <util/Profiler.hpp>
 #include <prevter.imageplus/include/events.hpp>
 #include <bit>
 
@@ -129,6 +130,8 @@ void PreloadItemState::enqueueImageDecode() {
     auto& pool = *m_batchState->pool;
 
     pool.pushTask([this] {
+        GLOBED_PROFILE_ZONE("Preload Image Decode");
+
         // Initial state - load image into memory, then kick off the decoding process
         unsigned long filesize = 0;
         auto buffer = getFileDataThreadSafe(m_path.c_str(), "rb", &filesize);
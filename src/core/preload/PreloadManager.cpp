@@ -7,6 +7,7 @@
 #include <asp/format.hpp>
 #include "FileUtils.hpp"
 #include "Item.hpp"
+#include <util/Profiler.hpp>
 
 #include <Geode/modify/CCTextureCache.hpp>
 #include <Geode/modify/CCSpriteFrameCache.hpp>
@@ -287,6 +288,8 @@ void PreloadManager::loadIcon(IconType ty, int icon, PreloadOptions options) {
 }
 
 void PreloadManager::doLoadBatch(std::vector<PreloadItem> items, PreloadOptions options) {
+    GLOBED_PROFILE_ZONE("Preload Batch");
+
     if (!m_sstate.initialized) {
         this->initSessionState();
     }
@@ -1,7 +1,11 @@
 // Global setup stuff
 #include <Geode/Geode.hpp>
 #include <globed/core/SettingsManager.hpp>
+#include <globed/util/InstrumentedLock.hpp>
 #include <core/net/NetworkManagerImpl.hpp>
+#include <core/net/TaskMonitor.hpp>
+#include <util/Profiler.hpp>
+#include <util/BinLog.hpp>
 #include <qunet/Log.hpp>
 #include <asp/Log.hpp>
 #include <arc/util/Trace.hpp>
@@ -40,6 +44,31 @@ $execute {
         debugEnabled = value;
     });
 
+    // the profiler is needed both for exporting traces and for the frame time overlay
+    globed::Profiler::get().setEnabled(
+        globed::setting<bool>("core.dev.profiler") || globed::setting<bool>("core.dev.profile-frame-time")
+    );
+    globed::SettingsManager::get().listenForChanges<bool>("core.dev.profiler", [](bool value) {
+        globed::Profiler::get().setEnabled(value || globed::setting<bool>("core.dev.profile-frame-time"));
+    });
+    globed::SettingsManager::get().listenForChanges<bool>("core.dev.profile-frame-time", [](bool value) {
+        globed::Profiler::get().setEnabled(value || globed::setting<bool>("core.dev.profiler"));
+    });
+
+    // lock wait/hold times are only measured when network stats are enabled, otherwise locking costs nothing extra
+    globed::LockStats::setEnabled(globed::setting<bool>("core.dev.net-stat-dump"));
+    globed::SettingsManager::get().listenForChanges<bool>("core.dev.net-stat-dump", [](bool value) {
+        globed::LockStats::setEnabled(value);
+    });
+
+    globed::BinLog::get().setEnabled(globed::setting<bool>("core.dev.binary-logs"));
+    globed::SettingsManager::get().listenForChanges<bool>("core.dev.binary-logs", [](bool value) {
+        globed::BinLog::get().setEnabled(value);
+    });
+
+    globed::Profiler::get().addExportInfo("locks", [] { return globed::LockStats::summary(); });
+    globed::Profiler::get().addExportInfo("tasks", [] { return globed::TaskMonitor::get().summary(); });
+
     qn::log::setLogFunction([](qn::log::Level level, const std::string& message) {
         // globed::NetworkManagerImpl::get().logQunetMessage(level, message);
 
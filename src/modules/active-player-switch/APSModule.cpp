@@ -11,6 +11,7 @@ APSModule::APSModule() {}
 
 void APSModule::onModuleInit() {
     this->setAutoEnableMode(AutoEnableMode::Level);
+    this->setSkippedPhases(ModuleUpdatePhase::Update);
 }
 
 void APSModule::onJoinLevel(GlobedGJBGL* gjbgl, GJGameLevel* level, bool editor) {
@@ -35,9 +36,9 @@ void APSModule::onPlayerDeath(GlobedGJBGL* gjbgl, RemotePlayer* player, const Pl
     }
 }
 
-void APSModule::onPreUpdate(GlobedGJBGL* gjbgl, float dt) {
+void APSModule::onFramePreUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) {
     if (auto pl = APSPlayLayer::get(gjbgl)) {
-        pl->handleUpdate(dt);
+        pl->handleUpdate(ctx.dt);
     }
 }
 
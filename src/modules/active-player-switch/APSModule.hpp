@@ -28,7 +28,7 @@ public:
 private:
     void onJoinLevel(GlobedGJBGL* gjbgl, GJGameLevel* level, bool editor) override;
     void onPlayerDeath(GlobedGJBGL* gjbgl, RemotePlayer* player, const PlayerDeath& death) override;
-    void onPreUpdate(GlobedGJBGL* gjbgl, float dt) override;
+    void onFramePreUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) override;
     void onLocalPlayerDeath(GlobedGJBGL* gjbgl, bool real) override;
     void onPlayerRespawn(GlobedGJBGL* gjbgl, RemotePlayer* player) override;
 
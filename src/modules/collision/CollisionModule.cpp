@@ -13,6 +13,7 @@ CollisionModule::CollisionModule() {}
 
 void CollisionModule::onModuleInit() {
     this->setAutoEnableMode(AutoEnableMode::Level);
+    this->setSkippedPhases(ModuleUpdatePhase::All);
 }
 
 void CollisionModule::onJoinLevel(GlobedGJBGL* gjbgl, GJGameLevel* level, bool editor) {
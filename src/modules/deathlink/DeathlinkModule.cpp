@@ -12,6 +12,7 @@ DeathlinkModule::DeathlinkModule() = default;
 
 void DeathlinkModule::onModuleInit() {
     this->setAutoEnableMode(AutoEnableMode::Level);
+    this->setSkippedPhases(ModuleUpdatePhase::All);
 }
 
 void DeathlinkModule::onJoinLevel(GlobedGJBGL* gjbgl, GJGameLevel* level, bool editor) {
@@ -14,6 +14,7 @@ GlobalTriggersModule::GlobalTriggersModule() {}
 void GlobalTriggersModule::onModuleInit() {
     log::info("Global triggers module initialized");
     this->setAutoEnableMode(AutoEnableMode::Level);
+    this->setSkippedPhases(ModuleUpdatePhase::All);
 }
 
 void GlobalTriggersModule::queueCounterChange(const CounterChange& change) {
@@ -3,6 +3,7 @@
 #include <Geode/Geode.hpp>
 #include <Geode/modify/GJBaseGameLayer.hpp>
 #include <globed/config.hpp>
+#include <globed/util/FlatIntMap.hpp>
 #include <globed/core/data/Messages.hpp>
 #include <globed/core/net/MessageListener.hpp>
 #include "../GlobalTriggersModule.hpp"
@@ -15,7 +16,7 @@ struct GLOBED_MODIFY_ATTR GTriggersGJBGL : geode::Modify<GTriggersGJBGL, GJBaseG
     struct Fields {
         MessageListener<msg::LevelDataMessage> m_listener;
         geode::ListenerHandle m_eventListener;
-        std::unordered_map<int, bool> m_pausedPlayers;
+        FlatIntMap<bool> m_pausedPlayers;
 
         int m_totalJoins = 0, m_totalLeaves = 0;
         bool m_firstPacket = true;
@@ -3,13 +3,14 @@
 #include <Geode/Geode.hpp>
 #include <Geode/modify/GJEffectManager.hpp>
 #include <globed/config.hpp>
+#include <globed/util/FlatIntMap.hpp>
 #include "../GlobalTriggersModule.hpp"
 
 namespace globed {
 
 struct GLOBED_MODIFY_ATTR HookedGJEffectManager : geode::Modify<HookedGJEffectManager, GJEffectManager> {
     struct Fields {
-        std::unordered_map<int, int> m_customItems;
+        FlatIntMap<int> m_customItems;
     };
 
     static void onModify(auto& self) {
@@ -9,6 +9,7 @@ ScriptingUIModule::ScriptingUIModule() {}
 void ScriptingUIModule::onModuleInit() {
     log::info("Scripting UI module initialized");
     this->setAutoEnableMode(AutoEnableMode::Launch);
+    this->setSkippedPhases(ModuleUpdatePhase::All);
 }
 
 }
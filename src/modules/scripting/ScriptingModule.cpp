@@ -9,6 +9,7 @@ ScriptingModule::ScriptingModule() {}
 void ScriptingModule::onModuleInit() {
     log::info("Scripting module initialized");
     this->setAutoEnableMode(AutoEnableMode::Level);
+    this->setSkippedPhases(ModuleUpdatePhase::All);
 }
 
 }
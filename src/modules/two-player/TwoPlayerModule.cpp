@@ -26,6 +26,7 @@ TwoPlayerModule::TwoPlayerModule() {
 
 void TwoPlayerModule::onModuleInit() {
     this->setAutoEnableMode(AutoEnableMode::Level);
+    this->setSkippedPhases(ModuleUpdatePhase::Update);
 }
 
 Result<> TwoPlayerModule::onDisabled() {
@@ -122,7 +123,7 @@ void TwoPlayerModule::onLocalPlayerDeath(GlobedGJBGL* gjbgl, bool real) {
     }
 }
 
-void TwoPlayerModule::onPreUpdate(GlobedGJBGL* gjbgl, float dt) {
+void TwoPlayerModule::onFramePreUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) {
     auto ghost = gjbgl->m_fields->m_ghost.get();
     PlayerObject* noclipFor = this->isPlayer2() ? gjbgl->m_player1 : gjbgl->m_player2;
     PlayerObject* noclipForVP = this->isPlayer2() ? ghost->player1() : ghost->player2();
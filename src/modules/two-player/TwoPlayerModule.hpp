@@ -67,7 +67,7 @@ private:
     }
 
     void onLocalPlayerDeath(GlobedGJBGL* gjbgl, bool real) override;
-    void onPreUpdate(GlobedGJBGL* gjbgl, float dt) override;
+    void onFramePreUpdate(GlobedGJBGL* gjbgl, const FrameContext& ctx) override;
 
     void sendUnlinkEventTo(int id);
     void sendLinkEventTo(int id, bool player2);
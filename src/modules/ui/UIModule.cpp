@@ -8,6 +8,7 @@ UIModule::UIModule() {}
 
 void UIModule::onModuleInit() {
     this->setAutoEnableMode(AutoEnableMode::Server);
+    this->setSkippedPhases(ModuleUpdatePhase::All);
 }
 
 }
@@ -2,6 +2,7 @@
 #include <globed/core/RoomManager.hpp>
 #include <globed/core/PopupManager.hpp>
 #include <globed/core/EmoteManager.hpp>
+#include <globed/audio/VoiceDecodePool.hpp>
 #include <core/net/NetworkManagerImpl.hpp>
 #include <core/game/SettingCache.hpp>
 #include <core/hooks/GJBaseGameLayer.hpp>
@@ -46,6 +47,8 @@ struct GLOBED_MODIFY_ATTR UIHookedPauseLayer : Modify<UIHookedPauseLayer, PauseL
 
         ~Fields() {
             CachedSettings::get().reload();
+            // voice settings might have changed, let the game layer decide again which players can be heard
+            VoiceDecodePool::get().clearRoutes();
         }
     };
 
@@ -383,6 +383,7 @@ void EmoteListPopup::setFavorite(uint32_t emoteSlot, uint32_t id) {
     m_clearFavoriteBtn->setVisible(false);
 
     globed::setValue(fmt::format("core.ui.emote-slot-{}", emoteSlot), id);
+    EmoteManager::get().warmFavoriteSfx();
 }
 
 void EmoteListPopup::updatePage(bool increment) {
@@ -4,6 +4,7 @@
 #include <globed/core/FriendListManager.hpp>
 #include <globed/core/PlayerCacheManager.hpp>
 #include <globed/audio/AudioManager.hpp>
+#include <globed/audio/VoiceDecodePool.hpp>
 #include <globed/core/net/NetworkManager.hpp>
 #include <core/hooks/GJBaseGameLayer.hpp>
 #include <core/net/NetworkManagerImpl.hpp>
@@ -160,6 +161,10 @@ protected:
                     if (stream) {
                         stream->setMuted(muted);
                     }
+
+                    if (muted) {
+                        VoiceDecodePool::get().removeRoute(accountId);
+                    }
                 }
             );
 
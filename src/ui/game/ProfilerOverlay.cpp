@@ -19,6 +19,13 @@ bool ProfilerOverlay::init(CCSize size) {
         .parent(this);
     m_drawNode->m_bUseArea = false;
 
+    m_statsLabel = Build<Label>::create("", "bigFont.fnt")
+        .scale(0.25f)
+        .anchorPoint(0.f, 1.f)
+        .pos(2.f, m_drawSize.height - 2.f)
+        .zOrder(1)
+        .parent(this);
+
     m_legend = Build<ColumnContainer>::create()
         .anchorPoint(0.f, 0.f)
         .pos(m_drawSize.width + 3.f, 0.f)
@@ -122,6 +129,20 @@ void ProfilerOverlay::updateWithFrame(const ProfilerFrame& frame) {
         }
     }
 
+#ifdef GLOBED_ALLOC_AUDIT
+    auto allocs = AllocAudit::lastFrameTotals();
+    m_statsLabel->setString(fmt::format(
+        "Deferred tasks: {} | Player draw calls: {} | Allocs: {} ({} B)",
+        frame.deferredQueueDepth, frame.playerDrawCalls, allocs.count, allocs.bytes
+    ));
+#else
+    if (frame.deferredQueueDepth != m_lastQueueDepth || frame.playerDrawCalls != m_lastDrawCalls) {
+        m_lastQueueDepth = frame.deferredQueueDepth;
+        m_lastDrawCalls = frame.playerDrawCalls;
+        m_statsLabel->setString(fmt::format("Deferred tasks: {} | Player draw calls: {}", m_lastQueueDepth, m_lastDrawCalls));
+    }
+#endif
+
     for (auto& sample : frame.samples) {
         if (m_legendNames.insert(sample.name).second) {
             this->addNewEntryToLegend(sample.name, sample.color);
@@ -129,6 +150,64 @@ void ProfilerOverlay::updateWithFrame(const ProfilerFrame& frame) {
     }
 }
 
+void ProfilerOverlay::collectFrame(uint64_t frameStart, size_t deferredQueueDepth, size_t playerDrawCalls) {
+    auto& prof = Profiler::get();
+    uint64_t now = prof.now();
+
+    m_zoneScratch.clear();
+    prof.threadBuffer().snapshot(m_zoneScratch, frameStart, 0);
+
+    ProfilerFrame frame {
+        .totalTime = Duration::fromNanos(now - frameStart),
+        .deferredQueueDepth = deferredQueueDepth,
+        .playerDrawCalls = playerDrawCalls,
+    };
+    frame.samples.reserve(m_zoneScratch.size());
+
+    for (auto& zone : m_zoneScratch) {
+        // zones that started before this frame belong to the previous one
+        if (zone.start < frameStart) continue;
+
+        frame.samples.emplace_back(zone.name, Duration::fromNanos(zone.end - zone.start), colorForZone(zone.name));
+    }
+
+    this->updateWithFrame(frame);
+}
+
+ccColor4F ProfilerOverlay::colorForZone(std::string_view name) {
+    static const std::pair<std::string_view, std::string_view> knownColors[] = {
+        {"Interpolation", "#23e8fa"},
+        {"Player Upd", "#4caf50"},
+        {"Deferred Work", "#9c27b0"},
+        {"Audio Upd", "#0707f2"},
+        {"Pre Misc", "#757575"},
+        {"Game Update", "#ffeb3b"},
+        {"Send Data", "#fb8c00"},
+        {"Periodical Upd", "#e91e63"},
+        {"Post Misc", "#455a64"},
+    };
+
+    // zones from other places get a stable color based on their name
+    static const std::string_view palette[] = {
+        "#f44336", "#3f51b5", "#009688", "#cddc39", "#ff5722", "#795548", "#00bcd4", "#8bc34a",
+    };
+
+    std::string_view hex;
+    for (auto& [zname, zcolor] : knownColors) {
+        if (zname == name) {
+            hex = zcolor;
+            break;
+        }
+    }
+
+    if (hex.empty()) {
+        hex = palette[std::hash<std::string_view>{}(name) % std::size(palette)];
+    }
+
+    auto col = cc3bFromHexString(hex).unwrapOrDefault();
+    return ccColor4F { col.r / 255.f, col.g / 255.f, col.b / 255.f, 1.0f };
+}
+
 void ProfilerOverlay::addNewEntryToLegend(std::string_view name, cocos2d::ccColor4F color) {
     auto container = Build<RowContainer>::create()
         .parent(m_legend)
@@ -164,4 +243,25 @@ ProfilerOverlay* ProfilerOverlay::create(CCSize size) {
     return nullptr;
 }
 
+void DrawCounterNode::visit() {
+    // the counter is only reset by the director when fps stats are shown, so use the difference
+    auto before = g_uNumberOfDraws;
+    CCNode::visit();
+    m_lastDrawCalls = g_uNumberOfDraws - before;
+}
+
+size_t DrawCounterNode::getLastDrawCalls() const {
+    return m_lastDrawCalls;
+}
+
+DrawCounterNode* DrawCounterNode::create() {
+    auto ret = new DrawCounterNode();
+    if (ret->init()) {
+        ret->autorelease();
+        return ret;
+    }
+    delete ret;
+    return nullptr;
+}
+
 }
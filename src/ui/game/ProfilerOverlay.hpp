@@ -1,5 +1,7 @@
 #pragma once
 #include <globed/prelude.hpp>
+#include <util/Profiler.hpp>
+#include <Geode/ui/Label.hpp>
 
 namespace globed {
 
@@ -8,23 +10,28 @@ struct ProfilerSample {
     geode::ZStringView name;
     cocos2d::ccColor4F color;
 
-    ProfilerSample(geode::ZStringView name, asp::Instant start, asp::Instant end, std::string_view hex) {
-        this->name = name;
-        this->time = end.durationSince(start);
-
-        auto col = geode::cocos::cc3bFromHexString(hex).unwrapOrDefault();
-        this->color = cocos2d::ccColor4F {
-            col.r / 255.f,
-            col.g / 255.f,
-            col.b / 255.f,
-            1.0f
-        };
-    }
+    ProfilerSample(geode::ZStringView name, asp::Duration time, cocos2d::ccColor4F color)
+        : time(time), name(name), color(color) {}
 };
 
 struct ProfilerFrame {
     asp::Duration totalTime;
     std::vector<ProfilerSample> samples;
+    size_t deferredQueueDepth = 0;
+    size_t playerDrawCalls = 0;
+};
+
+/// Node that counts the draw calls made while drawing itself and its children, using the cocos draw counter
+class DrawCounterNode : public CCNode {
+public:
+    static DrawCounterNode* create();
+
+    void visit() override;
+    /// Draw calls made during the last visit
+    size_t getLastDrawCalls() const;
+
+private:
+    size_t m_lastDrawCalls = 0;
 };
 
 class ProfilerOverlay : public CCNode {
@@ -32,6 +39,8 @@ public:
     static ProfilerOverlay* create(CCSize size);
 
     void updateWithFrame(const ProfilerFrame& frame);
+    /// Builds a frame out of all top level zones recorded on this thread since `frameStart`
+    void collectFrame(uint64_t frameStart, size_t deferredQueueDepth, size_t playerDrawCalls);
     void doUpdate(float);
 
 private:
@@ -40,13 +49,18 @@ private:
     CCSize m_drawSize;
     CCNode* m_legend;
     CCNode* m_legendBg = nullptr;
+    Label* m_statsLabel = nullptr;
+    size_t m_lastQueueDepth = -1;
+    size_t m_lastDrawCalls = -1;
     std::unordered_set<std::string> m_legendNames;
+    std::vector<ProfilerZoneEvent> m_zoneScratch;
     float m_smoothedMaxTime = 1.f / 60.f;
 
     bool init(CCSize size);
 
     void redraw();
     void addNewEntryToLegend(std::string_view name, cocos2d::ccColor4F color);
+    static cocos2d::ccColor4F colorForZone(std::string_view name);
 };
 
 }
@@ -3,10 +3,13 @@
 #include <globed/audio/AudioManager.hpp>
 #include <globed/core/PlayerCacheManager.hpp>
 
+#include <UIBuilder.hpp>
+
 using namespace geode::prelude;
 using namespace asp::time;
 
 static constexpr float VOICE_OVERLAY_PAD_X = 5.f;
+static constexpr auto QUALITY_LABEL_TIME = Duration::fromMillis(4000);
 static float g_threshold = 0.f;
 
 namespace globed {
@@ -60,6 +63,11 @@ void VoiceOverlay::update(float dt) {
         this->updateStream(*gjbgl->m_fields->m_ghost, true);
     }
 
+    if (m_qualityLabel && m_qualityShownAt.elapsed() > QUALITY_LABEL_TIME) {
+        m_qualityLabel->removeFromParent();
+        m_qualityLabel = nullptr;
+    }
+
     this->updateLayout();
 }
 
@@ -130,6 +138,25 @@ void VoiceOverlay::removeStream(int id) {
     }
 }
 
+void VoiceOverlay::showQualityChange(const VoiceEncoderSettings& settings, std::string_view reason) {
+    if (!m_qualityLabel) {
+        m_qualityLabel = Build<Label>::create("", "bigFont.fnt")
+            .scale(0.3f)
+            .opacity(180)
+            .zOrder(1) // laid out after the player cells
+            .parent(this)
+            .id("voice-quality-label"_spr);
+    }
+
+    m_qualityLabel->setText(fmt::format(
+        "Voice: {} kbps, complexity {}, FEC {}% ({})",
+        settings.bitrate / 1000, settings.complexity, settings.fecLossPercent, reason
+    ));
+    m_qualityShownAt = Instant::now();
+
+    this->updateLayout();
+}
+
 VoiceOverlay* VoiceOverlay::create() {
     auto ret = new VoiceOverlay;
     if (ret->init()) {
@@ -2,6 +2,7 @@
 
 #include <globed/prelude.hpp>
 #include "VoiceOverlayCell.hpp"
+#include <globed/audio/VoiceQualityController.hpp>
 
 #include <Geode/Geode.hpp>
 
@@ -15,9 +16,13 @@ public:
     void updateSoft();
     void reposition();
     void removeStream(int id);
+    // briefly shows the new voice encoder settings below the speaking players
+    void showQualityChange(const VoiceEncoderSettings& settings, std::string_view reason);
 
 private:
     std::unordered_map<int, VoiceOverlayCell*> m_cells;
+    Label* m_qualityLabel = nullptr;
+    asp::time::Instant m_qualityShownAt;
 
     bool init() override;
 
@@ -29,7 +29,9 @@ bool LazyPlayerIcon::init(const Icons& icons) {
 
 void LazyPlayerIcon::updateIcons(const Icons& icons) {
     if (shouldSkipLoading(icons)) {
-        return PlayerIcon::updateIcons(icons);
+        PlayerIcon::updateIcons(icons);
+        if (m_updateCallback) m_updateCallback();
+        return;
     }
 
     if (m_waiting) {
@@ -55,6 +57,12 @@ void LazyPlayerIcon::updateIcons(const Icons& icons) {
 void LazyPlayerIcon::onLoaded() {
     PlayerIcon::updateIcons(m_realIcons);
     m_waiting = false;
+
+    if (m_updateCallback) m_updateCallback();
+}
+
+void LazyPlayerIcon::setUpdateCallback(geode::Function<void()> callback) {
+    m_updateCallback = std::move(callback);
 }
 
 LazyPlayerIcon* LazyPlayerIcon::create(const Icons& icons) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cue/PlayerIcon.hpp>
+#include <Geode/utils/function.hpp>
 
 namespace globed {
 
@@ -17,10 +18,13 @@ public:
     }
 
     void updateIcons(const Icons& icons);
+    /// Sets a callback that is invoked every time the displayed icons change
+    void setUpdateCallback(geode::Function<void()> callback);
 
 protected:
     Icons m_realIcons;
     bool m_waiting = false;
+    geode::Function<void()> m_updateCallback;
 
     bool init(const Icons& icons);
     void onLoaded();
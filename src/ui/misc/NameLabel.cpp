@@ -14,10 +14,17 @@ namespace globed {
 static constexpr float NAME_HEIGHT = 17.f;
 static constexpr float MAX_NAME_WIDTH = 140.f;
 
-bool NameLabel::init(const std::string& name, const char* font) {
+NameLabel::~NameLabel() {
+    if (m_batchedText) {
+        m_batchedText->removeFromParent();
+    }
+}
+
+bool NameLabel::init(const std::string& name, const char* font, NameLabelBatch* batch) {
     if (!CCMenu::init()) return false;
 
     m_font = font;
+    m_batch = batch;
     m_shadow = false;
 
     auto bcLayout = SimpleRowLayout::create()
@@ -57,6 +64,28 @@ void NameLabel::updateName(const std::string& name) {
 }
 
 void NameLabel::updateName(const char* name) {
+    if (m_batch) {
+        if (!m_batchedText) {
+            m_batchedText = m_batch->createText();
+            m_batchedText->setShadowEnabled(m_shadow);
+
+            // takes up the space of the text in the layout, the text itself is drawn by the batch
+            m_textPlaceholder = Build<CCNode>::create()
+                .zOrder(-2)
+                .parent(this);
+        }
+
+        m_batchedText->setString(name);
+
+        auto size = m_batchedText->getTextSize();
+        float scale = std::min(NAME_HEIGHT / size.height, MAX_NAME_WIDTH / size.width);
+        m_batchedText->setTextScale(scale);
+        m_textPlaceholder->setContentSize(size * scale);
+
+        this->updateSelfWidth();
+        return;
+    }
+
     if (!m_label) {
         m_labelContainer = Build<CCNode>::create()
             .zOrder(-2);
@@ -117,6 +146,56 @@ void NameLabel::updateSelfWidth() {
     if (m_labelButton) {
         m_labelButton->setScale(scale);
     }
+
+    this->syncBatchedText();
+}
+
+void NameLabel::syncBatchedText() {
+    if (!m_batchedText) return;
+
+    // the text mirrors the transform of this node, its parent must be a sibling of this label
+    m_batchedText->setVisible(m_bVisible);
+    m_batchedText->setContentSize(m_obContentSize);
+    m_batchedText->setAnchorPoint(m_obAnchorPoint);
+    m_batchedText->setPosition(m_obPosition);
+    m_batchedText->setRotationX(m_fRotationX);
+    m_batchedText->setRotationY(m_fRotationY);
+    m_batchedText->setScaleX(m_fScaleX);
+    m_batchedText->setScaleY(m_fScaleY);
+
+    if (m_textPlaceholder) {
+        m_batchedText->setTextOffset(m_textPlaceholder->getPosition() - m_textPlaceholder->getAnchorPointInPoints());
+    }
+}
+
+void NameLabel::setPosition(const CCPoint& pos) {
+    CCMenu::setPosition(pos);
+    if (m_batchedText) m_batchedText->setPosition(pos);
+}
+
+void NameLabel::setRotation(float rot) {
+    CCMenu::setRotation(rot);
+    if (m_batchedText) m_batchedText->setRotation(rot);
+}
+
+void NameLabel::setScaleX(float scale) {
+    CCMenu::setScaleX(scale);
+    if (m_batchedText) m_batchedText->setScaleX(scale);
+}
+
+void NameLabel::setScaleY(float scale) {
+    CCMenu::setScaleY(scale);
+    if (m_batchedText) m_batchedText->setScaleY(scale);
+}
+
+void NameLabel::setScale(float scale) {
+    CCMenu::setScale(scale);
+    if (m_batchedText) m_batchedText->setScale(scale);
+}
+
+void NameLabel::setVisible(bool visible) {
+    CCMenu::setVisible(visible);
+    if (m_batchedText) m_batchedText->setVisible(visible);
 }
 
 void NameLabel::onClick(geode::Button* btn) {
@@ -242,7 +321,8 @@ void NameLabel::updateColor(const Color3& color) {
 }
 
 void NameLabel::updateLabelColors() {
-    if (!m_label) return;
+    CCRGBAProtocol* text = m_batchedText ? static_cast<CCRGBAProtocol*>(m_batchedText.data()) : m_label;
+    if (!text) return;
 
     // team color always overrides the name color
     if (m_teamColor) {
@@ -260,8 +340,8 @@ void NameLabel::updateLabelColors() {
 
             this->resizeBadgeContainer();
         } else {
-            m_label->setColor(color);
-            m_label->setOpacity(m_teamColor->a);
+            text->setColor(color);
+            text->setOpacity(m_teamColor->a);
         }
 
         return;
@@ -270,17 +350,21 @@ void NameLabel::updateLabelColors() {
     if (m_teamLabel) m_teamLabel->setVisible(false);
 
     if (m_color.isGradient()) {
-        m_label->setGradientColors(m_color);
+        m_batchedText ? m_batchedText->setGradientColors(m_color.getColors()) : m_label->setGradientColors(m_color);
     } else if (m_color.isTint()) {
-        m_color.animateNode(m_label);
+        m_color.animateNode(text);
     } else {
-        m_label->setColor(m_color.getColor());
+        text->setColor(m_color.getColor());
     }
 
     this->resizeBadgeContainer();
 }
 
 void NameLabel::updateOpacity(unsigned char opacity) {
+    if (m_batchedText) {
+        m_batchedText->setOpacity(opacity);
+    }
+
     if (m_label) {
         m_label->setOpacity(opacity);
         m_labelShadow->setOpacity(opacity * 0.75f);
@@ -293,7 +377,7 @@ void NameLabel::updateOpacity(unsigned char opacity) {
 
 void NameLabel::makeClickable(geode::Function<void(geode::Button*)> callback) {
     m_callback = std::move(callback);
-    m_labelButton->setEnabled(true);
+    if (m_labelButton) m_labelButton->setEnabled(true);
 }
 
 void NameLabel::setMultipleBadges(bool multiple) {
@@ -306,6 +390,10 @@ void NameLabel::setShadowEnabled(bool enabled) {
     if (m_labelShadow) {
         m_labelShadow->setVisible(enabled);
     }
+
+    if (m_batchedText) {
+        m_batchedText->setShadowEnabled(enabled);
+    }
 }
 
 NameLabel* NameLabel::create(const std::string& name, const char* font) {
@@ -319,4 +407,15 @@ NameLabel* NameLabel::create(const std::string& name, const char* font) {
     return nullptr;
 }
 
+NameLabel* NameLabel::createBatched(const std::string& name, NameLabelBatch* batch) {
+    auto ret = new NameLabel();
+    if (ret->init(name, batch->getFontName(), batch)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
+
 }
\ No newline at end of file
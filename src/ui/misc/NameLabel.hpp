@@ -4,6 +4,7 @@
 #include <globed/aliases.hpp>
 #include <globed/core/data/SpecialUserData.hpp>
 #include <ui/misc/GradientLabel.hpp>
+#include <ui/misc/NameLabelBatch.hpp>
 
 #include <Geode/utils/function.hpp>
 #include <Geode/ui/Button.hpp>
@@ -12,7 +13,11 @@ namespace globed {
 
 class NameLabel : public cocos2d::CCMenu {
 public:
+    ~NameLabel();
+
     static NameLabel* create(const std::string& name, const char* font = "chatFont.fnt");
+    /// Creates a name label whose text is drawn by `batch` instead of its own nodes. Such labels are not clickable.
+    static NameLabel* createBatched(const std::string& name, NameLabelBatch* batch);
 
     void makeClickable(geode::Function<void(geode::Button*)> callback);
     void updateName(const std::string& name);
@@ -31,12 +36,22 @@ public:
     void removeAllBadges();
     void updateSelfWidth();
 
+    void setPosition(const cocos2d::CCPoint& pos) override;
+    void setRotation(float rot) override;
+    void setScaleX(float scale) override;
+    void setScaleY(float scale) override;
+    void setScale(float scale) override;
+    void setVisible(bool visible) override;
+
 private:
     GradientLabel* m_label = nullptr;
     Label* m_labelShadow = nullptr;
     Label* m_teamLabel = nullptr;
     Ref<CCNode> m_labelContainer = nullptr;
     Button* m_labelButton = nullptr;
+    NameLabelBatch* m_batch = nullptr;
+    Ref<BatchedText> m_batchedText;
+    CCNode* m_textPlaceholder = nullptr;
     CCNode* m_badgeContainer = nullptr;
     geode::Function<void(Button*)> m_callback;
     const char* m_font = nullptr;
@@ -46,10 +61,11 @@ private:
     std::optional<ccColor4B> m_teamColor;
     size_t m_teamIdx = 0;
 
-    bool init(const std::string& name, const char* font);
+    bool init(const std::string& name, const char* font, NameLabelBatch* batch = nullptr);
     void resizeBadgeContainer();
     void onClick(geode::Button* btn);
     void updateLabelColors();
+    void syncBatchedText();
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "NameLabelBatch.hpp"
+
+#include <asp/time/Instant.hpp>
+
+using namespace geode::prelude;
+using namespace asp::time;
+
+namespace globed {
+
+static const Instant g_gradientTimer = Instant::now();
+
+/// Glyph sprite that supports different colors on the left and right edge
+class BatchedGlyph : public CCSprite {
+public:
+    static BatchedGlyph* create(CCTexture2D* texture, const CCRect& rect) {
+        auto ret = new BatchedGlyph;
+        if (ret->initWithTexture(texture, rect)) {
+            ret->autorelease();
+            return ret;
+        }
+
+        delete ret;
+        return nullptr;
+    }
+
+    void setVertexColors(ccColor4B left, ccColor4B right) {
+        m_sQuad.bl.colors = left;
+        m_sQuad.tl.colors = left;
+        m_sQuad.br.colors = right;
+        m_sQuad.tr.colors = right;
+
+        // same as CCSprite::updateColor, push the quad into the atlas if it's already there
+        if (m_pobBatchNode) {
+            if (m_uAtlasIndex != CCSpriteIndexNotInitialized) {
+                m_pobTextureAtlas->updateQuad(&m_sQuad, m_uAtlasIndex);
+            } else {
+                this->setDirty(true);
+            }
+        }
+    }
+};
+
+static ccColor4B premultiplied(ccColor3B color, GLubyte opacity) {
+    return ccColor4B {
+        static_cast<GLubyte>(color.r * opacity / 255),
+        static_cast<GLubyte>(color.g * opacity / 255),
+        static_cast<GLubyte>(color.b * opacity / 255),
+        opacity,
+    };
+}
+
+static ccColor3B sampleGradient(const std::vector<ccColor3B>& colors, float t) {
+    // same as the GradientLabel shader, the first color is repeated at the end
+    float segments = static_cast<float>(colors.size() - 1);
+    float scaled = t * segments;
+    size_t idx = std::min(static_cast<size_t>(scaled), colors.size() - 2);
+    float local = scaled - static_cast<float>(idx);
+
+    auto& a = colors[idx];
+    auto& b = colors[idx + 1];
+
+    return ccColor3B {
+        static_cast<GLubyte>(a.r + (b.r - a.r) * local),
+        static_cast<GLubyte>(a.g + (b.g - a.g) * local),
+        static_cast<GLubyte>(a.b + (b.b - a.b) * local),
+    };
+}
+
+bool BatchedText::init(NameLabelBatch* batch) {
+    if (!CCSprite::initWithTexture(batch->getTexture(), CCRect{})) return false;
+
+    m_batch = batch;
+    this->setCascadeColorEnabled(false);
+    this->setCascadeOpacityEnabled(false);
+
+    m_shadowNode = CCSprite::createWithTexture(batch->getTexture(), CCRect{});
+    m_shadowNode->setAnchorPoint({0.f, 0.f});
+    this->addChild(m_shadowNode, -1);
+
+    m_textNode = CCSprite::createWithTexture(batch->getTexture(), CCRect{});
+    m_textNode->setAnchorPoint({0.f, 0.f});
+    this->addChild(m_textNode, 0);
+
+    return true;
+}
+
+void BatchedText::setString(std::string_view text) {
+    this->clearGlyphs();
+
+    auto layout = m_batch->m_layoutLabel.data();
+    layout->setString(std::string{text}.c_str());
+    m_textSize = layout->getContentSize();
+
+    auto tex = m_batch->getTexture();
+
+    for (auto glyph : layout->getChildrenExt<CCSprite>()) {
+        if (!glyph->isVisible()) continue;
+
+        auto rect = glyph->getTextureRect();
+        auto pos = glyph->getPosition();
+
+        auto spr = BatchedGlyph::create(tex, rect);
+        spr->setPosition(pos);
+        m_textNode->addChild(spr);
+        m_glyphs.push_back(spr);
+
+        auto shadow = BatchedGlyph::create(tex, rect);
+        shadow->setPosition(pos);
+        m_shadowNode->addChild(shadow);
+        m_shadowGlyphs.push_back(shadow);
+    }
+
+    m_shadowNode->setVisible(m_shadow);
+    this->applyColors();
+}
+
+void BatchedText::clearGlyphs() {
+    m_textNode->removeAllChildrenWithCleanup(true);
+    m_shadowNode->removeAllChildrenWithCleanup(true);
+    m_glyphs.clear();
+    m_shadowGlyphs.clear();
+}
+
+void BatchedText::setTextScale(float scale) {
+    m_textNode->setScale(scale);
+    m_shadowNode->setScale(scale);
+}
+
+void BatchedText::setTextOffset(CCPoint offset) {
+    m_textNode->setPosition(offset);
+    m_shadowNode->setPosition(offset + CCPoint{0.75f, -0.75f});
+}
+
+void BatchedText::setShadowEnabled(bool enabled) {
+    m_shadow = enabled;
+    m_shadowNode->setVisible(enabled);
+}
+
+void BatchedText::setGradientColors(const std::vector<Color3>& colors) {
+    m_gradient.clear();
+
+    if (colors.size() > 1) {
+        for (auto& col : colors) {
+            m_gradient.push_back(col);
+        }
+
+        // push the first color as the last color, for a smooth transition
+        m_gradient.push_back(m_gradient.front());
+    }
+
+    CCSprite::setColor({255, 255, 255});
+    this->applyColors();
+}
+
+void BatchedText::setColor(const ccColor3B& color) {
+    m_gradient.clear();
+    CCSprite::setColor(color);
+    this->applyColors();
+}
+
+void BatchedText::setOpacity(GLubyte opacity) {
+    CCSprite::setOpacity(opacity);
+    this->applyColors();
+}
+
+CCSize BatchedText::getTextSize() const {
+    return m_textSize;
+}
+
+bool BatchedText::hasGradient() const {
+    return !m_gradient.empty();
+}
+
+void BatchedText::applyColors(float time) {
+    GLubyte opacity = this->getOpacity();
+    auto shadowColor = premultiplied({0, 0, 0}, static_cast<GLubyte>(opacity * 0.75f));
+
+    for (auto shadow : m_shadowGlyphs) {
+        shadow->setVertexColors(shadowColor, shadowColor);
+    }
+
+    if (m_gradient.empty()) {
+        auto color = premultiplied(this->getColor(), opacity);
+
+        for (auto glyph : m_glyphs) {
+            glyph->setVertexColors(color, color);
+        }
+
+        return;
+    }
+
+    float width = std::max(m_textSize.width, 1.f);
+    float offset = time * 0.2f;
+
+    for (auto glyph : m_glyphs) {
+        float half = glyph->getContentWidth() / 2.f;
+        float left = (glyph->getPositionX() - half) / width + offset;
+        float right = (glyph->getPositionX() + half) / width + offset;
+
+        // wrap both edges with the same offset so the gradient doesn't jump in the middle of a glyph
+        float wrap = std::floor(left);
+        left -= wrap;
+        right = std::min(right - wrap, 1.f);
+
+        glyph->setVertexColors(
+            premultiplied(sampleGradient(m_gradient, left), opacity),
+            premultiplied(sampleGradient(m_gradient, right), opacity)
+        );
+    }
+}
+
+bool NameLabelBatch::init(const char* font) {
+    m_layoutLabel = CCLabelBMFont::create("", font);
+    if (!m_layoutLabel) return false;
+
+    if (!CCSpriteBatchNode::initWithTexture(m_layoutLabel->getTexture(), 64)) return false;
+
+    m_font = font;
+    this->scheduleUpdate();
+
+    return true;
+}
+
+BatchedText* NameLabelBatch::createText() {
+    auto ret = new BatchedText;
+    if (!ret->init(this)) {
+        delete ret;
+        return nullptr;
+    }
+
+    ret->autorelease();
+    this->addChild(ret);
+    return ret;
+}
+
+const char* NameLabelBatch::getFontName() const {
+    return m_font.c_str();
+}
+
+void NameLabelBatch::update(float dt) {
+    // keep the time small and wrapping the same way as GradientLabel, so both kinds of labels animate in sync
+    float time = std::fmod(g_gradientTimer.elapsed().seconds<float>(), 10.f);
+
+    for (auto text : this->getChildrenExt<BatchedText>()) {
+        if (text->hasGradient() && text->isVisible()) {
+            text->applyColors(time);
+        }
+    }
+}
+
+NameLabelBatch* NameLabelBatch::create(const char* font) {
+    auto ret = new NameLabelBatch;
+    if (ret->init(font)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
+
+}
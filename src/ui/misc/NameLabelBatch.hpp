@@ -0,0 +1,65 @@
+#pragma once
+
+#include <globed/core/data/MultiColor.hpp>
+
+#include <Geode/Geode.hpp>
+
+namespace globed {
+
+class NameLabelBatch;
+class BatchedGlyph;
+
+/// Text of a single name label inside of a `NameLabelBatch`.
+/// The node itself draws nothing, it only holds the glyph sprites and mirrors the transform of the owning `NameLabel`.
+class BatchedText : public cocos2d::CCSprite {
+public:
+    void setString(std::string_view text);
+    void setTextScale(float scale);
+    void setTextOffset(cocos2d::CCPoint offset);
+    void setShadowEnabled(bool enabled);
+    void setGradientColors(const std::vector<Color3>& colors);
+
+    void setColor(const cocos2d::ccColor3B& color) override;
+    void setOpacity(GLubyte opacity) override;
+
+    /// Size of the text, before applying the text scale
+    cocos2d::CCSize getTextSize() const;
+    bool hasGradient() const;
+
+private:
+    friend class NameLabelBatch;
+
+    NameLabelBatch* m_batch = nullptr;
+    cocos2d::CCSprite* m_textNode = nullptr;
+    cocos2d::CCSprite* m_shadowNode = nullptr;
+    std::vector<BatchedGlyph*> m_glyphs;
+    std::vector<BatchedGlyph*> m_shadowGlyphs;
+    std::vector<cocos2d::ccColor3B> m_gradient;
+    cocos2d::CCSize m_textSize;
+    bool m_shadow = true;
+
+    bool init(NameLabelBatch* batch);
+    void clearGlyphs();
+    void applyColors(float time = 0.f);
+};
+
+/// Sprite batch that draws the text of all name labels in a level in a single draw call.
+/// Unlike `GradientLabel`, gradients are done with vertex colors, so that no shader switches are needed.
+class NameLabelBatch : public cocos2d::CCSpriteBatchNode {
+public:
+    static NameLabelBatch* create(const char* font);
+
+    BatchedText* createText();
+    const char* getFontName() const;
+    void update(float dt) override;
+
+private:
+    friend class BatchedText;
+
+    geode::Ref<cocos2d::CCLabelBMFont> m_layoutLabel;
+    std::string m_font;
+
+    bool init(const char* font);
+};
+
+}
@@ -0,0 +1,111 @@
+#include "RenderAtlas.hpp"
+
+using namespace geode::prelude;
+
+namespace globed {
+
+// empty space around every cell, so that linear filtering doesn't bleed neighbouring cells into each other
+static constexpr float CELL_PADDING = 1.f;
+
+RenderAtlas::RenderAtlas(CCSize cellSize, size_t columns, size_t rows) : m_cellSize(cellSize), m_columns(columns) {
+    float strideX = cellSize.width + CELL_PADDING * 2.f;
+    float strideY = cellSize.height + CELL_PADDING * 2.f;
+
+    m_texture = CCRenderTexture::create(
+        static_cast<int>(std::ceil(strideX * columns)),
+        static_cast<int>(std::ceil(strideY * rows)),
+        kCCTexture2DPixelFormat_RGBA8888
+    );
+    m_texture->clear(0.f, 0.f, 0.f, 0.f);
+
+    // overwrites the cell with transparent pixels instead of blending with them
+    m_clearLayer = CCLayerColor::create(ccColor4B{0, 0, 0, 0}, strideX, strideY);
+    m_clearLayer->setBlendFunc({GL_ONE, GL_ZERO});
+
+    // hand out cells starting from the first one
+    m_freeCells.reserve(columns * rows);
+    for (size_t i = columns * rows; i > 0; i--) {
+        m_freeCells.push_back(i - 1);
+    }
+}
+
+CCTexture2D* RenderAtlas::getTexture() const {
+    return m_texture->getSprite()->getTexture();
+}
+
+CCSize RenderAtlas::getCellSize() const {
+    return m_cellSize;
+}
+
+std::optional<size_t> RenderAtlas::allocCell() {
+    if (m_freeCells.empty()) {
+        return std::nullopt;
+    }
+
+    size_t cell = m_freeCells.back();
+    m_freeCells.pop_back();
+    return cell;
+}
+
+void RenderAtlas::freeCell(size_t cell) {
+    m_freeCells.push_back(cell);
+}
+
+CCPoint RenderAtlas::cellOrigin(size_t cell) const {
+    float strideX = m_cellSize.width + CELL_PADDING * 2.f;
+    float strideY = m_cellSize.height + CELL_PADDING * 2.f;
+
+    return CCPoint {
+        static_cast<float>(cell % m_columns) * strideX + CELL_PADDING,
+        static_cast<float>(cell / m_columns) * strideY + CELL_PADDING,
+    };
+}
+
+void RenderAtlas::render(size_t cell, CCNode* node) {
+    auto origin = this->cellOrigin(cell);
+
+    m_texture->begin();
+
+    m_clearLayer->setPosition(origin - CCPoint{CELL_PADDING, CELL_PADDING});
+    m_clearLayer->visit();
+
+    auto pos = node->getPosition();
+    node->setPosition(pos + origin);
+    node->visit();
+    node->setPosition(pos);
+
+    m_texture->end();
+}
+
+CCRect RenderAtlas::textureRect(size_t cell, const CCRect& rect) const {
+    // render textures are stored upside down, the first row of the texture is the bottom of the rendered image.
+    // sprites using this rect must be flipped vertically, which `createSprite` takes care of.
+    auto origin = this->cellOrigin(cell);
+    return CCRect{origin.x + rect.origin.x, origin.y + rect.origin.y, rect.size.width, rect.size.height};
+}
+
+CCRect RenderAtlas::textureRect(size_t cell) const {
+    return this->textureRect(cell, CCRect{CCPointZero, m_cellSize});
+}
+
+CCSprite* RenderAtlas::createSprite(size_t cell, const CCRect& rect) const {
+    auto spr = CCSprite::createWithTexture(this->getTexture(), this->textureRect(cell, rect));
+    spr->setFlipY(true);
+    // the rendered pixels have premultiplied alpha
+    spr->setOpacityModifyRGB(true);
+    return spr;
+}
+
+CCSprite* RenderAtlas::createSprite(size_t cell) const {
+    return this->createSprite(cell, CCRect{CCPointZero, m_cellSize});
+}
+
+void RenderAtlas::setSpriteCell(CCSprite* sprite, size_t cell, const CCRect& rect) const {
+    sprite->setTextureRect(this->textureRect(cell, rect));
+}
+
+void RenderAtlas::setupBatchNode(CCSpriteBatchNode* node) const {
+    node->setBlendFunc({GL_ONE, GL_ONE_MINUS_SRC_ALPHA});
+}
+
+}
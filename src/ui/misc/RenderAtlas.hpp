@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+namespace globed {
+
+/// A render texture split into a grid of equally sized cells. Nodes are rendered into a cell once,
+/// and afterwards can be displayed with sprites on the atlas texture, so that content coming from many different textures
+/// can be drawn by a single `CCSpriteBatchNode`.
+class RenderAtlas {
+public:
+    RenderAtlas(cocos2d::CCSize cellSize, size_t columns, size_t rows);
+
+    cocos2d::CCTexture2D* getTexture() const;
+    cocos2d::CCSize getCellSize() const;
+
+    /// Returns `std::nullopt` if every cell is taken
+    std::optional<size_t> allocCell();
+    void freeCell(size_t cell);
+
+    /// Clears the cell and renders `node` into it. The position of the node is relative to the bottom left corner of the cell.
+    void render(size_t cell, cocos2d::CCNode* node);
+
+    /// Texture rect of a part of the cell, `rect` is relative to the bottom left corner of the cell
+    cocos2d::CCRect textureRect(size_t cell, const cocos2d::CCRect& rect) const;
+    cocos2d::CCRect textureRect(size_t cell) const;
+
+    /// Creates a sprite displaying a part of the cell. It uses the atlas texture, so it can be added to a batch node created with `createBatchNode`.
+    cocos2d::CCSprite* createSprite(size_t cell, const cocos2d::CCRect& rect) const;
+    cocos2d::CCSprite* createSprite(size_t cell) const;
+    /// Updates a sprite created by `createSprite` to display a different cell
+    void setSpriteCell(cocos2d::CCSprite* sprite, size_t cell, const cocos2d::CCRect& rect) const;
+
+    /// Sets up the blending of a batch node that draws sprites from this atlas
+    void setupBatchNode(cocos2d::CCSpriteBatchNode* node) const;
+
+private:
+    geode::Ref<cocos2d::CCRenderTexture> m_texture;
+    geode::Ref<cocos2d::CCLayerColor> m_clearLayer;
+    cocos2d::CCSize m_cellSize;
+    size_t m_columns;
+    std::vector<size_t> m_freeCells;
+
+    cocos2d::CCPoint cellOrigin(size_t cell) const;
+};
+
+}
@@ -11,8 +11,12 @@
 #include "DiscordLinkPopup.hpp"
 #include "SaveSlotSwitcherPopup.hpp"
 #include <globed/core/PopupManager.hpp>
+#include <globed/audio/SfxCache.hpp>
 #include <core/net/NetworkManagerImpl.hpp>
 #include <ui/misc/InputPopup.hpp>
+#ifdef GLOBED_BENCHMARKS
+# include <util/Benchmarks.hpp>
+#endif
 
 #include <Geode/ui/GeodeUI.hpp>
 #include <UIBuilder.hpp>
@@ -283,6 +287,12 @@ void SettingsLayer::addSettings() {
         this->addSetting<BoolSettingCell>("core.dev.profile-frame-time", "Profile Frame Time",
             "Records how long specific processes take during frame update, e.g. interpolation, audio update, playerobject updates, etc."
         );
+        this->addSetting<BoolSettingCell>("core.dev.profiler", "Zone Profiler",
+            "Records timings of the game loop, networking, audio and preloading on all threads. Use the <cy>Export Profiler Trace</c> keybind to save them as a trace file, which can be opened in Perfetto."
+        );
+        this->addSetting<BoolSettingCell>("core.dev.binary-logs", "Binary Logs",
+            "Writes high frequency debug logs (interpolation, network events, latency) in a compact binary format to the <cy>binlogs</c> folder in the mod's save directory. Use <cy>binlog.py</c> from the repository to convert them to text."
+        );
         this->addSetting<BoolSettingCell>("core.dev.fake-data", "Use Dummy Data",
             "Uses randomly generated data in some places (room list, level list) for testing purposes"
         );
@@ -300,6 +310,48 @@ void SettingsLayer::addSettings() {
             "Clear", [] {
             argon::clearToken();
         }, CELL_SIZE));
+
+#ifdef GLOBED_BENCHMARKS
+        this->addSetting(ButtonSettingCell::create(
+            "Benchmarks",
+            "Runs one of the developer benchmarks (or all of them) and shows the report. The game will freeze while it runs.",
+            "Run", [] {
+            std::string ids;
+            for (auto& bench : allBenchmarks()) {
+                ids += fmt::format("{}, ", bench.id);
+            }
+            ids += "all";
+
+            auto popup = InputPopup::create("chatFont.fnt");
+            popup->setMaxCharCount(32);
+            popup->setWidth(280.f);
+            popup->setTitle("Run Benchmark");
+            popup->setPlaceholder("Benchmark ID");
+            popup->setDefaultText("all");
+            popup->setCallback([ids = std::move(ids)](auto outcome) {
+                if (outcome.cancelled) return;
+
+                if (auto report = runBenchmarks(outcome.text)) {
+                    globed::alert("Benchmarks", *report);
+                } else {
+                    globed::alert("Benchmarks", fmt::format("Unknown benchmark, available: {}", ids));
+                }
+            });
+            popup->show();
+        }, CELL_SIZE));
+#endif
+
+        this->addSetting(ButtonSettingCell::create(
+            "SFX Cache Stats",
+            "Shows how often emote sound effects were played from memory instead of being loaded from disk.",
+            "Show", [] {
+            auto stats = SfxCache::get().stats();
+            globed::alert("SFX Cache Stats", fmt::format(
+                "Hit rate: {:.1f}% ({} hits, {} misses)\nCached: {} sounds, {:.2f} MiB\nEvictions: {}",
+                stats.hitRate() * 100.f, stats.hits, stats.misses,
+                stats.entries, stats.memoryUsage / 1024.0 / 1024.0, stats.evictions
+            ));
+        }, CELL_SIZE));
     }
 
     // Player settings
@@ -352,6 +404,12 @@ void SettingsLayer::addSettings() {
     this->addSetting<BoolSettingCell>("core.player.default-death-effects", "Default Death Effects",
         "Replaces all player death effects with the default explosion effect."
     );
+    this->addSetting<BoolSettingCell>("core.player.lod", "Level of Detail",
+        "Reduces the detail of far away players when there are a lot of people on screen. <cy>Improves performance</c> in big rooms."
+    );
+    this->addSetting<IntSliderSettingCell>("core.player.lod-budget", "Detailed Player Limit",
+        "How many players on screen can be rendered in full detail before <cy>Level of Detail</c> kicks in. Players further away lose trails and animations, and in big crowds become simple dots."
+    );
     this->addSetting<BoolSettingCell>("core.level.self-status-icons", "Show Own Status Icons",
         "Show your own status icons. (paused, speaking, etc.)"
     );
@@ -455,6 +513,28 @@ void SettingsLayer::addSettings() {
     this->addSetting<IntSliderSettingCell>("core.audio.buffer-size", "Audio Buffer Size",
         "Adjusts the audio buffer size (in 60ms frames). Lower sizes reduce audio latency but may decrease stability."
     );
+    this->addSetting<EnumSettingCell>("core.audio.frame-duration", "Voice Frame Length",
+        "Length of each recorded voice frame. Anything shorter than <cy>60ms</c> enables <cg>low latency mode</c>, where every frame is sent immediately and the <cy>Audio Buffer Size</c> is ignored. "
+        "Shorter frames noticeably reduce voice delay, but use <cr>more bandwidth</c> (more packets) and slightly more CPU. Other players can hear you with any setting.",
+        std::vector<std::pair<ZStringView, int>>{
+        {"60ms", 60},
+        {"40ms", 40},
+        {"20ms", 20},
+        {"10ms", 10},
+    });
+    this->addSetting<BoolSettingCell>("core.audio.voice-activation", "Voice Activation",
+        "While your voice chat key is held, only send audio when you are actually <cg>speaking</c>. Silence and steady background noise are not sent, which saves bandwidth."
+    );
+    this->addSetting<IntSliderSettingCell>("core.audio.vad-attack", "Voice Activation Attack",
+        "How long (in ms) you have to be speaking before <cy>Voice Activation</c> starts sending. Higher values ignore more short noises like clicks."
+    );
+    this->addSetting<IntSliderSettingCell>("core.audio.vad-hangover", "Voice Activation Hangover",
+        "How long (in ms) <cy>Voice Activation</c> keeps sending after you stop speaking. Lower values may cut off the ends of words."
+    );
+    this->addSetting<BoolSettingCell>("core.audio.voice-mixer", "Mix Voices",
+        "Plays all voices through a <cg>single audio stream</c> instead of one per player, and positions them left or right in proximity chat. "
+        "Recommended in levels with <cy>many players</c> talking. Takes effect for players who start talking after changing it."
+    );
 
     // Menus
     this->addHeader("core.ui", "Menus", m_menusTab);
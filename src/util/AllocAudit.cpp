@@ -0,0 +1,201 @@
+#ifdef GLOBED_ALLOC_AUDIT
+
+#include "AllocAudit.hpp"
+
+#include <Geode/loader/Log.hpp>
+#include <asp/time/Instant.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <optional>
+
+#ifndef GLOBED_ALLOC_AUDIT_THRESHOLD
+# define GLOBED_ALLOC_AUDIT_THRESHOLD 0
+#endif
+
+using namespace geode::prelude;
+using namespace asp::time;
+
+// amount of frames after a workload change that are not checked, to let pools and caches fill up
+constexpr size_t WARMUP_FRAMES = 180;
+constexpr auto REPORT_INTERVAL = Duration::fromSecs(5);
+
+namespace globed {
+
+// all of this is plain data, so that it can be used from inside of operator new without any initialization
+struct ThreadAuditState {
+    const char* scope = nullptr;
+    AllocAudit::Counter counters[AllocAudit::MAX_SCOPES];
+    size_t counterCount = 0;
+    AllocAudit::Counter lastFrame[AllocAudit::MAX_SCOPES];
+    size_t lastFrameCount = 0;
+    size_t workloadKey = 0;
+    size_t warmup = WARMUP_FRAMES;
+    bool inAudit = false;
+};
+
+static thread_local ThreadAuditState t_state;
+
+const char* AllocAudit::enterScope(const char* name) {
+    auto prev = t_state.scope;
+    t_state.scope = name;
+    return prev;
+}
+
+void AllocAudit::exitScope(const char* prev) {
+    t_state.scope = prev;
+}
+
+void AllocAudit::recordAllocation(size_t bytes) {
+    auto& st = t_state;
+    if (!st.scope || st.inAudit) return;
+
+    for (size_t i = 0; i < st.counterCount; i++) {
+        auto& c = st.counters[i];
+        if (c.name == st.scope) {
+            c.count++;
+            c.bytes += bytes;
+            return;
+        }
+    }
+
+    // too many different scopes, lump the rest together into the last one
+    size_t idx = st.counterCount < MAX_SCOPES ? st.counterCount++ : MAX_SCOPES - 1;
+    auto& c = st.counters[idx];
+    c.name = idx == MAX_SCOPES - 1 ? "Other" : st.scope;
+    c.count++;
+    c.bytes += bytes;
+}
+
+std::span<const AllocAudit::Counter> AllocAudit::endFrame(size_t workloadKey) {
+    auto& st = t_state;
+
+    std::copy_n(st.counters, st.counterCount, st.lastFrame);
+    st.lastFrameCount = st.counterCount;
+    st.counterCount = 0;
+
+    std::sort(st.lastFrame, st.lastFrame + st.lastFrameCount, [](auto& a, auto& b) {
+        return a.count > b.count;
+    });
+
+    std::span<const Counter> frame{st.lastFrame, st.lastFrameCount};
+
+    if (workloadKey != st.workloadKey) {
+        st.workloadKey = workloadKey;
+        st.warmup = WARMUP_FRAMES;
+    }
+
+    if (st.warmup > 0) {
+        st.warmup--;
+        return frame;
+    }
+
+    auto totals = lastFrameTotals();
+    if (totals.count <= GLOBED_ALLOC_AUDIT_THRESHOLD) {
+        return frame;
+    }
+
+    static thread_local std::optional<Instant> lastReport;
+    if (lastReport && lastReport->elapsed() < REPORT_INTERVAL) {
+        return frame;
+    }
+
+    // the report itself allocates, make sure it does not count towards the next frame
+    st.inAudit = true;
+    lastReport = Instant::now();
+
+    log::warn(
+        "Alloc audit: steady state frame made {} allocations ({} bytes), threshold is {}",
+        totals.count, totals.bytes, GLOBED_ALLOC_AUDIT_THRESHOLD
+    );
+
+    for (auto& c : frame) {
+        log::warn("- {}: {} allocations, {} bytes", c.name, c.count, c.bytes);
+    }
+
+    st.inAudit = false;
+
+    return frame;
+}
+
+AllocAudit::Totals AllocAudit::lastFrameTotals() {
+    Totals totals;
+
+    for (size_t i = 0; i < t_state.lastFrameCount; i++) {
+        totals.count += t_state.lastFrame[i].count;
+        totals.bytes += t_state.lastFrame[i].bytes;
+    }
+
+    return totals;
+}
+
+}
+
+// Replaced allocation functions
+
+static void* auditAlloc(size_t size) {
+    globed::AllocAudit::recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+static void* auditAllocAligned(size_t size, std::align_val_t align) {
+    globed::AllocAudit::recordAllocation(size);
+    size = size ? size : 1;
+
+#ifdef _WIN32
+    return _aligned_malloc(size, static_cast<size_t>(align));
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, std::max(static_cast<size_t>(align), sizeof(void*)), size) != 0) {
+        return nullptr;
+    }
+    return ptr;
+#endif
+}
+
+static void auditFreeAligned(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void* operator new(size_t size) {
+    if (auto p = auditAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (auto p = auditAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return auditAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return auditAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    if (auto p = auditAllocAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+    if (auto p = auditAllocAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { auditFreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { auditFreeAligned(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { auditFreeAligned(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { auditFreeAligned(ptr); }
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#ifdef GLOBED_ALLOC_AUDIT
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace globed {
+
+/// Counts heap allocations of the current thread, attributed to the innermost `ProfilerZone`.
+/// Only exists in builds with `alloc_audit` enabled, where the global allocation functions are replaced.
+/// Allocations made outside of any zone are not counted.
+class AllocAudit {
+public:
+    struct Counter {
+        const char* name = nullptr;
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    struct Totals {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    static constexpr size_t MAX_SCOPES = 64;
+
+    /// Sets the scope that new allocations on this thread are attributed to, returns the previous scope
+    static const char* enterScope(const char* name);
+    static void exitScope(const char* prev);
+
+    /// Called by the replaced allocation functions
+    static void recordAllocation(size_t bytes);
+
+    /// Finishes a frame of the calling thread and resets the counters. Returns the counters of the finished frame.
+    /// `workloadKey` should change whenever the workload changes (e.g. the amount of players),
+    /// frames right after a change are not checked against the threshold.
+    static std::span<const Counter> endFrame(size_t workloadKey);
+
+    /// Totals of the last frame finished on the calling thread
+    static Totals lastFrameTotals();
+};
+
+}
+
+#endif
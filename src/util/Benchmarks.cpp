@@ -0,0 +1,1372 @@
+#ifdef GLOBED_BENCHMARKS
+
+#include "Benchmarks.hpp"
+#include "AllocAudit.hpp"
+#include <globed/util/FlatIntMap.hpp>
+#include <globed/audio/AudioRingBuffer.hpp>
+#include <globed/audio/VoiceActivityDetector.hpp>
+#include <globed/audio/VoiceMixer.hpp>
+#include <globed/audio/VolumeEstimator.hpp>
+#include <globed/audio/AudioSampleQueue.hpp>
+#include <globed/audio/AudioDecoder.hpp>
+#include <globed/audio/EncodedAudioFrame.hpp>
+#include <globed/audio/AudioManager.hpp>
+#include <globed/audio/sound/VoiceStream.hpp>
+#include <globed/core/game/PlayerStatusIcons.hpp>
+#include <globed/core/game/ProgressIcon.hpp>
+#include <core/game/Interpolator.hpp>
+#include <core/game/ProgressIconBatch.hpp>
+#include <core/game/StatusIconBatch.hpp>
+#include <ui/misc/NameLabel.hpp>
+
+#include <Geode/loader/Loader.hpp>
+#include <Geode/loader/Mod.hpp>
+#include <Geode/loader/ModEvent.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/general.hpp>
+#include <asp/time/Instant.hpp>
+#include <qunet/util/algo.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+using namespace asp::time;
+
+namespace globed {
+
+namespace {
+struct BenchResult {
+    double lookupNs;
+    double iterateNs;
+};
+}
+
+template <typename Map>
+static BenchResult benchMap(const std::vector<int>& keys, const std::vector<int>& lookupOrder, size_t rounds) {
+    Map map;
+    for (int key : keys) {
+        map.emplace(key, std::make_shared<int>(key));
+    }
+
+    // the sink keeps the compiler from optimizing the loops away
+    volatile int64_t sink = 0;
+    int64_t sum = 0;
+
+    auto start = Instant::now();
+    for (size_t r = 0; r < rounds; r++) {
+        for (int key : lookupOrder) {
+            auto it = map.find(key);
+            if (it != map.end()) sum += *it->second;
+        }
+    }
+    auto lookupTime = start.elapsed();
+    sink = sink + sum;
+
+    sum = 0;
+    start = Instant::now();
+    for (size_t r = 0; r < rounds; r++) {
+        for (auto& [key, value] : map) {
+            sum += key + *value;
+        }
+    }
+    auto iterateTime = start.elapsed();
+    sink = sink + sum;
+
+    double ops = static_cast<double>(rounds * keys.size());
+    return BenchResult {
+        .lookupNs = static_cast<double>(lookupTime.nanos()) / ops,
+        .iterateNs = static_cast<double>(iterateTime.nanos()) / ops,
+    };
+}
+
+std::string benchmarkFlatIntMap() {
+    constexpr size_t ENTRIES = 500;
+    constexpr size_t ROUNDS = 2000;
+
+    // account IDs are spread over a large range, like real ones
+    std::mt19937 rng{1337};
+    std::uniform_int_distribution<int> dist{1, 30'000'000};
+
+    std::vector<int> keys;
+    while (keys.size() < ENTRIES) {
+        int key = dist(rng);
+        if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+            keys.push_back(key);
+        }
+    }
+
+    auto lookupOrder = keys;
+    std::shuffle(lookupOrder.begin(), lookupOrder.end(), rng);
+
+    using Value = std::shared_ptr<int>;
+    auto stdRes = benchMap<std::unordered_map<int, Value>>(keys, lookupOrder, ROUNDS);
+    auto flatRes = benchMap<FlatIntMap<Value>>(keys, lookupOrder, ROUNDS);
+
+    return fmt::format(
+        "{} entries, {} rounds\n"
+        "std::unordered_map: lookup {:.2f}ns, iterate {:.2f}ns per entry\n"
+        "FlatIntMap: lookup {:.2f}ns, iterate {:.2f}ns per entry",
+        ENTRIES, ROUNDS,
+        stdRes.lookupNs, stdRes.iterateNs,
+        flatRes.lookupNs, flatRes.iterateNs
+    );
+}
+
+namespace {
+struct SessionResult {
+    double meanJitter = 0.0;
+    double maxJitter = 0.0;
+    size_t ticks = 0;
+    size_t stalls = 0;
+    size_t resets = 0;
+};
+}
+
+// Simulates a minute of a remote player moving at a constant speed, starting `startSecs` into their session.
+// With `floatSender`, the sender accumulates its timestamps in float seconds like clients did before integer timestamps.
+static SessionResult simulateSession(double startSecs, bool floatSender) {
+    constexpr int PLAYER_ID = 1;
+    constexpr double SPEED = 311.58; // normal speed, units per second
+    constexpr double SEGMENT = 20.0; // the player goes back to the start every 20 seconds, so that positions stay small
+    constexpr double SENDER_DT = 1.0 / 240.0;
+    constexpr double SEND_INTERVAL = 1.0 / 30.0;
+    constexpr double RECEIVER_DT = 1.0 / 60.0;
+    constexpr double WARMUP = 2.0;
+    constexpr double DURATION = 60.0;
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<double> latency{0.04, 0.06};
+    std::uniform_real_distribution<double> frameJitter{0.9, 1.1};
+
+    struct Packet {
+        double arrival;
+        PlayerState state;
+    };
+    std::deque<Packet> inFlight;
+
+    Interpolator interp;
+    interp.addPlayer(PLAYER_ID);
+
+    PlayerTimestamp senderCounter = timestampFromSecs(startSecs);
+    float senderFloat = static_cast<float>(startSecs);
+    PlayerTimestamp receiverCounter = 0;
+
+    double now = 0.0;
+    double nextSend = 0.0;
+    double nextReceive = 0.0;
+    double lastArrival = 0.0;
+
+    std::optional<float> lastX;
+    SessionResult res;
+
+    while (now < DURATION) {
+        double dt = SENDER_DT * frameJitter(rng);
+        now += dt;
+        senderCounter += timestampFromSecs(dt);
+        senderFloat += static_cast<float>(dt);
+
+        if (now >= nextSend) {
+            nextSend += SEND_INTERVAL;
+
+            PlayerObjectData data{};
+            data.position = {static_cast<float>(SPEED * std::fmod(startSecs + now, SEGMENT)), 105.f};
+            data.iconType = PlayerIconType::Cube;
+            data.isVisible = true;
+
+            PlayerState state{};
+            state.accountId = PLAYER_ID;
+            state.timestamp = floatSender ? senderFloat : timestampToWire(senderCounter);
+            state.player1 = data;
+
+            // packets arrive in order, with some jitter
+            lastArrival = std::max(lastArrival, now + latency(rng));
+            inFlight.push_back({lastArrival, std::move(state)});
+        }
+
+        while (now >= nextReceive) {
+            double rdt = RECEIVER_DT * frameJitter(rng);
+            nextReceive += rdt;
+            receiverCounter += timestampFromSecs(rdt);
+
+            while (!inFlight.empty() && inFlight.front().arrival <= now) {
+                interp.updatePlayer(inFlight.front().state, receiverCounter);
+                inFlight.pop_front();
+            }
+
+            interp.tick(timestampFromSecs(rdt), cocos2d::CCPoint{}, cocos2d::CCPoint{});
+
+            auto& out = interp.peekPlayerState(PLAYER_ID);
+            if (!out.player1) {
+                if (lastX) res.resets++;
+                lastX.reset();
+                continue;
+            }
+
+            float x = out.player1->position.x;
+            float delta = lastX ? x - *lastX : 0.f;
+            bool wrapped = delta < -1000.f;
+            bool measure = lastX && !wrapped && now > WARMUP;
+            lastX = x;
+
+            if (!measure) continue;
+
+            double jitter = std::abs(delta - SPEED * rdt);
+            res.meanJitter += jitter;
+            res.maxJitter = std::max(res.maxJitter, jitter);
+            res.ticks++;
+            if (delta == 0.f) res.stalls++;
+        }
+    }
+
+    if (res.ticks) res.meanJitter /= res.ticks;
+    return res;
+}
+
+std::string simulateLongSessions() {
+    constexpr double HOUR = 3600.0;
+
+    std::string out = "A remote player moving at constant speed, sending 30 times per second, received at 60fps.\n"
+        "Jitter is how far the rendered movement per frame deviates from the real one, in units. "
+        "Stalls are frames where the player did not move.\n";
+
+    for (double hours : {0.0, 1.0, 6.0, 24.0, 72.0}) {
+        auto exact = simulateSession(hours * HOUR, false);
+        auto accumulated = simulateSession(hours * HOUR, true);
+
+        out += fmt::format(
+            "\n{}h into the session:\n"
+            "integer timestamps: jitter {:.3f} avg / {:.2f} max, {} stalls, {} resets ({} frames)\n"
+            "float timestamps: jitter {:.3f} avg / {:.2f} max, {} stalls, {} resets ({} frames)\n",
+            hours,
+            exact.meanJitter, exact.maxJitter, exact.stalls, exact.resets, exact.ticks,
+            accumulated.meanJitter, accumulated.maxJitter, accumulated.stalls, accumulated.resets, accumulated.ticks
+        );
+    }
+
+    return out;
+}
+
+std::string stressTestAudioRing() {
+    static constexpr size_t STREAMS = 32;
+    static constexpr size_t SAMPLES_PER_STREAM = 24000 * 60; // a minute of voice audio
+    static constexpr size_t WRITE_CHUNK = 480; // one decoded 20ms opus frame
+    static constexpr size_t READ_CHUNK = 1024; // typical fmod pcm read callback
+
+    struct Stream {
+        AudioRingBuffer ring{8192};
+        size_t glitches = 0;
+        size_t underruns = 0;
+    };
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (size_t i = 0; i < STREAMS; i++) {
+        streams.push_back(std::make_unique<Stream>());
+    }
+
+    // samples are consecutive integers (exactly representable as floats), so any lost, repeated or reordered sample is detected
+    auto sampleAt = [](size_t i) { return static_cast<float>(i % (1 << 24)); };
+
+    auto start = Instant::now();
+    std::vector<std::thread> threads;
+
+    for (auto& stream : streams) {
+        threads.emplace_back([&ring = stream->ring, &sampleAt] {
+            float buf[WRITE_CHUNK];
+            size_t written = 0;
+
+            while (written < SAMPLES_PER_STREAM) {
+                size_t count = std::min(WRITE_CHUNK, SAMPLES_PER_STREAM - written);
+                for (size_t i = 0; i < count; i++) {
+                    buf[i] = sampleAt(written + i);
+                }
+
+                size_t done = 0;
+                while (done < count) {
+                    done += ring.write(buf + done, count - done);
+                    if (done < count) std::this_thread::yield();
+                }
+
+                written += count;
+            }
+        });
+
+        threads.emplace_back([s = stream.get(), &sampleAt] {
+            float buf[READ_CHUNK];
+            size_t read = 0;
+
+            while (read < SAMPLES_PER_STREAM) {
+                size_t count = s->ring.read(buf, READ_CHUNK);
+                if (count == 0) {
+                    s->underruns++;
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                for (size_t i = 0; i < count; i++) {
+                    if (buf[i] != sampleAt(read + i)) s->glitches++;
+                }
+
+                read += count;
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto taken = start.elapsed();
+
+    size_t glitches = 0, underruns = 0;
+    for (auto& stream : streams) {
+        glitches += stream->glitches;
+        underruns += stream->underruns;
+    }
+
+    return fmt::format(
+        "{} streams, {} samples each, took {}ms\n"
+        "Glitched samples: {}\n"
+        "Empty reads: {}",
+        STREAMS, SAMPLES_PER_STREAM, taken.millis(),
+        glitches, underruns
+    );
+}
+
+namespace {
+struct VadScenario {
+    const char* name;
+    float noiseDb;   // white noise level in dBFS
+    float humDb;     // 50Hz mains hum level in dBFS, or 0 for none
+    bool clicks;     // keyboard clicks during silence
+};
+
+struct VadRates {
+    size_t speechBlocks = 0, silentBlocks = 0;
+    size_t missed = 0, falseAlarms = 0;
+};
+}
+
+static float dbToAmp(float db) {
+    return std::pow(10.f, db / 20.f);
+}
+
+// Generates a minute of alternating silence and speech-like audio at 24kHz, with a label for each 10ms block.
+// Speech is made of syllables with a voiced part (harmonics of a varying pitch, shaped by three formants) and sometimes a fricative before it.
+static void generateVadSignal(const VadScenario& sc, std::mt19937& rng, std::vector<float>& pcm, std::vector<bool>& labels) {
+    constexpr int RATE = 24000;
+    constexpr size_t BLOCK = RATE * VoiceActivityDetector::BLOCK_MS / 1000;
+    constexpr size_t TOTAL = RATE * 60;
+    constexpr float TAU = 2.f * std::numbers::pi_v<float>;
+
+    std::uniform_real_distribution<float> uni{0.f, 1.f};
+    std::normal_distribution<float> gauss{0.f, 1.f};
+    auto range = [&](float lo, float hi) { return lo + (hi - lo) * uni(rng); };
+
+    pcm.assign(TOTAL, 0.f);
+    std::vector<bool> speechSample(TOTAL, false);
+
+    size_t pos = RATE; // start with a second of silence, so the noise floor can settle
+    while (pos < TOTAL) {
+        size_t segEnd = std::min(TOTAL, pos + static_cast<size_t>(range(0.5f, 3.f) * RATE));
+        size_t p = pos;
+
+        while (p < segEnd) {
+            size_t sylLen = std::min(segEnd - p, static_cast<size_t>(range(0.12f, 0.3f) * RATE));
+            float f0 = range(100.f, 220.f);
+            float f1 = range(400.f, 800.f), f2 = range(1000.f, 2200.f), f3 = range(2400.f, 3000.f);
+            float level = dbToAmp(range(-32.f, -20.f));
+            bool fricative = uni(rng) < 0.3f;
+            size_t fricLen = fricative ? std::min(sylLen / 3, static_cast<size_t>(0.05f * RATE)) : 0;
+
+            float phase = 0.f, prevNoise = 0.f;
+            for (size_t i = 0; i < sylLen; i++) {
+                float t = static_cast<float>(i) / sylLen;
+                float sample = 0.f;
+
+                if (i < fricLen) {
+                    // differentiated noise is mostly high frequency, like "s"
+                    float n = gauss(rng);
+                    sample = (n - prevNoise) * level * 0.5f;
+                    prevNoise = n;
+                } else {
+                    float env = std::sin(std::numbers::pi_v<float> * t);
+                    float pitch = f0 * (1.f + 0.05f * std::sin(TAU * 5.f * i / RATE));
+                    phase += TAU * pitch / RATE;
+
+                    for (int k = 1; k * pitch < 4000.f; k++) {
+                        float f = k * pitch;
+                        auto peak = [&](float fc, float bw) { return 1.f / (1.f + ((f - fc) / bw) * ((f - fc) / bw)); };
+                        float amp = peak(f1, 100.f) + 0.5f * peak(f2, 150.f) + 0.25f * peak(f3, 200.f);
+                        sample += amp * std::sin(phase * k);
+                    }
+
+                    sample *= env * level * 0.5f;
+                }
+
+                pcm[p + i] = sample;
+                speechSample[p + i] = true;
+            }
+
+            p += sylLen;
+
+            // short pauses between syllables still count as speech
+            size_t gap = static_cast<size_t>(range(0.02f, 0.12f) * RATE);
+            for (size_t i = 0; i < gap && p < segEnd; i++, p++) {
+                speechSample[p] = true;
+            }
+        }
+
+        pos = segEnd + static_cast<size_t>(range(0.3f, 2.f) * RATE);
+    }
+
+    float noise = dbToAmp(sc.noiseDb);
+    float hum = sc.humDb != 0.f ? dbToAmp(sc.humDb) : 0.f;
+
+    for (size_t i = 0; i < TOTAL; i++) {
+        pcm[i] += gauss(rng) * noise + hum * std::sin(TAU * 50.f * i / RATE);
+
+        // a short broadband click every ~300ms of silence
+        if (sc.clicks && !speechSample[i] && uni(rng) < 1.f / (0.3f * RATE)) {
+            for (size_t j = 0; j < 120 && i + j < TOTAL; j++) {
+                pcm[i + j] += gauss(rng) * dbToAmp(-30.f) * (1.f - j / 120.f);
+            }
+        }
+    }
+
+    // a block is speech if most of it is
+    labels.clear();
+    for (size_t b = 0; b + BLOCK <= TOTAL; b += BLOCK) {
+        size_t count = std::count(speechSample.begin() + b, speechSample.begin() + b + BLOCK, true);
+        labels.push_back(count * 2 > BLOCK);
+    }
+}
+
+static VadRates runVad(const std::vector<float>& pcm, const std::vector<bool>& labels, int attackMs, int hangoverMs) {
+    constexpr size_t BLOCK = 24000 * VoiceActivityDetector::BLOCK_MS / 1000;
+
+    VoiceActivityDetector vad{24000, attackMs, hangoverMs};
+    VadRates rates;
+
+    for (size_t b = 0; b < labels.size(); b++) {
+        bool active = vad.process(pcm.data() + b * BLOCK, BLOCK);
+
+        if (labels[b]) {
+            rates.speechBlocks++;
+            if (!active) rates.missed++;
+        } else {
+            rates.silentBlocks++;
+            if (active) rates.falseAlarms++;
+        }
+    }
+
+    return rates;
+}
+
+std::string testVoiceActivityDetector() {
+    const VadScenario scenarios[] = {
+        {"Quiet room", -70.f, 0.f, false},
+        {"Fan noise", -45.f, 0.f, false},
+        {"Loud fan", -35.f, 0.f, false},
+        {"Mains hum", -60.f, -30.f, false},
+        {"Keyboard", -60.f, 0.f, true},
+    };
+
+    std::mt19937 rng{1337};
+    std::vector<float> pcm;
+    std::vector<bool> labels;
+
+    auto percent = [](size_t part, size_t whole) { return whole ? part * 100.0 / whole : 0.0; };
+
+    std::string out = "Rates per 10ms block, detector alone / with 20ms attack + 300ms hangover (the hangover after speech counts as false positives)\n";
+
+    for (auto& sc : scenarios) {
+        generateVadSignal(sc, rng, pcm, labels);
+
+        auto raw = runVad(pcm, labels, 0, 0);
+        auto timed = runVad(pcm, labels, 20, 300);
+
+        out += fmt::format(
+            "\n{}: false positive {:.1f}% / {:.1f}%, false negative {:.1f}% / {:.1f}%, sent {:.0f}% of audio",
+            sc.name,
+            percent(raw.falseAlarms, raw.silentBlocks), percent(timed.falseAlarms, timed.silentBlocks),
+            percent(raw.missed, raw.speechBlocks), percent(timed.missed, timed.speechBlocks),
+            percent(timed.speechBlocks - timed.missed + timed.falseAlarms, labels.size())
+        );
+    }
+
+    return out;
+}
+
+namespace {
+struct VoiceMixBench {
+    double cpuPercent; // time spent in fmod updates compared to the duration of the audio they mixed
+    int channels;
+    int realChannels;
+};
+}
+
+// fmod system without a sound device, every update() call decodes streams and mixes one block right away on the calling thread
+static Result<FMOD::System*> createHeadlessSystem() {
+    auto& am = AudioManager::get();
+
+    FMOD::System* system = nullptr;
+    GEODE_UNWRAP(am.mapError(FMOD::System_Create(&system)));
+
+    auto res = [&]() -> Result<> {
+        GEODE_UNWRAP(am.mapError(system->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT)));
+        GEODE_UNWRAP(am.mapError(system->init(512, FMOD_INIT_STREAM_FROM_UPDATE | FMOD_INIT_MIX_FROM_UPDATE, nullptr)));
+        return Ok();
+    }();
+
+    if (!res) {
+        system->release();
+        return Err(res.unwrapErr());
+    }
+
+    return Ok(system);
+}
+
+static Result<VoiceMixBench> benchVoicePlayback(FMOD::System* system, size_t speakers, bool useMixer) {
+    static constexpr size_t WARMUP_UPDATES = 20;
+    static constexpr size_t UPDATES = 300;
+    static constexpr size_t QUEUED_SAMPLES = VOICE_TARGET_SAMPLERATE / 4;
+
+    auto& am = AudioManager::get();
+
+    // a second of vowel-like audio (150Hz with harmonics, wobbling in loudness), every speaker plays it from a different offset
+    std::vector<float> voice(VOICE_TARGET_SAMPLERATE);
+    for (size_t i = 0; i < voice.size(); i++) {
+        float t = static_cast<float>(i) / VOICE_TARGET_SAMPLERATE;
+        float env = 0.5f + 0.5f * std::sin(2.f * std::numbers::pi_v<float> * 3.f * t);
+        float s = 0.f;
+        for (int h = 1; h <= 8; h++) {
+            s += std::sin(2.f * std::numbers::pi_v<float> * 150.f * h * t) / h;
+        }
+        voice[i] = s * env * 0.2f;
+    }
+
+    std::mt19937 rng{1337};
+    std::uniform_real_distribution<float> unit{0.f, 1.f};
+
+    std::vector<std::shared_ptr<VoiceStream>> streams;
+    std::vector<size_t> offsets;
+    for (size_t i = 0; i < speakers; i++) {
+        auto stream = std::make_shared<VoiceStream>(nullptr, std::weak_ptr<RemotePlayer>{});
+
+        // like a proximity level, about a third of the players are out of range
+        float gain = unit(rng) < 0.3f ? 0.f : 0.2f + unit(rng) * 0.8f;
+        stream->rawSetVolume(gain);
+        stream->rawSetPan(unit(rng) * 1.4f - 0.7f);
+
+        streams.push_back(std::move(stream));
+        offsets.push_back(rng() % voice.size());
+    }
+
+    std::vector<FMOD::Sound*> sounds;
+    std::unique_ptr<VoiceMixer> mixer;
+
+    auto cleanup = [&] {
+        mixer.reset();
+        for (auto sound : sounds) {
+            sound->release();
+        }
+    };
+
+    auto res = [&]() -> Result<VoiceMixBench> {
+        if (useMixer) {
+            mixer = std::make_unique<VoiceMixer>(system);
+            for (auto& stream : streams) {
+                GEODE_UNWRAP(mixer->addSource(stream.get()));
+            }
+        } else {
+            // same stream setup as `VoiceStream::create`, but on the headless system
+            for (auto& stream : streams) {
+                FMOD_CREATESOUNDEXINFO exinfo = {};
+                exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+                exinfo.numchannels = 1;
+                exinfo.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+                exinfo.defaultfrequency = VOICE_TARGET_SAMPLERATE;
+                exinfo.decodebuffersize = exinfo.numchannels * exinfo.defaultfrequency * AUDIO_PLAYBACK_DELAY;
+                exinfo.userdata = stream.get();
+                exinfo.length = sizeof(float) * exinfo.numchannels * exinfo.defaultfrequency * 0.03f;
+                exinfo.pcmreadcallback = [](FMOD_SOUND* sound_, void* data, unsigned int len) -> FMOD_RESULT {
+                    VoiceStream* stream = nullptr;
+                    reinterpret_cast<FMOD::Sound*>(sound_)->getUserData((void**)&stream);
+                    stream->readCallback(reinterpret_cast<float*>(data), len / sizeof(float));
+                    return FMOD_OK;
+                };
+
+                FMOD::Sound* sound = nullptr;
+                GEODE_UNWRAP(am.mapError(
+                    system->createStream(nullptr, FMOD_OPENUSER | FMOD_2D | FMOD_LOOP_NORMAL, &exinfo, &sound)
+                ));
+                sounds.push_back(sound);
+
+                FMOD::Channel* channel = nullptr;
+                GEODE_UNWRAP(am.mapError(system->playSound(sound, nullptr, false, &channel)));
+                channel->setVolume(stream->mixGain());
+            }
+        }
+
+        // keep every queue topped up like the decode workers would, this isn't part of the measured time
+        auto feed = [&] {
+            for (size_t i = 0; i < streams.size(); i++) {
+                size_t queued = streams[i]->queuedSamples();
+                if (queued >= QUEUED_SAMPLES) continue;
+
+                size_t want = QUEUED_SAMPLES - queued;
+                while (want > 0) {
+                    size_t count = std::min(want, voice.size() - offsets[i]);
+                    streams[i]->writeData(voice.data() + offsets[i], count);
+                    offsets[i] = (offsets[i] + count) % voice.size();
+                    want -= count;
+                }
+            }
+        };
+
+        for (size_t i = 0; i < WARMUP_UPDATES; i++) {
+            feed();
+            system->update();
+        }
+
+        uint64_t takenNanos = 0;
+        for (size_t i = 0; i < UPDATES; i++) {
+            feed();
+            auto start = Instant::now();
+            system->update();
+            takenNanos += start.elapsed().nanos();
+        }
+
+        unsigned int blockLength = 0;
+        int numBlocks = 0, sampleRate = 0;
+        system->getDSPBufferSize(&blockLength, &numBlocks);
+        system->getSoftwareFormat(&sampleRate, nullptr, nullptr);
+
+        VoiceMixBench out{};
+        system->getChannelsPlaying(&out.channels, &out.realChannels);
+
+        double audioSecs = static_cast<double>(UPDATES) * blockLength / std::max(sampleRate, 1);
+        out.cpuPercent = takenNanos / 1e9 / audioSecs * 100.0;
+
+        return Ok(out);
+    }();
+
+    cleanup();
+    return res;
+}
+
+std::string benchmarkVoiceMixer() {
+    const size_t speakerCounts[] = {10, 50, 100};
+
+    auto systemRes = createHeadlessSystem();
+    if (!systemRes) {
+        return fmt::format("Failed to create a headless FMOD system: {}", systemRes.unwrapErr());
+    }
+    auto system = *systemRes;
+
+    std::string out = "CPU is time spent by FMOD (decoding and mixing) relative to the audio length, channels are playing (real) ones.\n"
+        "About 30% of the speakers are out of proximity range.\n";
+
+    for (size_t speakers : speakerCounts) {
+        auto separate = benchVoicePlayback(system, speakers, false);
+        auto mixed = benchVoicePlayback(system, speakers, true);
+
+        if (!separate || !mixed) {
+            out += fmt::format("\n{} speakers: failed: {}", speakers, separate ? mixed.unwrapErr() : separate.unwrapErr());
+            continue;
+        }
+
+        out += fmt::format(
+            "\n{} speakers: separate streams {:.2f}% CPU, {} ({}) channels / mixer {:.2f}% CPU, {} ({}) channels",
+            speakers,
+            separate->cpuPercent, separate->channels, separate->realChannels,
+            mixed->cpuPercent, mixed->channels, mixed->realChannels
+        );
+    }
+
+    system->release();
+
+    return out;
+}
+
+namespace {
+// the previous VolumeEstimator, which kept copies of the samples, used as the reference
+struct ReferenceVolumeEstimator {
+    size_t sampleRate;
+    AudioSampleQueue queue;
+    std::deque<std::pair<Instant, size_t>> history;
+    std::vector<float> buf;
+    float emaVolume = 0.f;
+    float volume = 0.f;
+
+    void feedData(const float* pcm, size_t samples, Instant now) {
+        if (samples == 0) return;
+
+        queue.writeData(pcm, samples);
+        history.emplace_back(now, samples);
+
+        if (queue.size() > sampleRate * 1.2f) {
+            queue.clear();
+            history.clear();
+        }
+    }
+
+    void update(float dt, Instant now) {
+        size_t needed = static_cast<size_t>(sampleRate * 1.2f * std::clamp(dt, 0.f, 0.25f));
+        buf.assign(needed, 0.f);
+
+        size_t copied = 0;
+        while (copied < needed && !history.empty()) {
+            auto& [time, count] = history.front();
+            if (now.durationSince(time).seconds<float>() < AUDIO_PLAYBACK_DELAY) break;
+
+            size_t toCopy = std::min(count, needed - copied);
+            copied += queue.readData(&buf[copied], toCopy);
+            count -= toCopy;
+
+            if (count == 0) history.pop_front();
+        }
+
+        double sum = 0.0;
+        for (float v : buf) sum += v * v;
+
+        float newVolume = needed ? static_cast<float>(std::sqrt(sum / needed)) : 0.f;
+        emaVolume = qn::exponentialMovingAverage(emaVolume, newVolume, 0.2);
+        volume = std::sqrt(std::clamp(emaVolume / 0.25f, 0.f, 1.f));
+    }
+};
+}
+
+std::string testVolumeEstimator() {
+    static constexpr size_t RATE = VOICE_TARGET_SAMPLERATE;
+    static constexpr size_t SECONDS = 60;
+    static constexpr float TOLERANCE = 0.02f;
+
+    std::mt19937 rng{1337};
+    std::uniform_real_distribution<float> unit{0.f, 1.f};
+
+    // talk spurts of a modulated tone over quiet noise, 1.8s talking out of every 3s
+    std::vector<float> pcm(RATE * SECONDS);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        float t = static_cast<float>(i) / RATE;
+        bool talking = std::fmod(t, 3.f) < 1.8f;
+        float noise = unit(rng) - 0.5f;
+
+        pcm[i] = talking
+            ? 0.3f * std::sin(2.f * std::numbers::pi_v<float> * 180.f * t) * (0.6f + 0.4f * std::sin(2.f * std::numbers::pi_v<float> * 4.f * t)) + 0.05f * noise
+            : 0.002f * noise;
+    }
+
+    // like VoiceStream, feed whatever was played since the last update and then update, at around 30fps with the occasional lag spike
+    struct Step { size_t offset, samples; float dt; Instant time; };
+    std::vector<Step> steps;
+
+    auto now = Instant::now();
+    size_t offset = 0;
+    while (true) {
+        int dtMs = unit(rng) < 0.02f ? 200 : 28 + static_cast<int>(unit(rng) * 10.f);
+        float dt = dtMs / 1000.f;
+        size_t samples = static_cast<size_t>(dt * RATE * (0.9f + 0.2f * unit(rng)));
+        if (offset + samples > pcm.size()) break;
+
+        now = now + Duration::fromMillis(dtMs);
+        steps.push_back(Step{offset, samples, dt, now});
+        offset += samples;
+    }
+
+    ReferenceVolumeEstimator reference{.sampleRate = RATE};
+    VolumeEstimator estimator{RATE};
+
+    float maxDiff = 0.f;
+    double sumDiff = 0.0;
+
+    for (auto& step : steps) {
+        reference.feedData(pcm.data() + step.offset, step.samples, step.time);
+        reference.update(step.dt, step.time);
+        estimator.feedData(pcm.data() + step.offset, step.samples, step.time);
+        estimator.update(step.dt, step.time);
+
+        float diff = std::abs(reference.volume - estimator.getVolume());
+        maxDiff = std::max(maxDiff, diff);
+        sumDiff += diff;
+    }
+
+    // timing, with a fresh estimator of each kind running the same steps
+    auto timeRun = [&](auto& est, auto&& getVolume) {
+        volatile float sink = 0.f;
+        auto start = Instant::now();
+        for (auto& step : steps) {
+            est.feedData(pcm.data() + step.offset, step.samples, step.time);
+            est.update(step.dt, step.time);
+            sink = sink + getVolume(est);
+        }
+        return static_cast<double>(start.elapsed().nanos()) / steps.size();
+    };
+
+    ReferenceVolumeEstimator timedReference{.sampleRate = RATE};
+    VolumeEstimator timedEstimator{RATE};
+    double referenceNs = timeRun(timedReference, [](auto& e) { return e.volume; });
+    double estimatorNs = timeRun(timedEstimator, [](auto& e) { return e.getVolume(); });
+
+    return fmt::format(
+        "{} updates over {}s of audio\n"
+        "Difference from the sample copying estimator: max {:.4f}, mean {:.5f} ({})\n"
+        "Feed + update: previous {:.0f}ns, current {:.0f}ns",
+        steps.size(), SECONDS,
+        maxDiff, sumDiff / std::max<size_t>(steps.size(), 1), maxDiff <= TOLERANCE ? "within tolerance" : "OUT OF TOLERANCE",
+        referenceNs, estimatorNs
+    );
+}
+
+namespace {
+struct PipelineScenario {
+    int frameMs;
+    float loss;
+};
+
+struct StageStats {
+    uint64_t totalNanos = 0;
+    uint64_t maxNanos = 0;
+
+    void add(uint64_t nanos) {
+        totalNanos += nanos;
+        maxNanos = std::max(maxNanos, nanos);
+    }
+};
+
+struct PipelineResult {
+    StageStats encode, packet, receive, playback, estimator;
+    size_t frames = 0, lost = 0, recovered = 0, concealed = 0;
+    size_t bytes = 0;
+    double snrDb = 0.0, segSnrDb = 0.0;
+    int delaySamples = 0;
+    std::string allocations;
+};
+
+// in alloc audit builds, allocations made while this is alive are attributed to the stage
+struct StageScope {
+#ifdef GLOBED_ALLOC_AUDIT
+    const char* prev;
+    StageScope(const char* name) : prev(AllocAudit::enterScope(name)) {}
+    ~StageScope() { AllocAudit::exitScope(prev); }
+#else
+    StageScope(const char*) {}
+#endif
+};
+
+// scopes are told apart by pointer, so the names have to be these exact strings
+constexpr const char* STAGE_ENCODE = "encode";
+constexpr const char* STAGE_PACKET = "packet";
+constexpr const char* STAGE_RECEIVE = "receive";
+constexpr const char* STAGE_PLAYBACK = "playback";
+constexpr const char* STAGE_ESTIMATOR = "estimator";
+}
+
+// Finds the delay of the decoded audio (codec lookahead) by cross correlating it with the input
+static int findCodecDelay(const std::vector<float>& input, const std::vector<float>& output) {
+    static constexpr int MAX_DELAY = VOICE_TARGET_SAMPLERATE / 50; // 20ms
+    // the first 10 seconds are plenty and keep this quick
+    size_t length = std::min({input.size(), output.size(), VOICE_TARGET_SAMPLERATE * 10 + MAX_DELAY}) - MAX_DELAY;
+
+    int best = 0;
+    double bestCorr = -1.0;
+
+    for (int lag = 0; lag < MAX_DELAY; lag++) {
+        double corr = 0.0;
+        for (size_t i = 0; i < length; i++) {
+            corr += static_cast<double>(input[i]) * output[i + lag];
+        }
+
+        if (corr > bestCorr) {
+            bestCorr = corr;
+            best = lag;
+        }
+    }
+
+    return best;
+}
+
+// SNR over the whole signal, and segmental SNR: the average of per 10ms SNRs (each clamped to -10..35 dB) over blocks that aren't silent.
+// Neither is a perceptual score like PESQ, but both drop clearly with loss artifacts and are comparable between runs.
+static void measureQuality(const std::vector<float>& input, const std::vector<float>& output, int delay, PipelineResult& res) {
+    static constexpr size_t BLOCK = VOICE_TARGET_SAMPLERATE / 100;
+    static constexpr double SILENCE_ENERGY = 1e-5; // about -50 dBFS
+
+    size_t length = std::min(input.size(), output.size() - delay);
+
+    double signal = 0.0, noise = 0.0;
+    double segSum = 0.0;
+    size_t segments = 0;
+
+    for (size_t b = 0; b + BLOCK <= length; b += BLOCK) {
+        double bs = 0.0, bn = 0.0;
+
+        for (size_t i = b; i < b + BLOCK; i++) {
+            double x = input[i];
+            double err = x - output[i + delay];
+            bs += x * x;
+            bn += err * err;
+        }
+
+        signal += bs;
+        noise += bn;
+
+        if (bs / BLOCK > SILENCE_ENERGY) {
+            double snr = 10.0 * std::log10(bs / std::max(bn, 1e-12));
+            segSum += std::clamp(snr, -10.0, 35.0);
+            segments++;
+        }
+    }
+
+    res.snrDb = 10.0 * std::log10(signal / std::max(noise, 1e-12));
+    res.segSnrDb = segments ? segSum / segments : 0.0;
+}
+
+static Result<PipelineResult> runVoicePipeline(const std::vector<float>& input, const PipelineScenario& sc, std::optional<int> delay) {
+    const size_t frameSize = VOICE_TARGET_SAMPLERATE * sc.frameMs / 1000;
+    const size_t frames = input.size() / frameSize;
+    const auto frameDuration = Duration::fromMillis(sc.frameMs);
+
+    PipelineResult res;
+    res.frames = frames;
+
+    AudioEncoder encoder{VOICE_TARGET_SAMPLERATE, static_cast<int>(frameSize), VOICE_CHANNELS};
+    // no fmod sound or mixer, playback is driven by calling `readCallback` below
+    auto stream = std::make_shared<VoiceStream>(nullptr, std::weak_ptr<RemotePlayer>{});
+
+    std::vector<float> playBuf(frameSize);
+    std::vector<float> output;
+
+    // sender: encode every frame and put it in its own packet, like low latency mode does
+    std::vector<EncodedAudioFrame> packets;
+    packets.reserve(frames);
+
+    for (size_t i = 0; i < frames; i++) {
+        auto start = Instant::now();
+        auto encoded = [&] {
+            StageScope scope{STAGE_ENCODE};
+            return encoder.encode(input.data() + i * frameSize);
+        }();
+        res.encode.add(start.elapsed().nanos());
+
+        GEODE_UNWRAP_INTO(auto data, std::move(encoded));
+
+        start = Instant::now();
+        {
+            StageScope scope{STAGE_PACKET};
+            EncodedAudioFrame packet{1};
+            GEODE_UNWRAP(packet.pushOpusFrame(data, encoder.lastSequence()));
+            res.bytes += packet.getFrames().front().size;
+            packets.push_back(std::move(packet));
+        }
+        res.packet.add(start.elapsed().nanos());
+    }
+
+    // network: independent random loss
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> unit{0.f, 1.f};
+    std::vector<bool> received(frames);
+    for (size_t i = 0; i < frames; i++) {
+        received[i] = unit(rng) >= sc.loss;
+        if (!received[i]) res.lost++;
+    }
+
+    // receiver: on a simulated clock, packet `i` arrives once frame `i` was captured, and playback pulls a frame every frame duration.
+    // the jitter buffer holds audio back, waits for late frames and recovers or conceals lost ones exactly like a real stream.
+    // a few extra ticks let it play out the frames it still holds at the end
+    auto now = Instant::now();
+    const size_t ticks = frames + 10;
+    bool playing = false;
+
+    // the receiver never learns about packets lost before the first one it gets, they are silence in the output
+    size_t firstReceived = std::distance(received.begin(), std::ranges::find(received, true));
+    output.reserve((ticks + firstReceived) * frameSize);
+    output.resize(std::min(firstReceived, frames) * frameSize, 0.f);
+
+    for (size_t i = 0; i < ticks; i++) {
+        now = now + frameDuration;
+
+        auto start = Instant::now();
+        auto written = [&] {
+            StageScope scope{STAGE_RECEIVE};
+            if (i < frames && received[i]) {
+                return stream->writeData(packets[i], now);
+            }
+            return stream->pump(now);
+        }();
+        res.receive.add(start.elapsed().nanos());
+
+        GEODE_UNWRAP(std::move(written));
+
+        // silence before the first audio is the jitter buffer delay, leave it out so the output lines up with the input
+        playing = playing || stream->queuedSamples() > 0;
+
+        if (playing) {
+            start = Instant::now();
+            {
+                StageScope scope{STAGE_PLAYBACK};
+                stream->readCallback(playBuf.data(), playBuf.size());
+            }
+            res.playback.add(start.elapsed().nanos());
+
+            output.insert(output.end(), playBuf.begin(), playBuf.end());
+        }
+
+        start = Instant::now();
+        {
+            StageScope scope{STAGE_ESTIMATOR};
+            stream->updateEstimator(sc.frameMs / 1000.f);
+        }
+        res.estimator.add(start.elapsed().nanos());
+    }
+
+    res.recovered = stream->jitterStats().recovered.load();
+    res.concealed = stream->jitterStats().concealed.load();
+
+    res.delaySamples = delay ? *delay : findCodecDelay(input, output);
+    measureQuality(input, output, res.delaySamples, res);
+
+#ifdef GLOBED_ALLOC_AUDIT
+    for (auto& c : AllocAudit::endFrame(0)) {
+        res.allocations += fmt::format("{} {:.2f}, ", c.name, static_cast<double>(c.count) / frames);
+    }
+    if (res.allocations.empty()) res.allocations = "none";
+#else
+    res.allocations = "only counted in alloc audit builds";
+#endif
+
+    return Ok(std::move(res));
+}
+
+std::string benchmarkVoicePipeline() {
+    static constexpr size_t SECONDS = 30;
+
+    // raw 32-bit float, mono, 24kHz pcm placed in the save directory is used instead of synthetic speech
+    auto recordingPath = geode::Mod::get()->getSaveDir() / "voice-bench.f32";
+    std::vector<float> input;
+    const char* source = "synthetic speech";
+
+    if (std::ifstream file{recordingPath, std::ios::binary | std::ios::ate}) {
+        size_t samples = static_cast<size_t>(file.tellg()) / sizeof(float);
+        input.resize(samples);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(input.data()), samples * sizeof(float));
+        source = "voice-bench.f32";
+    }
+
+    if (input.size() < VOICE_TARGET_SAMPLERATE) {
+        std::mt19937 rng{1337};
+        std::vector<bool> labels;
+        generateVadSignal(VadScenario{"Quiet room", -70.f, 0.f, false}, rng, input, labels);
+        input.resize(VOICE_TARGET_SAMPLERATE * SECONDS);
+        source = "synthetic speech";
+    }
+
+    const PipelineScenario scenarios[] = {
+        {60, 0.f},
+        {60, 0.05f},
+        {60, 0.15f},
+        {20, 0.f},
+        {20, 0.05f},
+    };
+
+    std::string out;
+
+    // on its own thread, so that allocation counts only include the pipeline
+    std::thread([&] {
+        double audioSecs = static_cast<double>(input.size()) / VOICE_TARGET_SAMPLERATE;
+        out = fmt::format("{:.0f}s of {}, one frame per packet, received through VoiceStream's jitter buffer\n", audioSecs, source);
+
+        std::optional<int> delay;
+
+        for (auto& sc : scenarios) {
+            auto res = runVoicePipeline(input, sc, delay);
+            if (!res) {
+                out += fmt::format("\n{}ms, {:.0f}% loss: failed: {}", sc.frameMs, sc.loss * 100.f, res.unwrapErr());
+                continue;
+            }
+
+            // the codec delay is measured once without loss, where concealment can't throw off the correlation
+            if (!delay && sc.loss == 0.f) {
+                delay = res->delaySamples;
+            }
+
+            auto us = [&](const StageStats& st) { return st.totalNanos / 1000.0 / res->frames; };
+            auto maxUs = [](const StageStats& st) { return st.maxNanos / 1000.0; };
+            auto speed = [&](const StageStats& st) { return audioSecs / std::max(st.totalNanos / 1e9, 1e-9); };
+
+            out += fmt::format(
+                "\n{}ms frames, {:.0f}% loss ({} lost, {} recovered, {} concealed): {:.1f} kbps, SNR {:.1f} dB, segmental SNR {:.1f} dB\n"
+                "Encode {:.0f}x realtime, receive {:.0f}x realtime\n"
+                "Per frame (avg/max us): encode {:.1f}/{:.1f}, packet {:.2f}/{:.2f}, receive {:.1f}/{:.1f}, playback {:.2f}/{:.2f}, estimator {:.2f}/{:.2f}\n"
+                "Allocations per frame: {}\n",
+                sc.frameMs, sc.loss * 100.f, res->lost, res->recovered, res->concealed,
+                res->bytes * 8.0 / audioSecs / 1000.0, res->snrDb, res->segSnrDb,
+                speed(res->encode), speed(res->receive),
+                us(res->encode), maxUs(res->encode), us(res->packet), maxUs(res->packet),
+                us(res->receive), maxUs(res->receive), us(res->playback), maxUs(res->playback),
+                us(res->estimator), maxUs(res->estimator),
+                res->allocations
+            );
+        }
+
+        if (delay) {
+            out += fmt::format("\nCodec delay {:.1f}ms, added to each frame's duration for the algorithmic latency", *delay * 1000.0 / VOICE_TARGET_SAMPLERATE);
+        }
+    }).join();
+
+    return out;
+}
+
+namespace {
+struct DrawCalls {
+    size_t names;
+    size_t status;
+    size_t progress;
+};
+}
+
+static size_t countDrawCalls(cocos2d::CCNode* node) {
+    // rendered off-screen, so nothing shows up on screen
+    auto rt = cocos2d::CCRenderTexture::create(512, 512);
+
+    rt->begin();
+    auto before = g_uNumberOfDraws;
+    node->visit();
+    size_t draws = g_uNumberOfDraws - before;
+    rt->end();
+
+    return draws;
+}
+
+static DrawCalls measurePlayerDrawCalls(size_t players, bool batched) {
+    using namespace cocos2d;
+
+    auto names = CCNode::create();
+    auto status = CCNode::create();
+    auto progressBar = CCNode::create();
+    auto progress = CCNode::create();
+    progressBar->setContentSize({200.f, 10.f});
+    progressBar->addChild(progress);
+
+    NameLabelBatch* nameBatch = nullptr;
+    StatusIconBatch* statusBatch = nullptr;
+    ProgressIconBatch* progressBatch = nullptr;
+
+    if (batched) {
+        nameBatch = NameLabelBatch::create("chatFont.fnt");
+        statusBatch = StatusIconBatch::create();
+        progressBatch = ProgressIconBatch::create();
+        names->addChild(nameBatch, 1);
+        status->addChild(statusBatch, 1);
+        progress->addChild(progressBatch);
+    }
+
+    PlayerStatusFlags flags{};
+    flags.paused = true;
+    flags.speaking = true;
+
+    for (size_t i = 0; i < players; i++) {
+        CCPoint pos{static_cast<float>(i % 10) * 50.f + 25.f, static_cast<float>(i / 10) * 50.f + 25.f};
+        auto name = fmt::format("Player{}", i);
+
+        auto label = nameBatch ? NameLabel::createBatched(name, nameBatch) : NameLabel::create(name, "chatFont.fnt");
+        names->addChild(label);
+        label->setShadowEnabled(true);
+        label->setPosition(pos);
+
+        auto icons = statusBatch ? PlayerStatusIcons::createBatched(255, statusBatch) : PlayerStatusIcons::create(255);
+        status->addChild(icons);
+        icons->setScale(0.8f);
+        icons->setAnchorPoint({0.5f, 0.f});
+        icons->setPosition(pos);
+        icons->updateStatus(flags);
+
+        // a handful of players share the same icons, like in a real level
+        int id = static_cast<int>(i % 20) + 1;
+        auto progIcon = progressBatch ? ProgressIcon::createBatched(progressBatch) : ProgressIcon::create();
+        progress->addChild(progIcon);
+        progIcon->updateIcons(cue::Icons{IconType::Cube, id, id % 40, (id + 5) % 40, -1});
+        progIcon->updatePosition(static_cast<float>(i) / players, false);
+    }
+
+    return DrawCalls {
+        .names = countDrawCalls(names),
+        .status = countDrawCalls(status),
+        .progress = countDrawCalls(progressBar),
+    };
+}
+
+std::string benchmarkPlayerDrawCalls() {
+    static constexpr size_t PLAYERS = 100;
+
+    // the icons come from the game's sprite sheets, which aren't loaded until the loading screen is done
+    if (!cocos2d::CCSpriteFrameCache::get()->spriteFrameByName("GJ_pauseBtn_clean_001.png")) {
+        return "Game textures are not loaded yet, run this from the settings menu instead";
+    }
+
+    auto separate = measurePlayerDrawCalls(PLAYERS, false);
+    auto batched = measurePlayerDrawCalls(PLAYERS, true);
+
+    return fmt::format(
+        "Draw calls for {} players (separate nodes -> batched):\n"
+        "Name labels: {} -> {}\n"
+        "Status icons: {} -> {}\n"
+        "Progress icons: {} -> {}\n"
+        "Total: {} -> {}",
+        PLAYERS,
+        separate.names, batched.names,
+        separate.status, batched.status,
+        separate.progress, batched.progress,
+        separate.names + separate.status + separate.progress,
+        batched.names + batched.status + batched.progress
+    );
+}
+
+namespace {
+struct RobotSpriteResult {
+    double microsPerSprite = 0.0;
+    bool shared = false;
+    std::string allocations;
+};
+
+constexpr const char* STAGE_ROBOT_SPRITES = "sprites";
+}
+
+template <typename Sprite>
+static RobotSpriteResult measureRobotSprites(int id, size_t count) {
+    // the first sprite loads the animation description, the rest reuse it
+    geode::Ref<Sprite> first = Sprite::create(id);
+    std::vector<geode::Ref<Sprite>> sprites;
+    sprites.reserve(count);
+
+#ifdef GLOBED_ALLOC_AUDIT
+    (void) AllocAudit::endFrame(0);
+#endif
+
+    auto start = asp::time::Instant::now();
+    {
+        StageScope scope{STAGE_ROBOT_SPRITES};
+        for (size_t i = 0; i < count; i++) {
+            sprites.push_back(Sprite::create(id));
+        }
+    }
+    auto elapsed = start.elapsed();
+
+    RobotSpriteResult res;
+    res.microsPerSprite = static_cast<double>(elapsed.nanos()) / 1000.0 / count;
+    res.shared = std::ranges::all_of(sprites, [&](auto& spr) {
+        return spr->m_animationManager->m_typeDict == first->m_animationManager->m_typeDict
+            && spr->m_animationManager->m_priorityDict == first->m_animationManager->m_priorityDict;
+    });
+
+#ifdef GLOBED_ALLOC_AUDIT
+    for (auto& c : AllocAudit::endFrame(0)) {
+        res.allocations += fmt::format("{:.1f} ({} bytes)", static_cast<double>(c.count) / count, c.bytes / count);
+    }
+    if (res.allocations.empty()) res.allocations = "none";
+#else
+    res.allocations = "only counted in alloc audit builds";
+#endif
+
+    return res;
+}
+
+std::string benchmarkRobotSprites() {
+    static constexpr size_t SPRITES = 50;
+    static constexpr int ICON_ID = 1;
+
+    auto gm = GameManager::get();
+    gm->loadIcon(ICON_ID, static_cast<int>(IconType::Robot), -1);
+    gm->loadIcon(ICON_ID, static_cast<int>(IconType::Spider), -1);
+
+    auto robots = measureRobotSprites<GJRobotSprite>(ICON_ID, SPRITES);
+    auto spiders = measureRobotSprites<GJSpiderSprite>(ICON_ID, SPRITES);
+
+    auto format = [](const char* name, const RobotSpriteResult& res) {
+        return fmt::format(
+            "{}: {:.1f}us per sprite, shared definition: {}, allocations per sprite: {}",
+            name, res.microsPerSprite, res.shared ? "yes" : "no", res.allocations
+        );
+    };
+
+    return fmt::format("{} sprites of each type\n{}\n{}", SPRITES, format("Robots", robots), format("Spiders", spiders));
+}
+
+static const Benchmark BENCHMARKS[] = {
+    {"map", "Map Benchmark", &benchmarkFlatIntMap},
+    {"long-session", "Long Session Simulation", &simulateLongSessions},
+    {"audio-ring", "Audio Ring Stress Test", &stressTestAudioRing},
+    {"vad", "Voice Activity Test", &testVoiceActivityDetector},
+    {"voice-mixer", "Voice Mixer Benchmark", &benchmarkVoiceMixer},
+    {"volume-estimator", "Volume Estimator Test", &testVolumeEstimator},
+    {"voice-pipeline", "Voice Pipeline Benchmark", &benchmarkVoicePipeline},
+    {"draw-calls", "Player Draw Calls", &benchmarkPlayerDrawCalls},
+    {"robot-sprites", "Robot Sprite Benchmark", &benchmarkRobotSprites},
+};
+
+std::span<const Benchmark> allBenchmarks() {
+    return BENCHMARKS;
+}
+
+std::optional<std::string> runBenchmarks(std::string_view id) {
+    std::string out;
+
+    for (auto& bench : BENCHMARKS) {
+        if (id != "all" && id != bench.id) continue;
+
+        auto report = bench.run();
+        geode::log::info("{}:\n{}", bench.name, report);
+
+        if (!out.empty()) out += "\n\n";
+        out += fmt::format("{}\n{}", bench.name, report);
+    }
+
+    if (out.empty()) return std::nullopt;
+    return out;
+}
+
+// Lets CI run benchmarks without touching the UI:
+// `--geode:globed/bench.<id>` (or `bench.all`) writes the report to `bench-<id>.txt` in the save directory,
+// and `--geode:globed/bench.exit` closes the game once they are done.
+$on_mod(Loaded) {
+    std::vector<std::string> ids;
+
+    for (auto& name : geode::Loader::get()->getLaunchArgumentNames()) {
+        if (name.starts_with("globed/bench.") && name != "globed/bench.exit") {
+            ids.push_back(name.substr(13));
+        }
+    }
+
+    if (ids.empty()) return;
+
+    // wait for the game to finish loading, so that it doesn't skew the results
+    geode::queueInMainThread([ids = std::move(ids)] {
+        for (auto& id : ids) {
+            auto report = runBenchmarks(id);
+            if (!report) {
+                geode::log::error("Unknown benchmark '{}'", id);
+                continue;
+            }
+
+            auto path = geode::Mod::get()->getSaveDir() / fmt::format("bench-{}.txt", id);
+            if (auto err = geode::utils::file::writeString(path, *report).err()) {
+                geode::log::error("Failed to write benchmark report: {}", *err);
+            }
+        }
+
+        if (geode::Loader::get()->getLaunchFlag("globed/bench.exit")) {
+            geode::utils::game::exit();
+        }
+    });
+}
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace globed {
+
+/// Developer benchmarks, run from the settings menu or with the `globed/bench.<id>` launch flags. Each one runs synchronously and returns a human readable report.
+/// Only built when `GLOBED_BENCHMARKS` is defined (`benchmarks` in config.toml, or `-DGLOBED_BENCHMARKS=ON`).
+
+struct Benchmark {
+    std::string_view id;
+    std::string_view name;
+    std::string (*run)();
+};
+
+/// Every benchmark declared in this header, in the order `runBenchmarks("all")` runs them
+std::span<const Benchmark> allBenchmarks();
+
+/// Runs the benchmark with the given ID, or every benchmark if it is `all`, and returns their combined report.
+/// Returns nothing if there is no benchmark with that ID.
+std::optional<std::string> runBenchmarks(std::string_view id);
+
+/// Compares lookup and iteration cost of `FlatIntMap` and `std::unordered_map` with 500 account IDs
+std::string benchmarkFlatIntMap();
+
+/// Simulates a remote player moving at a constant speed at several points of a long session (up to 72 hours), through the `Interpolator`,
+/// once with the sender using integer timestamps and once with it accumulating float seconds. Reports movement jitter, stalls and player resets.
+std::string simulateLongSessions();
+
+/// Streams audio through 32 `AudioRingBuffer`s at once, each with its own writer and reader thread, and checks that every sample arrives in order
+std::string stressTestAudioRing();
+
+/// Runs labeled PCM (synthetic speech over several kinds of background noise) through `VoiceActivityDetector`
+/// and reports how often it flags noise as speech (false positives) and misses speech (false negatives)
+std::string testVoiceActivityDetector();
+
+/// Plays 10, 50 and 100 voice streams on a headless FMOD system, once with a channel per stream and once through `VoiceMixer`,
+/// and compares the CPU time FMOD spends and the amount of channels it uses
+std::string benchmarkVoiceMixer();
+
+/// Feeds a minute of voice-like audio into `VolumeEstimator` and into a copy of the previous implementation (which kept the samples),
+/// checks that both report the same volume within tolerance and compares their cost
+std::string testVolumeEstimator();
+
+/// Runs speech through the whole voice pipeline without FMOD (`AudioEncoder` -> `EncodedAudioFrame` -> `VoiceStream`, which receives it through
+/// `VoiceJitterBuffer`, `AudioDecoder` and `AudioRingBuffer`, and plays it into its `VolumeEstimator`) on a simulated clock,
+/// with several frame durations and amounts of simulated packet loss. Reports throughput, time per stage, allocations per stage and SNR.
+/// Uses `voice-bench.f32` from the save directory (raw float pcm, mono, 24kHz) if it exists, synthetic speech otherwise.
+std::string benchmarkVoicePipeline();
+
+/// Builds the name labels, status icons and progress icons of 100 players, once as separate nodes and once through
+/// `NameLabelBatch`, `StatusIconBatch` and `ProgressIconBatch`, and counts the draw calls it takes to render each with the cocos draw counter
+std::string benchmarkPlayerDrawCalls();
+
+/// Creates 50 robot and 50 spider sprites after the first one of each type, checks that they all share the animation definition
+/// loaded by the first one and reports the time and allocations it takes to create each
+std::string benchmarkRobotSprites();
+
+}
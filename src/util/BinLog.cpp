@@ -0,0 +1,212 @@
+#include "BinLog.hpp"
+
+#include <Geode/Geode.hpp>
+#include <arc/time/Sleep.hpp>
+#include <fmt/format.h>
+#include <chrono>
+
+using namespace geode::prelude;
+using namespace asp::time;
+
+constexpr auto FLUSH_INTERVAL = Duration::fromMillis(250);
+constexpr char FILE_MAGIC[8] = {'G', 'B', 'I', 'N', 'L', 'O', 'G', '1'};
+
+namespace globed {
+
+static uint64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+static uint64_t systemNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+static thread_local BinLog::ThreadRing* t_ring = nullptr;
+
+BinLog::ThreadRing::ThreadRing(uint32_t id, std::string name)
+    : m_id(id), m_name(std::move(name)), m_data(std::make_unique<uint8_t[]>(CAPACITY)) {}
+
+uint8_t* BinLog::ThreadRing::begin(size_t size) {
+    uint64_t head = m_head.load(std::memory_order::relaxed);
+    uint64_t tail = m_tail.load(std::memory_order::acquire);
+
+    if (CAPACITY - (head - tail) < size) {
+        m_dropped.fetch_add(1, std::memory_order::relaxed);
+        return nullptr;
+    }
+
+    m_pending = size;
+    size_t offset = head % CAPACITY;
+    m_pendingScratch = offset + size > CAPACITY;
+
+    return m_pendingScratch ? m_scratch : m_data.get() + offset;
+}
+
+void BinLog::ThreadRing::commit() {
+    uint64_t head = m_head.load(std::memory_order::relaxed);
+
+    if (m_pendingScratch) {
+        size_t offset = head % CAPACITY;
+        size_t first = CAPACITY - offset;
+        std::memcpy(m_data.get() + offset, m_scratch, first);
+        std::memcpy(m_data.get(), m_scratch + first, m_pending - first);
+    }
+
+    m_head.store(head + m_pending, std::memory_order::release);
+}
+
+void BinLog::ThreadRing::drain(std::vector<uint8_t>& out) {
+    uint64_t tail = m_tail.load(std::memory_order::relaxed);
+    uint64_t head = m_head.load(std::memory_order::acquire);
+    if (head == tail) return;
+
+    size_t size = head - tail;
+    size_t offset = tail % CAPACITY;
+    size_t first = std::min(size, CAPACITY - offset);
+
+    out.insert(out.end(), m_data.get() + offset, m_data.get() + offset + first);
+    out.insert(out.end(), m_data.get(), m_data.get() + (size - first));
+
+    m_tail.store(head, std::memory_order::release);
+}
+
+BinLog::BinLog() : m_epoch(steadyNanos()) {}
+
+void BinLog::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order::relaxed);
+
+    if (enabled && !m_flusherStarted.exchange(true)) {
+        async::spawn(this->flushLoop()).setName("[Globed] Binary Log Flusher");
+    }
+}
+
+uint32_t BinLog::registerFormat(const char* fmt) {
+    auto formats = m_formats.lock();
+    formats->push_back(fmt);
+    return formats->size() - 1;
+}
+
+BinLog::ThreadRing& BinLog::threadRing() {
+    if (t_ring) return *t_ring;
+
+    auto rings = m_rings.lock();
+    uint32_t id = rings->size() + 1;
+    auto name = utils::thread::getName();
+
+    t_ring = rings->emplace_back(std::make_unique<ThreadRing>(id, std::move(name))).get();
+    return *t_ring;
+}
+
+uint64_t BinLog::now() const {
+    return steadyNanos() - m_epoch;
+}
+
+arc::Future<> BinLog::flushLoop() {
+    while (true) {
+        co_await arc::sleep(FLUSH_INTERVAL);
+        co_await this->flush();
+    }
+}
+
+template <typename T>
+static void append(std::vector<uint8_t>& out, T value) {
+    auto bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+static void appendString(std::vector<uint8_t>& out, std::string_view str) {
+    append<uint16_t>(out, str.size());
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+arc::Future<> BinLog::flush() {
+    // events are drained first, so that every format they reference is already registered when formats are written below
+    std::vector<uint8_t> events;
+    std::vector<std::string> newThreads;
+
+    {
+        auto rings = m_rings.lock();
+        std::vector<uint8_t> scratch;
+
+        for (auto& ring : *rings) {
+            scratch.clear();
+            ring->drain(scratch);
+
+            if (!scratch.empty()) {
+                events.push_back('E');
+                append<uint32_t>(events, ring->id());
+                append<uint32_t>(events, scratch.size());
+                events.insert(events.end(), scratch.begin(), scratch.end());
+            }
+
+            if (uint64_t dropped = ring->takeDropped()) {
+                events.push_back('D');
+                append<uint32_t>(events, ring->id());
+                append<uint64_t>(events, dropped);
+            }
+        }
+
+        for (size_t i = m_writtenThreads; i < rings->size(); i++) {
+            newThreads.push_back((*rings)[i]->name());
+        }
+    }
+
+    std::vector<uint8_t> out;
+
+    for (size_t i = 0; i < newThreads.size(); i++) {
+        out.push_back('T');
+        append<uint32_t>(out, m_writtenThreads + i + 1);
+        appendString(out, newThreads[i]);
+    }
+    m_writtenThreads += newThreads.size();
+
+    {
+        auto formats = m_formats.lock();
+        for (size_t i = m_writtenFormats; i < formats->size(); i++) {
+            out.push_back('F');
+            append<uint32_t>(out, i);
+            appendString(out, (*formats)[i]);
+        }
+        m_writtenFormats = formats->size();
+    }
+
+    if (events.empty() && out.empty()) co_return;
+
+    out.insert(out.end(), events.begin(), events.end());
+
+    co_await arc::spawnBlocking<void>([&] {
+        if (!m_file.is_open()) {
+            auto secs = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            m_path = Mod::get()->getSaveDir() / "binlogs" / fmt::format("binlog-{}.bin", secs);
+
+            if (auto err = utils::file::createDirectoryAll(m_path.parent_path()).err()) {
+                log::error("BinLog: failed to create log directory: {}", *err);
+                s_enabled.store(false, std::memory_order::relaxed);
+                return;
+            }
+
+            m_file.open(m_path, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!m_file) {
+                log::error("BinLog: failed to open {}", m_path);
+                s_enabled.store(false, std::memory_order::relaxed);
+                return;
+            }
+
+            // wall clock time of the epoch, so the formatter can print absolute timestamps
+            uint64_t epochWall = systemNanos() - this->now();
+            m_file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+            m_file.write(reinterpret_cast<const char*>(&epochWall), sizeof(epochWall));
+
+            log::info("BinLog: writing binary logs to {}", m_path);
+        }
+
+        m_file.write(reinterpret_cast<const char*>(out.data()), out.size());
+        m_file.flush();
+    });
+}
+
+}
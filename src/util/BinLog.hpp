@@ -0,0 +1,193 @@
+#pragma once
+
+#include <globed/util/singleton.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <asp/time/Duration.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <cocos2d.h>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace globed {
+
+/// Binary logging channel for hot paths (interpolation, networking).
+/// Instead of formatting a string, a log call writes a preregistered format ID and its raw arguments into a per-thread ring buffer,
+/// which costs a few tens of nanoseconds. A background task periodically writes the rings to a file in the save directory,
+/// and `binlog.py` in the repository root renders that file to text later. Format strings use the `{}` syntax of fmt.
+class BinLog : public SingletonLeakBase<BinLog> {
+    friend class SingletonLeakBase;
+    BinLog();
+
+public:
+    enum class Tag : uint8_t {
+        I64 = 1,
+        U64 = 2,
+        F64 = 3,
+        Bool = 4,
+        Str = 5,
+        Point = 6,
+        I32Array = 7,
+        Duration = 8,
+    };
+
+    /// Single producer ring of encoded records, only the owning thread writes and only the flusher reads
+    class ThreadRing {
+    public:
+        static constexpr size_t CAPACITY = 256 * 1024;
+
+        ThreadRing(uint32_t id, std::string name);
+
+        /// Reserves space for a record, returns nullptr if the ring is full (in which case the record is dropped)
+        uint8_t* begin(size_t size);
+        void commit();
+
+        /// Moves all available bytes into `out`
+        void drain(std::vector<uint8_t>& out);
+
+        uint32_t id() const { return m_id; }
+        const std::string& name() const { return m_name; }
+        uint64_t takeDropped() { return m_dropped.exchange(0, std::memory_order::relaxed); }
+
+    private:
+        uint32_t m_id;
+        std::string m_name;
+        std::unique_ptr<uint8_t[]> m_data;
+        std::atomic<uint64_t> m_head{0}; // written by the owner
+        std::atomic<uint64_t> m_tail{0}; // written by the flusher
+        std::atomic<uint64_t> m_dropped{0};
+
+        // records never wrap around, if one doesn't fit at the end it is written to a scratch buffer and copied in commit()
+        uint8_t m_scratch[512];
+        size_t m_pending = 0;
+        bool m_pendingScratch = false;
+    };
+
+    static bool enabled() {
+        return s_enabled.load(std::memory_order::relaxed);
+    }
+
+    void setEnabled(bool enabled);
+
+    /// Registers a format string, the pointer must have static lifetime. Returns its ID.
+    uint32_t registerFormat(const char* fmt);
+
+    template <typename... Args>
+    void write(uint32_t fmtId, const Args&... args) {
+        size_t size = HEADER_SIZE + (0 + ... + encodedSize(args));
+        if (size > MAX_RECORD_SIZE) return;
+
+        auto& ring = this->threadRing();
+        uint8_t* ptr = ring.begin(size);
+        if (!ptr) return;
+
+        ptr = put<uint16_t>(ptr, static_cast<uint16_t>(size));
+        ptr = put<uint32_t>(ptr, fmtId);
+        ptr = put<uint64_t>(ptr, this->now());
+        ptr = put<uint8_t>(ptr, static_cast<uint8_t>(sizeof...(Args)));
+        ((ptr = encode(ptr, args)), ...);
+
+        ring.commit();
+    }
+
+private:
+    static constexpr size_t HEADER_SIZE = 2 + 4 + 8 + 1;
+    static constexpr size_t MAX_RECORD_SIZE = 512;
+    static constexpr size_t MAX_STRING = 200;
+    static constexpr size_t MAX_ARRAY = 64;
+
+    static inline std::atomic<bool> s_enabled{false};
+
+    uint64_t m_epoch;
+    asp::Mutex<std::vector<const char*>> m_formats;
+    asp::Mutex<std::vector<std::unique_ptr<ThreadRing>>> m_rings;
+    std::atomic<bool> m_flusherStarted{false};
+
+    // only touched by the flusher
+    size_t m_writtenFormats = 0;
+    size_t m_writtenThreads = 0;
+    std::ofstream m_file;
+    std::filesystem::path m_path;
+
+    ThreadRing& threadRing();
+    uint64_t now() const;
+    arc::Future<> flushLoop();
+    /// Writes everything that has been logged so far to the log file, on a blocking thread
+    arc::Future<> flush();
+
+    template <typename T>
+    static uint8_t* put(uint8_t* ptr, T value) {
+        std::memcpy(ptr, &value, sizeof(T));
+        return ptr + sizeof(T);
+    }
+
+    template <typename T>
+    static constexpr size_t encodedSize(const T& value) {
+        if constexpr (std::is_same_v<T, cocos2d::CCPoint>) {
+            return 1 + 8;
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            return 1 + 2 + std::min(std::string_view{value}.size(), MAX_STRING);
+        } else if constexpr (std::is_convertible_v<const T&, std::span<const int>>) {
+            return 1 + 2 + std::min(std::span<const int>{value}.size(), MAX_ARRAY) * 4;
+        } else {
+            return 1 + 8;
+        }
+    }
+
+    template <typename T>
+    static uint8_t* encode(uint8_t* ptr, const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            ptr = put(ptr, Tag::Bool);
+            return put<uint64_t>(ptr, value ? 1 : 0);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            ptr = put(ptr, Tag::F64);
+            return put<double>(ptr, value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            ptr = put(ptr, Tag::I64);
+            return put<int64_t>(ptr, value);
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            ptr = put(ptr, Tag::U64);
+            return put<uint64_t>(ptr, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_same_v<T, asp::time::Duration>) {
+            ptr = put(ptr, Tag::Duration);
+            return put<uint64_t>(ptr, value.nanos());
+        } else if constexpr (std::is_same_v<T, cocos2d::CCPoint>) {
+            ptr = put(ptr, Tag::Point);
+            ptr = put<float>(ptr, value.x);
+            return put<float>(ptr, value.y);
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            std::string_view str{value};
+            size_t len = std::min(str.size(), MAX_STRING);
+            ptr = put(ptr, Tag::Str);
+            ptr = put<uint16_t>(ptr, len);
+            std::memcpy(ptr, str.data(), len);
+            return ptr + len;
+        } else if constexpr (std::is_convertible_v<const T&, std::span<const int>>) {
+            std::span<const int> arr{value};
+            size_t len = std::min(arr.size(), MAX_ARRAY);
+            ptr = put(ptr, Tag::I32Array);
+            ptr = put<uint16_t>(ptr, len);
+            std::memcpy(ptr, arr.data(), len * 4);
+            return ptr + len * 4;
+        } else {
+            static_assert(!sizeof(T), "unsupported binary log argument type");
+        }
+    }
+};
+
+}
+
+/// Writes a binary log record if binary logging is enabled. The format string must be a string literal.
+#define GLOBED_BINLOG(fmtstr, ...) \
+    do { \
+        if (::globed::BinLog::enabled()) { \
+            static const uint32_t _globedBinlogFmt = ::globed::BinLog::get().registerFormat(fmtstr); \
+            ::globed::BinLog::get().write(_globedBinlogFmt __VA_OPT__(,) __VA_ARGS__); \
+        } \
+    } while (0)
@@ -1,4 +1,5 @@
 #include <globed/util/FunctionQueue.hpp>
+#include "Profiler.hpp"
 
 using namespace geode::prelude;
 using namespace asp::time;
@@ -22,6 +23,8 @@ void FunctionQueue::queueDelay(Func&& func, asp::time::Duration delay) {
 }
 
 void FunctionQueue::update(float dt) {
+    GLOBED_PROFILE_ZONE("Function Queue");
+
     auto tick = m_tick++;
 
     auto guard = m_queue.lock();
@@ -0,0 +1,128 @@
+#include <globed/util/InstrumentedLock.hpp>
+#include "Profiler.hpp"
+
+#include <fmt/format.h>
+#include <bit>
+#include <memory>
+
+namespace globed {
+
+// waits shorter than this are not worth showing in profiler traces
+constexpr uint64_t MIN_TRACED_WAIT_NS = 10'000;
+
+static asp::Mutex<std::vector<std::unique_ptr<LockStats>>>& registry() {
+    static auto* reg = new asp::Mutex<std::vector<std::unique_ptr<LockStats>>>();
+    return *reg;
+}
+
+static size_t bucketFor(uint64_t ns) {
+    uint64_t us = ns / 1000;
+    if (us == 0) return 0;
+
+    return std::min<size_t>(std::bit_width(us), LockStats::BUCKETS - 1);
+}
+
+static void updateMax(std::atomic<uint64_t>& max, uint64_t value) {
+    uint64_t cur = max.load(std::memory_order::relaxed);
+    while (value > cur && !max.compare_exchange_weak(cur, value, std::memory_order::relaxed)) {}
+}
+
+void LockStats::recordWait(uint64_t ns) {
+    acquisitions.fetch_add(1, std::memory_order::relaxed);
+    totalWaitNs.fetch_add(ns, std::memory_order::relaxed);
+    waitHist[bucketFor(ns)].fetch_add(1, std::memory_order::relaxed);
+    updateMax(maxWaitNs, ns);
+
+    if (ns >= MIN_TRACED_WAIT_NS && Profiler::enabled()) {
+        auto& prof = Profiler::get();
+        auto now = prof.now();
+        prof.record(waitZoneName.c_str(), now > ns ? now - ns : 0, now);
+    }
+}
+
+void LockStats::recordHold(uint64_t ns) {
+    totalHoldNs.fetch_add(ns, std::memory_order::relaxed);
+    holdHist[bucketFor(ns)].fetch_add(1, std::memory_order::relaxed);
+    updateMax(maxHoldNs, ns);
+}
+
+LockStats* LockStats::get(std::string_view name) {
+    auto reg = registry().lock();
+
+    for (auto& stats : *reg) {
+        if (stats->name == name) {
+            return stats.get();
+        }
+    }
+
+    auto stats = std::make_unique<LockStats>();
+    stats->name = std::string{name};
+    stats->waitZoneName = fmt::format("Lock wait: {}", name);
+
+    return reg->emplace_back(std::move(stats)).get();
+}
+
+std::vector<LockStats*> LockStats::all() {
+    auto reg = registry().lock();
+
+    std::vector<LockStats*> out;
+    out.reserve(reg->size());
+    for (auto& stats : *reg) {
+        out.push_back(stats.get());
+    }
+
+    return out;
+}
+
+void LockStats::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order::relaxed);
+}
+
+std::string LockStats::summary() {
+    std::string out;
+
+    auto fmtNs = [](uint64_t ns) {
+        return asp::time::Duration::fromNanos(ns).toString();
+    };
+
+    for (auto lock : all()) {
+        uint64_t acq = lock->acquisitions.load(std::memory_order::relaxed);
+        if (acq == 0) continue;
+
+        fmt::format_to(
+            std::back_inserter(out),
+            "- {}: {} acquisitions, avg wait {}, max wait {}, avg hold {}, max hold {}\n",
+            lock->name,
+            acq,
+            fmtNs(lock->totalWaitNs.load(std::memory_order::relaxed) / acq),
+            fmtNs(lock->maxWaitNs.load(std::memory_order::relaxed)),
+            fmtNs(lock->totalHoldNs.load(std::memory_order::relaxed) / acq),
+            fmtNs(lock->maxHoldNs.load(std::memory_order::relaxed))
+        );
+        fmt::format_to(std::back_inserter(out), ">   wait: {}\n", formatHistogram(lock->waitHist));
+        fmt::format_to(std::back_inserter(out), ">   hold: {}\n", formatHistogram(lock->holdHist));
+    }
+
+    return out;
+}
+
+std::string LockStats::formatHistogram(const std::array<std::atomic<uint64_t>, BUCKETS>& hist) {
+    std::string out;
+
+    for (size_t i = 0; i < BUCKETS; i++) {
+        uint64_t count = hist[i].load(std::memory_order::relaxed);
+        if (count == 0) continue;
+
+        if (!out.empty()) out += ", ";
+
+        if (i == BUCKETS - 1) {
+            fmt::format_to(std::back_inserter(out), ">={}us: {}", 1ull << (i - 1), count);
+        } else {
+            fmt::format_to(std::back_inserter(out), "<{}us: {}", 1ull << i, count);
+        }
+    }
+
+    return out.empty() ? "<none>" : out;
+}
+
+}
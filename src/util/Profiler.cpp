@@ -0,0 +1,235 @@
+#include "Profiler.hpp"
+
+#include <Geode/Geode.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <fmt/format.h>
+#include <chrono>
+
+using namespace geode::prelude;
+
+namespace globed {
+
+static uint64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+static thread_local ProfilerThreadBuffer* t_buffer = nullptr;
+
+// releases the buffer of its thread when the thread exits
+struct ProfilerThreadExitGuard {
+    ~ProfilerThreadExitGuard() {
+        if (!t_buffer) return;
+
+        auto threads = Profiler::get().m_threads.lock();
+        std::erase_if(*threads, [](auto& buf) { return buf.get() == t_buffer; });
+        t_buffer = nullptr;
+    }
+};
+
+static thread_local ProfilerThreadExitGuard t_exitGuard;
+
+ProfilerThreadBuffer::ProfilerThreadBuffer(uint64_t id, std::string name) : m_id(id), m_name(std::move(name)) {}
+
+void ProfilerThreadBuffer::push(const ProfilerZoneEvent& event) {
+    uint64_t idx = m_written.load(std::memory_order::relaxed);
+    m_events[idx % CAPACITY] = event;
+    m_written.store(idx + 1, std::memory_order::release);
+}
+
+void ProfilerThreadBuffer::snapshot(std::vector<ProfilerZoneEvent>& out, uint64_t since, uint32_t maxDepth) const {
+    // while `m_written` is N, the owning thread may be writing zone N, which overwrites the slot of zone N - CAPACITY,
+    // so only the last CAPACITY - 1 zones are safe to read
+    uint64_t end = m_written.load(std::memory_order::acquire);
+    uint64_t begin = end >= CAPACITY ? end - CAPACITY + 1 : 0;
+
+    // walk backwards to find the first zone that ended after `since`, zones are pushed in the order they end
+    uint64_t first = end;
+    while (first > begin && m_events[(first - 1) % CAPACITY].end > since) {
+        first--;
+    }
+
+    size_t outStart = out.size();
+    for (uint64_t i = first; i < end; i++) {
+        out.push_back(m_events[i % CAPACITY]);
+    }
+
+    // if the writer lapped us during the copy, the oldest copied zones may be garbage, drop them.
+    // this is done before filtering by depth, so that the copied zones still line up with their indices
+    uint64_t after = m_written.load(std::memory_order::acquire);
+    if (after >= CAPACITY && after - CAPACITY + 1 > first) {
+        uint64_t lost = std::min<uint64_t>(after - CAPACITY + 1 - first, out.size() - outStart);
+        out.erase(out.begin() + outStart, out.begin() + outStart + lost);
+    }
+
+    if (maxDepth != UINT32_MAX) {
+        auto it = std::remove_if(out.begin() + outStart, out.end(), [&](auto& ev) { return ev.depth > maxDepth; });
+        out.erase(it, out.end());
+    }
+}
+
+uint64_t ProfilerThreadBuffer::id() const {
+    return m_id;
+}
+
+const std::string& ProfilerThreadBuffer::name() const {
+    return m_name;
+}
+
+Profiler::Profiler() : m_epoch(steadyNanos()) {}
+
+void Profiler::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order::relaxed);
+}
+
+uint64_t Profiler::now() const {
+    return steadyNanos() - m_epoch;
+}
+
+ProfilerThreadBuffer& Profiler::threadBuffer() {
+    if (t_buffer) return *t_buffer;
+
+    auto threads = m_threads.lock();
+    uint64_t id = m_nextThreadId++;
+    auto name = utils::thread::getName();
+
+    t_buffer = threads->emplace_back(std::make_shared<ProfilerThreadBuffer>(id, std::move(name))).get();
+    (void) t_exitGuard; // constructs the guard for this thread
+    return *t_buffer;
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end) {
+    if (!enabled()) return;
+
+    auto& buf = this->threadBuffer();
+    buf.push(ProfilerZoneEvent {
+        .name = name,
+        .start = start,
+        .end = end,
+        .depth = buf.m_depth,
+    });
+}
+
+void Profiler::addExportInfo(std::string key, geode::Function<std::string()> provider) {
+    m_exportInfo.lock()->emplace_back(std::move(key), std::move(provider));
+}
+
+std::vector<std::shared_ptr<const ProfilerThreadBuffer>> Profiler::threads() {
+    auto threads = m_threads.lock();
+    return {threads->begin(), threads->end()};
+}
+
+static void appendJsonString(std::string& out, std::string_view str) {
+    out.push_back('"');
+    for (char c : str) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default: {
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    fmt::format_to(std::back_inserter(out), "\\u{:04x}", c);
+                } else {
+                    out.push_back(c);
+                }
+            } break;
+        }
+    }
+    out.push_back('"');
+}
+
+namespace {
+struct ThreadSnapshot {
+    uint64_t id;
+    std::string name;
+    std::vector<ProfilerZoneEvent> events;
+};
+}
+
+using ExportInfo = std::vector<std::pair<std::string, std::string>>;
+
+static std::string formatChromeTrace(const std::vector<ThreadSnapshot>& snapshots, const ExportInfo& info) {
+    std::string out;
+    out.reserve(1024 * 1024);
+    out += "{\"displayTimeUnit\":\"ms\",\"otherData\":{";
+
+    for (size_t i = 0; i < info.size(); i++) {
+        if (i != 0) out.push_back(',');
+        appendJsonString(out, info[i].first);
+        out.push_back(':');
+        appendJsonString(out, info[i].second);
+    }
+
+    out += "},\"traceEvents\":[";
+
+    bool first = true;
+    auto sep = [&] {
+        if (!first) out.push_back(',');
+        first = false;
+    };
+
+    for (auto& snap : snapshots) {
+        sep();
+        fmt::format_to(std::back_inserter(out), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", snap.id);
+        appendJsonString(out, snap.name.empty() ? fmt::format("Thread {}", snap.id) : snap.name);
+        out += "}}";
+
+        for (auto& ev : snap.events) {
+            sep();
+            out += "{\"name\":";
+            appendJsonString(out, ev.name);
+            fmt::format_to(
+                std::back_inserter(out),
+                ",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                snap.id,
+                static_cast<double>(ev.start) / 1000.0,
+                static_cast<double>(ev.end - ev.start) / 1000.0
+            );
+        }
+    }
+
+    out += "]}";
+    return out;
+}
+
+static arc::Future<> writeChromeTrace(std::vector<ThreadSnapshot> snapshots, ExportInfo info, std::filesystem::path path) {
+    co_await arc::spawnBlocking<void>([&] {
+        auto out = formatChromeTrace(snapshots, info);
+
+        if (auto err = utils::file::createDirectoryAll(path.parent_path()).err()) {
+            log::error("Profiler: failed to create trace directory: {}", *err);
+            return;
+        }
+
+        if (auto err = utils::file::writeString(path, out).err()) {
+            log::error("Profiler: failed to write trace: {}", *err);
+            return;
+        }
+
+        log::info("Profiler: exported trace to {}", path);
+    });
+}
+
+std::filesystem::path Profiler::exportChromeTrace() {
+    // taking the snapshot is cheap, formatting and writing is done on a separate thread
+    std::vector<ThreadSnapshot> snapshots;
+    for (auto thread : this->threads()) {
+        auto& snap = snapshots.emplace_back(ThreadSnapshot { thread->id(), thread->name(), {} });
+        thread->snapshot(snap.events);
+    }
+
+    ExportInfo info;
+    for (auto& [key, provider] : *m_exportInfo.lock()) {
+        info.emplace_back(key, provider());
+    }
+
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    auto path = Mod::get()->getSaveDir() / "traces" / fmt::format("trace-{}.json", secs);
+
+    async::spawn(writeChromeTrace(std::move(snapshots), std::move(info), path));
+
+    return path;
+}
+
+}
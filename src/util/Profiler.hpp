@@ -0,0 +1,179 @@
+#pragma once
+
+#include <globed/util/singleton.hpp>
+#include "AllocAudit.hpp"
+#include <asp/sync/Mutex.hpp>
+#include <Geode/utils/function.hpp>
+#include <filesystem>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace globed {
+
+/// A single finished zone. Timestamps are in nanoseconds since the profiler was created.
+struct ProfilerZoneEvent {
+    // must have static lifetime (string literal or __func__)
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    uint32_t depth;
+};
+
+/// Ring buffer of finished zones of a single thread.
+/// Only the owning thread ever writes to it, and any thread can take a snapshot without locking.
+class ProfilerThreadBuffer {
+public:
+    static constexpr size_t CAPACITY = 16384;
+
+    ProfilerThreadBuffer(uint64_t id, std::string name);
+
+    void push(const ProfilerZoneEvent& event);
+
+    /// Appends all zones that ended after `since` to `out`, oldest first.
+    /// Only zones that are at most `maxDepth` levels deep are copied.
+    /// Zones that get overwritten by the owning thread during the copy are skipped.
+    void snapshot(std::vector<ProfilerZoneEvent>& out, uint64_t since = 0, uint32_t maxDepth = UINT32_MAX) const;
+
+    uint64_t id() const;
+    const std::string& name() const;
+
+private:
+    friend class ProfilerZone;
+
+    uint64_t m_id;
+    std::string m_name;
+    std::array<ProfilerZoneEvent, CAPACITY> m_events;
+    std::atomic<uint64_t> m_written{0};
+    uint32_t m_depth = 0; // only touched by the owning thread
+};
+
+/// Lightweight zone profiler. Zones are recorded with the `GLOBED_PROFILE_ZONE` macro into per-thread ring buffers,
+/// and can be consumed by the in-game overlay or exported as a Chrome trace (viewable in Perfetto or chrome://tracing).
+/// When disabled (the default), opening a zone only costs a single atomic load.
+class Profiler : public SingletonLeakBase<Profiler> {
+    friend class SingletonLeakBase;
+    Profiler();
+
+public:
+    static bool enabled() {
+        return s_enabled.load(std::memory_order::relaxed);
+    }
+
+    void setEnabled(bool enabled);
+
+    /// Current time in nanoseconds since the profiler was created
+    uint64_t now() const;
+
+    /// Buffer of the calling thread, created on first use
+    ProfilerThreadBuffer& threadBuffer();
+
+    /// Records a zone with explicit timestamps on the calling thread, at the current depth.
+    /// Useful for time spans that can't be wrapped in a scope, e.g. time spent in the game between two of our hooks.
+    void record(const char* name, uint64_t start, uint64_t end);
+
+    /// All live threads that have recorded zones. The buffer of a thread is dropped from this list when the thread exits,
+    /// and freed once the last returned pointer to it is gone.
+    std::vector<std::shared_ptr<const ProfilerThreadBuffer>> threads();
+
+    /// Adds a provider of extra text that gets included in exported traces, under the "otherData" key.
+    /// Providers are called on the thread that exports the trace.
+    void addExportInfo(std::string key, geode::Function<std::string()> provider);
+
+    /// Takes a snapshot of all threads and writes it as a Chrome trace-event JSON file in a background thread.
+    /// Returns the path the file will be written to.
+    std::filesystem::path exportChromeTrace();
+
+private:
+    friend struct ProfilerThreadExitGuard;
+
+    static inline std::atomic<bool> s_enabled{false};
+
+    uint64_t m_epoch;
+    asp::Mutex<std::vector<std::shared_ptr<ProfilerThreadBuffer>>> m_threads;
+    uint64_t m_nextThreadId = 1; // guarded by m_threads
+    asp::Mutex<std::vector<std::pair<std::string, geode::Function<std::string()>>>> m_exportInfo;
+};
+
+/// RAII zone, records the time between construction and destruction (or `end()`).
+/// In alloc audit builds, zones also mark which scope heap allocations are attributed to, even if the profiler is disabled.
+class ProfilerZone {
+public:
+    explicit ProfilerZone(const char* name) {
+        this->enterAuditScope(name);
+        if (Profiler::enabled()) this->begin(name);
+    }
+
+    ~ProfilerZone() {
+        this->end();
+    }
+
+    ProfilerZone(const ProfilerZone&) = delete;
+    ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+    /// Ends the current zone and immediately starts a new one at the same depth
+    void next(const char* name) {
+        this->end();
+        this->enterAuditScope(name);
+        if (Profiler::enabled()) this->begin(name);
+    }
+
+    void end() {
+        this->exitAuditScope();
+        if (!m_buffer) return;
+
+        m_buffer->m_depth--;
+        m_buffer->push(ProfilerZoneEvent {
+            .name = m_name,
+            .start = m_start,
+            .end = Profiler::get().now(),
+            .depth = m_buffer->m_depth,
+        });
+        m_buffer = nullptr;
+    }
+
+private:
+    ProfilerThreadBuffer* m_buffer = nullptr;
+    const char* m_name = nullptr;
+    uint64_t m_start = 0;
+#ifdef GLOBED_ALLOC_AUDIT
+    const char* m_prevAuditScope = nullptr;
+    bool m_inAuditScope = false;
+#endif
+
+    void enterAuditScope(const char* name) {
+#ifdef GLOBED_ALLOC_AUDIT
+        m_prevAuditScope = AllocAudit::enterScope(name);
+        m_inAuditScope = true;
+#endif
+    }
+
+    void exitAuditScope() {
+#ifdef GLOBED_ALLOC_AUDIT
+        if (m_inAuditScope) {
+            AllocAudit::exitScope(m_prevAuditScope);
+            m_inAuditScope = false;
+        }
+#endif
+    }
+
+    void begin(const char* name) {
+        auto& prof = Profiler::get();
+        m_buffer = &prof.threadBuffer();
+        m_name = name;
+        m_start = prof.now();
+        m_buffer->m_depth++;
+    }
+};
+
+}
+
+#define GLOBED_PROFILE_CONCAT_(a, b) a##b
+#define GLOBED_PROFILE_CONCAT(a, b) GLOBED_PROFILE_CONCAT_(a, b)
+
+/// Profiles the rest of the current scope under the given name, which must be a string literal
+#define GLOBED_PROFILE_ZONE(name) ::globed::ProfilerZone GLOBED_PROFILE_CONCAT(_globedProfZone, __LINE__){name}
+/// Profiles the rest of the current function
+#define GLOBED_PROFILE_FUNCTION() GLOBED_PROFILE_ZONE(__func__)